@@ -13,100 +13,67 @@
 
 #include <dispatcher.hpp>
 
+#include <dynd/callable.hpp>
+#include <dynd/callables/default_instantiable_callable.hpp>
 #include <dynd/dispatcher.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
 #include <dynd/type.hpp>
 #include <dynd/type_registry.hpp>
 
 using namespace std;
 using namespace dynd;
 
-template <size_t N>
-class DispatchFixture : public ::benchmark::Fixture {
-public:
-  vector<type_id_t[N]> ids;
+namespace {
 
-  void SetUp(const benchmark::State &state) {
-    ids.resize(state.range_x());
+struct dummy_kernel : nd::base_strided_kernel<dummy_kernel, 1> {
+  void single(char *DYND_UNUSED(dst), char *const *DYND_UNUSED(src)) {}
+};
 
-    default_random_engine generator;
-    uniform_int_distribution<underlying_type_t<type_id_t>> d(bool_id, callable_id);
+nd::callable make_child(const char *tp) {
+  return nd::make_callable<nd::default_instantiable_callable<dummy_kernel>>(ndt::type(tp));
+}
 
-    for (auto &id : ids) {
-      for (size_t i = 0; i < N; ++i) {
-        id[i] = static_cast<type_id_t>(d(generator));
-      }
-    }
-  }
-};
+std::vector<ndt::type> dispatch_args(const ndt::type &DYND_UNUSED(dst_tp), size_t nsrc, const ndt::type *src_tp) {
+  return std::vector<ndt::type>(src_tp, src_tp + nsrc);
+}
 
-template <>
-class DispatchFixture<1> : public ::benchmark::Fixture {
+} // unnamed namespace
+
+template <size_t N>
+class DispatchFixture : public ::benchmark::Fixture {
 public:
-  vector<pair<type_id_t, type_id_t>> pairs;
+  vector<array<ndt::type, N>> tps;
 
   void SetUp(const benchmark::State &state) {
-    pairs.resize(state.range_x());
+    const ndt::type builtin_tps[] = {
+        ndt::make_type<bool1>(),   ndt::make_type<int8_t>(),   ndt::make_type<int16_t>(),  ndt::make_type<int32_t>(),
+        ndt::make_type<int64_t>(), ndt::make_type<uint8_t>(),  ndt::make_type<uint16_t>(), ndt::make_type<uint32_t>(),
+        ndt::make_type<uint64_t>(), ndt::make_type<float>(),   ndt::make_type<double>()};
+    tps.resize(state.range_x());
 
     default_random_engine generator;
-    uniform_int_distribution<underlying_type_t<type_id_t>> d(bool_id, callable_id);
+    uniform_int_distribution<size_t> d(0, sizeof(builtin_tps) / sizeof(builtin_tps[0]) - 1);
 
-    for (auto &pair : pairs) {
-      pair.first = static_cast<type_id_t>(d(generator));
-      pair.second = static_cast<type_id_t>(d(generator));
+    for (auto &tp : tps) {
+      for (size_t i = 0; i < N; ++i) {
+        tp[i] = builtin_tps[d(generator)];
+      }
     }
   }
 };
 
-typedef DispatchFixture<1> X;
-
-/*
-BENCHMARK_DEFINE_F(X, BM_IsBaseIDOf)(benchmark::State &state)
-{
-  while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-    }
-  }
-  state.SetItemsProcessed(10 * state.iterations() * state.range_x());
-}
-
-BENCHMARK_REGISTER_F(X, BM_IsBaseIDOf)->Arg(100)->Arg(1000)->Arg(10000);
-*/
-
 typedef DispatchFixture<1> UnaryDispatchFixture;
 typedef DispatchFixture<2> BinaryDispatchFixture;
 
-/*
-BENCHMARK_DEFINE_F(BinaryDispatchFixture, BM_Supercedes)(benchmark::State &state)
-{
-  while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(supercedes(pair.first, pair.second));
-    }
-  }
-  state.SetItemsProcessed(state.iterations() * state.range_x());
-}
-*/
-
-// BENCHMARK_REGISTER_F(BinaryDispatchFixture, BM_Supercedes)->Arg(10)->Arg(100)->Arg(1000);
-
 BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_UnaryDispatch)(benchmark::State &state) {
-  dispatcher<1, int> dispatcher{{{any_kind_id}, 0}, {{scalar_kind_id}, 1}, {{bool_id}, 2},    {{int8_id}, 3},
-                                {{int16_id}, 4},    {{int32_id}, 5},       {{int64_id}, 6},   {{int128_id}, 7},
-                                {{uint8_id}, 8},    {{uint16_id}, 9},      {{uint32_id}, 10}, {{uint64_id}, 11},
-                                {{uint128_id}, 12}, {{float32_id}, 13},    {{float64_id}, 14}};
+  dispatcher<1, nd::callable> dispatcher(
+      dispatch_args, {make_child("(Any) -> int32"), make_child("(Scalar) -> int32"), make_child("(bool) -> int32"),
+                      make_child("(int8) -> int32"), make_child("(int16) -> int32"), make_child("(int32) -> int32"),
+                      make_child("(int64) -> int32"), make_child("(float32) -> int32"),
+                      make_child("(float64) -> int32")});
   while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(dispatcher(pair.first));
+    for (const auto &tp : tps) {
+      benchmark::DoNotOptimize(dispatcher(ndt::type(), 1, tp.data()));
     }
   }
   state.SetItemsProcessed(state.iterations() * state.range_x());
@@ -114,29 +81,25 @@ BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_UnaryDispatch)(benchmark::State &sta
 
 BENCHMARK_REGISTER_F(UnaryDispatchFixture, BM_UnaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
 
-/*
-static void BM_VirtualDispatch(benchmark::State &state)
-{
+static void BM_VirtualDispatch(benchmark::State &state) {
   while (state.KeepRunning()) {
     benchmark::DoNotOptimize((*item)());
   }
 }
 
 BENCHMARK(BM_VirtualDispatch);
-*/
-
-BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_BinaryDispatch)(benchmark::State &state) {
-  dispatcher<2, int> dispatcher{{{any_kind_id, int64_id}, 0},
-                                {{scalar_kind_id, int64_id}, 1},
-                                {{int32_id, int64_id}, 2},
-                                {{float32_id, int64_id}, 3},
-                                {{any_kind_id, any_kind_id}, 4}};
+
+BENCHMARK_DEFINE_F(BinaryDispatchFixture, BM_BinaryDispatch)(benchmark::State &state) {
+  dispatcher<2, nd::callable> dispatcher(
+      dispatch_args, {make_child("(Any, int64) -> int32"), make_child("(Scalar, int64) -> int32"),
+                      make_child("(int32, int64) -> int32"), make_child("(float32, int64) -> int32"),
+                      make_child("(Any, Any) -> int32")});
   while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(dispatcher(pair.first, pair.second));
+    for (const auto &tp : tps) {
+      benchmark::DoNotOptimize(dispatcher(ndt::type(), 2, tp.data()));
     }
   }
   state.SetItemsProcessed(state.iterations() * state.range_x());
 }
 
-BENCHMARK_REGISTER_F(UnaryDispatchFixture, BM_BinaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(BinaryDispatchFixture, BM_BinaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
@@ -10,8 +10,8 @@
 
 #include <benchmark/benchmark.h>
 
-#include <dynd/func/arithmetic.hpp>
-#include <dynd/func/random.hpp>
+#include <dynd/arithmetic.hpp>
+#include <dynd/random.hpp>
 
 using namespace std;
 using namespace dynd;
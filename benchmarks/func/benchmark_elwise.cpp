@@ -0,0 +1,141 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/expression.hpp>
+#include <dynd/functional.hpp>
+#include <dynd/random.hpp>
+#include <dynd/simd.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const int size = 1 << 24;
+
+static void BM_Func_Elwise_Add_Threads(benchmark::State &state) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_x();
+
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::add(a, b));
+  }
+  state.SetBytesProcessed(3 * state.iterations() * size * sizeof(double));
+
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Elwise_Add_Threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+
+static void BM_Func_Elwise_Multiply_2D_Threads(benchmark::State &state) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_x();
+  eval::default_eval_context.min_grain_size = 16;
+
+  ndt::type tp = ndt::make_fixed_dim(size / 4096, ndt::make_fixed_dim(4096, ndt::make_type<float>()));
+  nd::array a = nd::random::uniform({}, {{"dst_tp", tp}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", tp}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::multiply(a, b));
+  }
+  state.SetBytesProcessed(3 * state.iterations() * size * sizeof(float));
+
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Elwise_Multiply_2D_Threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+
+static void BM_Func_Elwise_Add_InstructionSet(benchmark::State &state) {
+  simd::instruction_set saved_isa = simd::get_instruction_set();
+  simd::set_instruction_set(static_cast<simd::instruction_set>(state.range_x()));
+
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<float>())}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<float>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::add(a, b));
+  }
+  state.SetBytesProcessed(3 * state.iterations() * size * sizeof(float));
+
+  simd::set_instruction_set(saved_isa);
+}
+
+BENCHMARK(BM_Func_Elwise_Add_InstructionSet)
+    ->Arg(simd::isa_none)
+    ->Arg(simd::isa_sse2)
+    ->Arg(simd::isa_avx2)
+    ->Arg(simd::isa_avx512);
+
+static void BM_Func_Elwise_MultiplyAdd(benchmark::State &state) {
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array c = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::add(nd::multiply(a, b), c));
+  }
+  state.SetBytesProcessed(4 * state.iterations() * size * sizeof(double));
+}
+
+BENCHMARK(BM_Func_Elwise_MultiplyAdd);
+
+static void BM_Func_Elwise_MultiplyAdd_Fused(benchmark::State &state) {
+  nd::callable f = nd::functional::fuse(3, {{nd::multiply, {0, 1}}, {nd::add, {3, 2}}});
+
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array c = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(f(a, b, c));
+  }
+  state.SetBytesProcessed(4 * state.iterations() * size * sizeof(double));
+}
+
+BENCHMARK(BM_Func_Elwise_MultiplyAdd_Fused);
+
+static void BM_Func_Elwise_MultiplyAdd_Lazy(benchmark::State &state) {
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array c = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  nd::array dst = nd::empty(ndt::make_fixed_dim(size, ndt::make_type<double>()));
+  while (state.KeepRunning()) {
+    (nd::lazy(a) * b + c).eval(dst);
+  }
+  state.SetBytesProcessed(4 * state.iterations() * size * sizeof(double));
+}
+
+BENCHMARK(BM_Func_Elwise_MultiplyAdd_Lazy);
+
+static void BM_Func_Elwise_Add_3D(benchmark::State &state) {
+  // A small innermost dimension, contiguous or transposed
+  ndt::type tp = ndt::make_fixed_dim(1024, ndt::make_fixed_dim(1024, ndt::make_fixed_dim(4, ndt::make_type<float>())));
+  nd::array a = nd::random::uniform({}, {{"dst_tp", tp}});
+  nd::array b = nd::random::uniform({}, {{"dst_tp", tp}});
+  if (state.range_x()) {
+    a = a.transpose();
+    b = b.transpose();
+  }
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::add(a, b));
+  }
+  state.SetBytesProcessed(3 * state.iterations() * 1024 * 1024 * 4 * sizeof(float));
+}
+
+BENCHMARK(BM_Func_Elwise_Add_3D)->Arg(0)->Arg(1);
+
+static void BM_Func_Elwise_Assign_Transposed(benchmark::State &state) {
+  // Copying a transposed square matrix into a contiguous one
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>()));
+  nd::array src = nd::random::uniform({}, {{"dst_tp", tp}}).transpose();
+  nd::array dst = nd::empty(tp);
+  while (state.KeepRunning()) {
+    dst.assign(src);
+  }
+  state.SetBytesProcessed(2 * state.iterations() * state.range_x() * state.range_x() * sizeof(double));
+}
+
+BENCHMARK(BM_Func_Elwise_Assign_Transposed)->Arg(256)->Arg(1024)->Arg(4096);
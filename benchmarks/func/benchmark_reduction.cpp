@@ -0,0 +1,46 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/random.hpp>
+#include <dynd/statistics.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const int size = 1 << 24;
+
+static void BM_Func_Reduction_Sum_Threads(benchmark::State &state) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_x();
+
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<double>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::sum(a));
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(double));
+
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Reduction_Sum_Threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+
+static void BM_Func_Reduction_Max_Threads(benchmark::State &state) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = state.range_x();
+
+  nd::array a = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(size, ndt::make_type<float>())}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::max(a));
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(float));
+
+  eval::default_eval_context = saved_ectx;
+}
+
+BENCHMARK(BM_Func_Reduction_Max_Threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
@@ -0,0 +1,36 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/random.hpp>
+#include <dynd/search.hpp>
+#include <dynd/sort.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void BM_Func_SearchSorted(benchmark::State &state) {
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::make_type<double>());
+  nd::array a = nd::random::uniform({}, {{"dst_tp", tp}});
+  nd::sort(a);
+
+  nd::array needles = nd::random::uniform({}, {{"dst_tp", ndt::make_fixed_dim(100000, ndt::make_type<double>())}});
+  if (state.range_y()) {
+    nd::sort(needles);
+  }
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::searchsorted(a, needles));
+  }
+  state.SetItemsProcessed(state.iterations() * 100000);
+}
+
+BENCHMARK(BM_Func_SearchSorted)->ArgPair(1000, 0)->ArgPair(10000000, 0)->ArgPair(1000, 1)->ArgPair(10000000, 1);
@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/random.hpp>
+#include <dynd/sort.hpp>
+
+using namespace std;
+using namespace dynd;
+
+template <typename T>
+static void BM_Func_Sort(benchmark::State &state) {
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::make_type<T>());
+  nd::array src = nd::random::uniform({}, {{"dst_tp", tp}});
+  nd::array a = nd::empty(tp);
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    a.assign(src);
+    state.ResumeTiming();
+    nd::sort(a);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Sort, int32_t)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_Func_Sort, int64_t)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_Func_Sort, double)->Arg(1000)->Arg(1000000);
+
+template <typename T>
+static void BM_Func_Argsort(benchmark::State &state) {
+  ndt::type tp = ndt::make_fixed_dim(state.range_x(), ndt::make_type<T>());
+  nd::array a = nd::random::uniform({}, {{"dst_tp", tp}});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::argsort(a));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Argsort, int64_t)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_Func_Argsort, double)->Arg(1000)->Arg(1000000);
+
+template <typename T>
+static void BM_Func_Unique(benchmark::State &state) {
+  // The values repeat, with about a thousand distinct ones
+  nd::array a = nd::empty(state.range_x(), ndt::make_type<T>());
+  for (int i = 0; i < state.range_x(); ++i) {
+    a(i).vals() = (i * 7919) % 1009;
+  }
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::unique(a));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+BENCHMARK_TEMPLATE(BM_Func_Unique, int64_t)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_Func_Unique, double)->Arg(1000)->Arg(1000000);
@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <dynd/array.hpp>
+#include <dynd/simd.hpp>
+#include <dynd/string.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static const int size = 1 << 20;
+
+// Lines of random lowercase letters, like the messages of a log, of which every
+// sixteenth contains the needle
+static nd::array make_lines(intptr_t line_size, const std::string &needle) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> ch('a', 'z');
+
+  nd::array a = nd::empty(size, ndt::make_type<dynd::string>());
+  dynd::string *lines = reinterpret_cast<dynd::string *>(a.data());
+  for (int i = 0; i < size; ++i) {
+    std::string line(line_size, 'a');
+    for (char &c : line) {
+      c = static_cast<char>(ch(gen));
+    }
+    if (i % 16 == 0) {
+      line.replace(line_size / 2, needle.size(), needle);
+    }
+    lines[i] = line;
+  }
+
+  return a;
+}
+
+static void BM_Func_String_Find(benchmark::State &state) {
+  simd::instruction_set saved_isa = simd::get_instruction_set();
+  simd::set_instruction_set(static_cast<simd::instruction_set>(state.range_x()));
+
+  nd::array a = make_lines(state.range_y(), "error");
+  nd::array b = "error";
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::string_find(a, b));
+  }
+  state.SetBytesProcessed(state.iterations() * size * state.range_y());
+
+  simd::set_instruction_set(saved_isa);
+}
+
+BENCHMARK(BM_Func_String_Find)
+    ->ArgPair(simd::isa_none, 64)
+    ->ArgPair(simd::isa_sse2, 64)
+    ->ArgPair(simd::isa_avx2, 64)
+    ->ArgPair(simd::isa_none, 512)
+    ->ArgPair(simd::isa_sse2, 512)
+    ->ArgPair(simd::isa_avx2, 512);
+
+static void BM_Func_String_Count(benchmark::State &state) {
+  simd::instruction_set saved_isa = simd::get_instruction_set();
+  simd::set_instruction_set(static_cast<simd::instruction_set>(state.range_x()));
+
+  nd::array a = make_lines(256, "error");
+  nd::array b = "error";
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(nd::string_count(a, b));
+  }
+  state.SetBytesProcessed(state.iterations() * size * 256);
+
+  simd::set_instruction_set(saved_isa);
+}
+
+BENCHMARK(BM_Func_String_Count)->Arg(simd::isa_none)->Arg(simd::isa_sse2)->Arg(simd::isa_avx2);
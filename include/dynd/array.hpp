@@ -740,17 +740,53 @@ namespace nd {
   }
 
   /**
-   * Memory-maps a file with dynd type 'bytes'.
+   * How the kernel is told the pages of a memory map will be accessed.
+   */
+  enum memmap_advice {
+    // The default read-ahead
+    memmap_advice_normal,
+    // In order, so more is read ahead and pages behind may be dropped
+    memmap_advice_sequential,
+    // In no order, so nothing is read ahead
+    memmap_advice_random,
+    // Soon, so the whole map starts being read in the background
+    memmap_advice_willneed
+  };
+
+  /**
+   * How ``nd::memmap`` maps a file. Where the platform does not support an
+   * option, it is ignored.
+   */
+  struct memmap_options {
+    memmap_advice advice;
+    // Whether to fault in every page of the map before returning (MAP_POPULATE)
+    bool populate;
+    // Whether to back the map with transparent huge pages where the kernel can
+    bool huge_pages;
+    // Whether the map is a private copy on write, which can be written
+    // without changing the file. Otherwise it is read-only
+    bool copy_on_write;
+
+    memmap_options() : advice(memmap_advice_normal), populate(false), huge_pages(false), copy_on_write(false) {}
+  };
+
+  /**
+   * Memory-maps a file as an array of type ``fixed_bytes[N]``, whose data is
+   * the mapped memory. The map stays open as long as the array, or anything
+   * viewing it, is alive. An empty range raises an error.
    *
    * \param filename  The name of the file to memory map.
    * \param begin  If provided, the start of where to memory map. Uses
    *               Python semantics for out of bounds and negative values.
    * \param end  If provided, the end of where to memory map. Uses
    *             Python semantics for out of bounds and negative values.
-   * \param access  The access permissions with which to open the file.
+   * \param access  The access permissions with which to open the file. The
+   *                array is only writable with ``options.copy_on_write``.
+   * \param options  Hints about how the map will be accessed.
    */
   DYND_API array memmap(const std::string &filename, intptr_t begin = 0,
-                        intptr_t end = std::numeric_limits<intptr_t>::max(), uint32_t access = default_access_flags);
+                        intptr_t end = std::numeric_limits<intptr_t>::max(), uint32_t access = default_access_flags,
+                        const memmap_options &options = memmap_options());
 
   /**
    * Creates a ctuple nd::array with the given field names and
@@ -5,15 +5,13 @@
 
 #pragma once
 
-#include <dynd/callables/apply_function_callable.hpp>
-#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/callables/arithmetic_callable.hpp>
 
 namespace dynd {
 namespace nd {
 
   template <typename Arg0Type, typename Arg1Type>
-  using add_callable = functional::apply_function_callable<decltype(&dynd::detail::inline_add<Arg0Type, Arg1Type>::f),
-                                                           &dynd::detail::inline_add<Arg0Type, Arg1Type>::f>;
+  using add_callable = arithmetic_callable<dynd::detail::inline_add, simd::op_add, Arg0Type, Arg1Type>;
 
 } // namespace dynd::nd
 } // namespace dynd
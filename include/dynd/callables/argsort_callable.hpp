@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/comparison.hpp>
+#include <dynd/kernels/sort_kernel.hpp>
+#include <dynd/types/option_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  class argsort_callable : public base_callable {
+    /**
+     * Resolves to a radix sort of the values of type ``T``.
+     */
+    template <typename T>
+    static void resolve_radix(call_graph &cg) {
+      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                         const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<radix_argsort_kernel<T>>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta)->stride);
+      });
+    }
+
+  public:
+    argsort_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<intptr_t>()), {ndt::type("Fixed * Scalar")},
+              {{ndt::make_type<ndt::option_type>(ndt::make_type<bool1>()), "stable"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+      ndt::type ret_tp = ndt::make_fixed_dim(src_tp[0].get_dim_size(NULL, NULL), ndt::make_type<intptr_t>());
+
+      // The radix sort is stable, so it serves both modes
+      const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      switch (src0_element_tp.get_id()) {
+      case int8_id:
+        resolve_radix<int8_t>(cg);
+        return ret_tp;
+      case int16_id:
+        resolve_radix<int16_t>(cg);
+        return ret_tp;
+      case int32_id:
+        resolve_radix<int32_t>(cg);
+        return ret_tp;
+      case int64_id:
+        resolve_radix<int64_t>(cg);
+        return ret_tp;
+      case uint8_id:
+        resolve_radix<uint8_t>(cg);
+        return ret_tp;
+      case uint16_id:
+        resolve_radix<uint16_t>(cg);
+        return ret_tp;
+      case uint32_id:
+        resolve_radix<uint32_t>(cg);
+        return ret_tp;
+      case uint64_id:
+        resolve_radix<uint64_t>(cg);
+        return ret_tp;
+      case float32_id:
+        resolve_radix<float>(cg);
+        return ret_tp;
+      case float64_id:
+        resolve_radix<double>(cg);
+        return ret_tp;
+      default:
+        break;
+      }
+
+      bool stable = kwds[0].is_na() ? false : kwds[0].as<bool>();
+      cg.emplace_back([stable](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                               const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        intptr_t src0_size = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size;
+        const eval::eval_context *ectx = &eval::default_eval_context;
+        intptr_t self_offset = kb.size();
+        kb.emplace_back<argsort_kernel>(kernreq, src0_size,
+                                        reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
+                                        reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta)->stride, stable,
+                                        stable ? detail::sort_nchunks(src0_size, ectx) : 1);
+
+        // Every chunk of the sort compares with its own less child
+        call_node *child_call = kb.get_call();
+        kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        kb.get_at<argsort_kernel>(self_offset)->children.instantiate(child_call);
+      });
+
+      const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+      less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+
+      return ret_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,27 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/default_instantiable_callable.hpp>
+#include <dynd/kernels/arithmetic_kernel.hpp>
+#include <dynd/types/callable_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  template <template <typename, typename> class FuncType, simd::binary_op Op, typename Arg0Type, typename Arg1Type>
+  class arithmetic_callable
+      : public default_instantiable_callable<arithmetic_kernel<FuncType, Op, Arg0Type, Arg1Type>> {
+  public:
+    arithmetic_callable()
+        : default_instantiable_callable<arithmetic_kernel<FuncType, Op, Arg0Type, Arg1Type>>(
+              ndt::make_type<ndt::callable_type>(
+                  ndt::make_type<typename arithmetic_kernel<FuncType, Op, Arg0Type, Arg1Type>::dst_type>(),
+                  {ndt::make_type<Arg0Type>(), ndt::make_type<Arg1Type>()})) {}
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
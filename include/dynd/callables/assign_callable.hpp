@@ -261,7 +261,8 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<ndt::fixed_string_type, string, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src0_encoding, error_mode),
+            kernreq, get_transcode_unicode_function(src0_encoding, dst_encoding),
+            get_next_unicode_codepoint_function(src0_encoding, error_mode),
             get_append_unicode_codepoint_function(dst_encoding, error_mode), dst_data_size,
             error_mode != assign_error_nocheck);
       });
@@ -290,7 +291,10 @@ namespace nd {
         const ndt::fixed_string_type *src_fs = src_tp[0].extended<ndt::fixed_string_type>();
         kb.emplace_back<
             detail::assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src_fs->get_encoding(), error_mode),
+            kernreq,
+            get_transcode_unicode_function(src_fs->get_encoding(),
+                                           dst_tp.extended<ndt::fixed_string_type>()->get_encoding()),
+            get_next_unicode_codepoint_function(src_fs->get_encoding(), error_mode),
             get_append_unicode_codepoint_function(dst_tp.extended<ndt::fixed_string_type>()->get_encoding(),
                                                   error_mode),
             dst_tp.get_data_size(), src_fs->get_data_size(), error_mode != assign_error_nocheck);
@@ -473,7 +477,8 @@ namespace nd {
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
           size_t DYND_UNUSED(nsrc), const char *const *DYND_UNUSED(src_arrmeta)) {
         kb.emplace_back<detail::assignment_kernel<ndt::fixed_string_type, string, assign_error_nocheck>>(
-            kernreq, get_next_unicode_codepoint_function(src0_encoding, error_mode),
+            kernreq, get_transcode_unicode_function(src0_encoding, dst_encoding),
+            get_next_unicode_codepoint_function(src0_encoding, error_mode),
             get_append_unicode_codepoint_function(dst_encoding, error_mode), dst_data_size,
             error_mode != assign_error_nocheck);
       });
@@ -24,7 +24,10 @@ namespace nd {
     none = 0x00000000,
     left_associative = 0x00000001,
     right_associative = 0x00000002,
-    commutative = 0x00000004
+    commutative = 0x00000004,
+    // For a reduction, partial results may be combined in any grouping, using
+    // the reduction itself, so its return and argument types must be the same
+    associative = 0x00000008
   };
 
   inline callable_property operator|(callable_property a, callable_property b) {
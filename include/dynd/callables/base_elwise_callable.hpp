@@ -24,20 +24,27 @@ namespace nd {
         bool state;
         size_t ndim;
         bool first;
+        void *level;
       };
 
       struct data_type {
         std::array<bool, N> arg_broadcast;
+        // Whether a broadcast argument has this dimension, with a size of one
+        std::array<bool, N> arg_unit_dim;
         std::array<bool, N> arg_var;
         intptr_t res_alignment;
         size_t ndim;
         bool res_ignore;
+        bool parallel;
+        // The enclosing dimension, and this one, when they can be looped over together
+        void *outer_level;
+        void *level;
       };
 
     public:
       base_elwise_callable() : base_callable(ndt::type()) {}
 
-      virtual void subresolve(call_graph &cg, const char *data) = 0;
+      virtual void subresolve(call_graph &cg, char *data) = 0;
 
       virtual ndt::type with_return_type(intptr_t ret_size, const ndt::type &ret_element_tp) = 0;
 
@@ -58,6 +65,7 @@ namespace nd {
         intptr_t max_ndim = reinterpret_cast<codata_type *>(codata)->ndim;
         for (size_t i = 0; i < N; ++i) {
           data.arg_broadcast[i] = (arg_tp[i].get_ndim() - child_arg_tp[i].get_ndim()) < max_ndim;
+          data.arg_unit_dim[i] = false;
           if (data.arg_broadcast[i]) {
             arg_size[i] = 1;
             arg_element_tp[i] = arg_tp[i];
@@ -65,6 +73,7 @@ namespace nd {
             arg_size[i] = arg_tp[i].extended<ndt::base_dim_type>()->get_dim_size();
             if (arg_size[i] == 1) {
               data.arg_broadcast[i] = true;
+              data.arg_unit_dim[i] = true;
             }
             arg_element_tp[i] = arg_tp[i].extended<ndt::base_dim_type>()->get_element_type();
           }
@@ -74,6 +83,15 @@ namespace nd {
           data.arg_var[i] = arg_tp[i].get_id() == var_dim_id;
         }
 
+        // Splitting a dimension across threads is only safe when the child kernels
+        // never allocate into memory shared by the whole array, which holds when
+        // no operand references or owns other memory
+        const uint32_t shared_flags = type_flag_blockref | type_flag_destructor;
+        data.parallel = N > 0 && (res_tp.is_symbolic() || (res_tp.get_flags() & shared_flags) == 0);
+        for (size_t i = 0; i < N; ++i) {
+          data.parallel &= (arg_tp[i].get_flags() & shared_flags) == 0;
+        }
+
         intptr_t res_size;
         ndt::type res_element_tp;
         if (res_ignore) {
@@ -103,7 +121,10 @@ namespace nd {
           }
         }
 
+        data.outer_level = reinterpret_cast<codata_type *>(codata)->level;
+        data.level = nullptr;
         subresolve(cg, reinterpret_cast<char *>(&data));
+        reinterpret_cast<codata_type *>(codata)->level = data.level;
 
         if (--reinterpret_cast<codata_type *>(codata)->ndim > 0) {
           res_element_tp =
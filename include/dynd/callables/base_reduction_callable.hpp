@@ -8,6 +8,8 @@
 #include <array>
 
 #include <dynd/callables/base_callable.hpp>
+#include <dynd/callables/constant_callable.hpp>
+#include <dynd/eval/eval_context.hpp>
 #include <dynd/kernels/reduction_kernel.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
@@ -26,16 +28,37 @@ namespace nd {
         const int *axes;
         int axis;
         intptr_t ndim;
+        bool associative;
       };
 
       struct node_type {
         bool inner;
         bool broadcast;
         bool keepdim;
+        bool parallel;
+        size_t data_size;
       };
 
       base_reduction_callable() : base_callable(ndt::type()) {}
 
+      /**
+       * Resolves the identity for a result of type ``ret_tp``. An identity which always
+       * returns some other type, like ``[] { return 0; }`` for a sum of doubles, is
+       * evaluated once and converted, so it does not write a value of the wrong size.
+       */
+      static void resolve_identity(base_callable *caller, const callable &identity, call_graph &cg,
+                                   const ndt::type &ret_tp, size_t nsrc, const ndt::type *src_tp, size_t nkwd,
+                                   const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+        const ndt::type &identity_ret_tp = identity->get_ret_type();
+        if (identity->get_narg() == 0 && !identity_ret_tp.is_symbolic() && identity_ret_tp != ret_tp) {
+          make_callable<constant_callable>(identity())->resolve(caller, nullptr, cg, ret_tp, nsrc, src_tp, nkwd, kwds,
+                                                                tp_vars);
+          return;
+        }
+
+        identity->resolve(caller, nullptr, cg, ret_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+      }
+
       virtual void resolve(call_graph &cg, char *data) = 0;
 
       ndt::type resolve(base_callable *caller, char *data, call_graph &cg, const ndt::type &res_tp, size_t nsrc,
@@ -63,6 +86,12 @@ namespace nd {
             arg_element_tp[i] = src_tp[i].extended<ndt::base_dim_type>()->get_element_type();
           }
         }
+        // A single reduced dimension of plain old data may be split across
+        // threads, with the partial results merged by the child
+        node.parallel = reinterpret_cast<data_type *>(data)->associative && reduce && nsrc == 1 &&
+                        reinterpret_cast<data_type *>(data)->ndim == 1 && arg_element_tp[0].get_data_size() > 0 &&
+                        (arg_element_tp[0].get_flags() & (type_flag_blockref | type_flag_destructor)) == 0;
+        node.data_size = node.parallel ? arg_element_tp[0].get_data_size() : 0;
         ++reinterpret_cast<data_type *>(data)->axis;
 
         ndt::type ret_element_tp;
@@ -73,8 +102,8 @@ namespace nd {
           ret_element_tp =
               child->resolve(this, nullptr, cg, child_ret_tp, nsrc, arg_element_tp.data(), nkwd - 2, kwds + 2, tp_vars);
 
-          nd::callable constant = reinterpret_cast<data_type *>(data)->identity;
-          constant->resolve(this, nullptr, cg, ret_element_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+          resolve_identity(this, reinterpret_cast<data_type *>(data)->identity, cg, ret_element_tp, nsrc, src_tp, nkwd,
+                           kwds, tp_vars);
         } else {
           node.inner = false;
           resolve(cg, reinterpret_cast<char *>(&node));
@@ -103,14 +132,48 @@ namespace nd {
         bool inner = reinterpret_cast<node_type *>(data)->inner;
         bool broadcast = reinterpret_cast<node_type *>(data)->broadcast;
         bool keepdim = reinterpret_cast<node_type *>(data)->keepdim;
+        bool parallel = reinterpret_cast<node_type *>(data)->parallel;
+        size_t data_size = reinterpret_cast<node_type *>(data)->data_size;
 
-        cg.emplace_back([inner, broadcast, keepdim](kernel_builder &kb, kernel_request_t kernreq,
-                                                    char *DYND_UNUSED(data), const char *dst_arrmeta, size_t nsrc,
-                                                    const char *const *src_arrmeta) {
+        cg.emplace_back([inner, broadcast, keepdim, parallel, data_size](
+            kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
+            size_t nsrc, const char *const *src_arrmeta) {
           if (inner) {
             if (!broadcast) {
               intptr_t src_size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
 
+              // Only a reduction which is not requested as strided, and so is
+              // the outermost kernel, is split across threads
+              size_t nchunks = 1;
+              if (parallel && kernreq != kernel_request_strided) {
+                const eval::eval_context *ectx = &eval::default_eval_context;
+                nchunks = std::min<size_t>(ectx->nthreads, src_size / std::max<intptr_t>(ectx->min_grain_size, 1));
+              }
+
+              if (nchunks > 1) {
+                const char *src_element_arrmeta = src_arrmeta[0] + sizeof(size_stride_t);
+
+                intptr_t root_ckb_offset = kb.size();
+                kb.emplace_back<parallel_reduction_kernel>(
+                    kernreq, src_size, reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->stride, data_size,
+                    nchunks);
+
+                call_node *child_call = kb.get_call();
+                kb(kernel_request_strided, nullptr, dst_arrmeta + sizeof(size_stride_t), nsrc, &src_element_arrmeta);
+
+                intptr_t init_offset = kb.size();
+                kb(kernel_request_single, nullptr, dst_arrmeta + sizeof(size_stride_t), nsrc, &src_element_arrmeta);
+
+                parallel_reduction_kernel *self = kb.get_at<parallel_reduction_kernel>(root_ckb_offset);
+                self->init_offset = init_offset - root_ckb_offset;
+                for (size_t i = 0; i < nchunks - 1; ++i) {
+                  self->clones[i] = new kernel_builder(child_call);
+                  (*self->clones[i])(kernel_request_strided, nullptr, dst_arrmeta + sizeof(size_stride_t), nsrc,
+                                     &src_element_arrmeta);
+                }
+                return;
+              }
+
               typedef reduction_kernel<ndt::fixed_dim_type, false, true, NArg> self_type;
               intptr_t root_ckb_offset = kb.size();
               kb.emplace_back<self_type>(kernreq);
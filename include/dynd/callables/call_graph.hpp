@@ -13,6 +13,8 @@ namespace nd {
 
   class call_graph : public storagebuf<call_node, call_graph> {
   public:
+    call_graph(storage_arena *arena = NULL) : storagebuf<call_node, call_graph>(arena) {}
+
     void destroy() {}
 
     ~call_graph() {
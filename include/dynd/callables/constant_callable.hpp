@@ -35,8 +35,10 @@ namespace nd {
           kb(kernreq | kernel_request_data_only, nullptr, dst_arrmeta, 1, &child_src_metadata);
         });
 
+        // The value is converted from its own type, which may differ from the destination type
+        ndt::type val_tp = m_val.get_type();
         nd::array error_mode = assign_error_default;
-        assign->resolve(this, nullptr, cg, dst_tp, 1, &dst_tp, 1, &error_mode, tp_vars);
+        assign->resolve(this, nullptr, cg, dst_tp, 1, &val_tp, 1, &error_mode, tp_vars);
 
         return dst_tp;
       }
@@ -5,9 +5,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/callables/base_elwise_callable.hpp>
+#include <dynd/eval/eval_context.hpp>
 #include <dynd/kernels/elwise_kernel.hpp>
+#include <dynd/shape_tools.hpp>
 
 namespace dynd {
 namespace nd {
@@ -41,51 +47,239 @@ namespace nd {
     template <type_id_t DstTypeID, type_id_t SrcTypeID, typename TraitsType, size_t N>
     class elwise_callable;
 
+    /**
+     * The broadcasting of a fixed dimension in an elwise callable, linked to the
+     * fixed dimension directly inside it, if any.
+     */
+    template <size_t N>
+    struct fixed_dim_level {
+      bool res_broadcast;
+      std::array<bool, N> arg_broadcast;
+      std::array<bool, N> arg_unit_dim;
+      std::shared_ptr<fixed_dim_level> inner;
+    };
+
+    /**
+     * The size and strides of one loop over a fixed dimension.
+     */
+    template <size_t N>
+    struct fixed_dim_loop {
+      intptr_t size;
+      intptr_t dst_stride;
+      std::array<intptr_t, N> src_stride;
+    };
+
     template <typename TraitsType, size_t N>
     class elwise_callable<fixed_dim_id, fixed_dim_id, TraitsType, N> : public base_elwise_callable<N> {
       typedef typename base_elwise_callable<N>::data_type data_type;
 
+      /**
+       * Plans the loops for a run of directly nested fixed dimensions. The
+       * dimensions are reordered so that the smallest strides are innermost,
+       * dimensions of size one are dropped, and adjacent dimensions which are
+       * contiguous for every operand are collapsed into one.
+       */
+      static void plan_loops(std::vector<fixed_dim_loop<N>> &loops, bool reorder) {
+        if (loops.size() > 1) {
+          loops.erase(std::remove_if(loops.begin(), loops.end(),
+                                     [](const fixed_dim_loop<N> &loop) { return loop.size == 1; }),
+                      loops.end());
+          if (loops.empty()) {
+            loops.push_back(fixed_dim_loop<N>{1, 0, std::array<intptr_t, N>()});
+          }
+        }
+
+        intptr_t ndim = loops.size();
+        if (ndim > 1 && reorder) {
+          std::vector<intptr_t> strides((N + 1) * ndim);
+          std::array<const intptr_t *, N + 1> operstrides;
+          for (size_t j = 0; j <= N; ++j) {
+            for (intptr_t i = 0; i < ndim; ++i) {
+              strides[j * ndim + i] = (j == 0) ? loops[i].dst_stride : loops[i].src_stride[j - 1];
+            }
+            operstrides[j] = strides.data() + j * ndim;
+          }
+
+          // The permutation lists the dimensions from the smallest stride to the largest
+          std::vector<int> axis_perm(ndim);
+          multistrides_to_axis_perm(ndim, N + 1, operstrides.data(), axis_perm.data());
+
+          std::vector<fixed_dim_loop<N>> reordered;
+          for (intptr_t i = ndim - 1; i >= 0; --i) {
+            reordered.push_back(loops[axis_perm[i]]);
+          }
+          loops.swap(reordered);
+        }
+
+        for (size_t i = loops.size() - 1; i > 0; --i) {
+          fixed_dim_loop<N> &outer = loops[i - 1];
+          const fixed_dim_loop<N> &inner = loops[i];
+          bool contiguous = outer.dst_stride == inner.size * inner.dst_stride;
+          for (size_t j = 0; j < N; ++j) {
+            contiguous &= outer.src_stride[j] == inner.size * inner.src_stride[j];
+          }
+
+          if (contiguous) {
+            outer.size *= inner.size;
+            outer.dst_stride = inner.dst_stride;
+            outer.src_stride = inner.src_stride;
+            loops.erase(loops.begin() + i);
+          }
+        }
+      }
+
+      /**
+       * Whether the two innermost loops should be visited in tiles, which is when
+       * they are both long and the operands disagree on which one is contiguous.
+       */
+      static bool tile_loops(const std::vector<fixed_dim_loop<N>> &loops) {
+        if (loops.size() < 2) {
+          return false;
+        }
+
+        const fixed_dim_loop<N> &outer = loops[loops.size() - 2];
+        const fixed_dim_loop<N> &inner = loops[loops.size() - 1];
+        if (outer.size < DYND_TILE_SIZE || inner.size < DYND_TILE_SIZE) {
+          return false;
+        }
+
+        bool outer_first = false, inner_first = false;
+        for (size_t j = 0; j <= N; ++j) {
+          intptr_t outer_stride = std::abs((j == 0) ? outer.dst_stride : outer.src_stride[j - 1]);
+          intptr_t inner_stride = std::abs((j == 0) ? inner.dst_stride : inner.src_stride[j - 1]);
+          if (outer_stride != 0 && inner_stride != 0) {
+            outer_first |= outer_stride < inner_stride;
+            inner_first |= inner_stride < outer_stride;
+          }
+        }
+
+        return outer_first && inner_first;
+      }
+
+      /**
+       * Instantiates the loops from ``first`` on, skipping the call graph nodes of
+       * the dimensions they replace, and then the child.
+       */
+      static void instantiate_inner(kernel_builder &kb, char *data, const std::vector<fixed_dim_loop<N>> &loops,
+                                    size_t first, bool tiled, size_t npass, const char *child_dst_arrmeta,
+                                    const std::array<const char *, N> &child_src_arrmeta) {
+        for (size_t i = first; i < loops.size(); ++i) {
+          if (tiled && i == loops.size() - 2) {
+            kb.emplace_back<tiled_elwise_kernel<N>>(kernel_request_strided, loops[i].size, loops[i].dst_stride,
+                                                    loops[i].src_stride.data(), loops[i + 1].size,
+                                                    loops[i + 1].dst_stride, loops[i + 1].src_stride.data());
+            break;
+          }
+          kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(
+              kernel_request_strided, data, loops[i].size, loops[i].dst_stride, loops[i].src_stride.data());
+        }
+        for (size_t i = 0; i < npass; ++i) {
+          kb.pass();
+        }
+
+        kb(kernel_request_strided, TraitsType::child_data(data), child_dst_arrmeta, N, child_src_arrmeta.data());
+      }
+
     public:
-      void subresolve(call_graph &cg, const char *data) {
+      void subresolve(call_graph &cg, char *data) {
         bool res_broadcast = reinterpret_cast<const data_type *>(data)->res_ignore;
         const std::array<bool, N> &arg_broadcast = reinterpret_cast<const data_type *>(data)->arg_broadcast;
+        const std::array<bool, N> &arg_unit_dim = reinterpret_cast<const data_type *>(data)->arg_unit_dim;
+        bool parallel = reinterpret_cast<const data_type *>(data)->parallel &&
+                        std::is_same<TraitsType, no_traits>::value && !res_broadcast;
+
+        std::shared_ptr<fixed_dim_level<N>> level = std::make_shared<fixed_dim_level<N>>(
+            fixed_dim_level<N>{res_broadcast, arg_broadcast, arg_unit_dim, nullptr});
+
+        // Directly nested fixed dimensions without state are planned together by the outermost one
+        if (std::is_same<TraitsType, no_traits>::value) {
+          void *outer_level = reinterpret_cast<const data_type *>(data)->outer_level;
+          if (outer_level != nullptr) {
+            reinterpret_cast<fixed_dim_level<N> *>(outer_level)->inner = level;
+          }
+          reinterpret_cast<data_type *>(data)->level = level.get();
+        }
 
-        cg.emplace_back([res_broadcast, arg_broadcast](kernel_builder &kb, kernel_request_t kernreq, char *data,
-                                                       const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
-                                                       const char *const *src_arrmeta) {
-          size_t size;
-          if (res_broadcast) {
-            size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
-          } else {
-            size = reinterpret_cast<const size_stride_t *>(dst_arrmeta)->dim_size;
+        cg.emplace_back([level, parallel](kernel_builder &kb, kernel_request_t kernreq, char *data,
+                                          const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                          const char *const *src_arrmeta) {
+          const char *child_dst_arrmeta = dst_arrmeta;
+          std::array<const char *, N> child_src_arrmeta;
+          std::copy(src_arrmeta, src_arrmeta + N, child_src_arrmeta.begin());
+
+          std::vector<fixed_dim_loop<N>> loops;
+          for (const fixed_dim_level<N> *l = level.get(); l != nullptr; l = l->inner.get()) {
+            fixed_dim_loop<N> loop;
+            if (l->res_broadcast) {
+              loop.size = reinterpret_cast<const size_stride_t *>(child_src_arrmeta[0])->dim_size;
+              loop.dst_stride = 0;
+            } else {
+              loop.size = reinterpret_cast<const size_stride_t *>(child_dst_arrmeta)->dim_size;
+              loop.dst_stride = reinterpret_cast<const size_stride_t *>(child_dst_arrmeta)->stride;
+              child_dst_arrmeta += sizeof(size_stride_t);
+            }
+
+            for (size_t i = 0; i < N; ++i) {
+              if (l->arg_broadcast[i]) {
+                loop.src_stride[i] = 0;
+                // A dimension of size one is still there to step over
+                if (l->arg_unit_dim[i]) {
+                  child_src_arrmeta[i] += sizeof(size_stride_t);
+                }
+              } else {
+                loop.src_stride[i] = reinterpret_cast<const size_stride_t *>(child_src_arrmeta[i])->stride;
+                child_src_arrmeta[i] += sizeof(size_stride_t);
+              }
+            }
+
+            loops.push_back(loop);
           }
 
-          intptr_t dst_stride;
-          const char *child_dst_arrmeta;
-          if (res_broadcast) {
-            dst_stride = 0;
-            child_dst_arrmeta = dst_arrmeta;
-          } else {
-            dst_stride = reinterpret_cast<const size_stride_t *>(dst_arrmeta)->stride;
-            child_dst_arrmeta = dst_arrmeta + sizeof(size_stride_t);
+          // Without a result, the order of the elements may be observable
+          size_t ndim = loops.size();
+          bool reorder = !level->res_broadcast;
+          plan_loops(loops, reorder);
+
+          // Only the outermost dimension, which is not requested as strided, is
+          // split across threads
+          size_t nchunks = 1;
+          if (parallel && kernreq != kernel_request_strided) {
+            const eval::eval_context *ectx = &eval::default_eval_context;
+            nchunks = std::min<size_t>(ectx->nthreads, loops[0].size / std::max<intptr_t>(ectx->min_grain_size, 1));
           }
 
-          std::array<intptr_t, N> src_stride;
-          std::array<const char *, N> child_src_arrmeta;
-          for (size_t i = 0; i < N; ++i) {
-            if (arg_broadcast[i]) {
-              src_stride[i] = 0;
-              child_src_arrmeta[i] = src_arrmeta[i];
-            } else {
-              src_stride[i] = reinterpret_cast<const size_stride_t *>(src_arrmeta[i])->stride;
-              child_src_arrmeta[i] = src_arrmeta[i] + sizeof(size_stride_t);
+          // Tiles take the two innermost loops, unless one of them is split across threads
+          bool tiled = reorder && tile_loops(loops) && !(nchunks > 1 && loops.size() == 2);
+          size_t npass = ndim - (tiled ? loops.size() - 1 : loops.size());
+
+          if (nchunks > 1) {
+            intptr_t self_offset = kb.size();
+            kb.emplace_back<parallel_elwise_kernel<N>>(kernreq, loops[0].size, loops[0].dst_stride,
+                                                       loops[0].src_stride.data(), nchunks);
+
+            call_node *child_call = kb.get_call();
+            instantiate_inner(kb, data, loops, 1, tiled, npass, child_dst_arrmeta, child_src_arrmeta);
+
+            parallel_elwise_kernel<N> *self = kb.get_at<parallel_elwise_kernel<N>>(self_offset);
+            for (size_t i = 0; i < nchunks - 1; ++i) {
+              self->m_clones[i] = new kernel_builder(child_call);
+              instantiate_inner(*self->m_clones[i], data, loops, 1, tiled, npass, child_dst_arrmeta,
+                                child_src_arrmeta);
             }
+            return;
           }
 
-          kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(kernreq, data, size, dst_stride,
-                                                                                    src_stride.data());
+          if (tiled && loops.size() == 2) {
+            kb.emplace_back<tiled_elwise_kernel<N>>(kernreq, loops[0].size, loops[0].dst_stride,
+                                                    loops[0].src_stride.data(), loops[1].size, loops[1].dst_stride,
+                                                    loops[1].src_stride.data());
+            instantiate_inner(kb, data, loops, 2, tiled, npass, child_dst_arrmeta, child_src_arrmeta);
+            return;
+          }
 
-          kb(kernel_request_strided, TraitsType::child_data(data), child_dst_arrmeta, N, child_src_arrmeta.data());
+          kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(
+              kernreq, data, loops[0].size, loops[0].dst_stride, loops[0].src_stride.data());
+          instantiate_inner(kb, data, loops, 1, tiled, npass, child_dst_arrmeta, child_src_arrmeta);
         });
       }
 
@@ -100,7 +294,7 @@ namespace nd {
       typedef typename base_elwise_callable<N>::data_type data_type;
 
     public:
-      void subresolve(call_graph &cg, const char *data) {
+      void subresolve(call_graph &cg, char *data) {
         std::array<bool, N> arg_broadcast = reinterpret_cast<const data_type *>(data)->arg_broadcast;
         std::array<bool, N> arg_var = reinterpret_cast<const data_type *>(data)->arg_var;
 
@@ -157,7 +351,7 @@ namespace nd {
         return ndt::make_type<ndt::var_dim_type>(ret_element_tp);
       }
 
-      void subresolve(call_graph &cg, const char *data) {
+      void subresolve(call_graph &cg, char *data) {
         std::array<bool, N> arg_broadcast = reinterpret_cast<const node_type *>(data)->arg_broadcast;
         std::array<bool, N> arg_var = reinterpret_cast<const node_type *>(data)->arg_var;
         intptr_t res_alignment = reinterpret_cast<const node_type *>(data)->res_alignment;
@@ -26,6 +26,7 @@ namespace nd {
         bool state;
         size_t ndim;
         bool first;
+        void *level;
       };
 
       elwise_dispatch_callable() : base_callable(ndt::type()) {}
@@ -33,7 +33,7 @@ namespace nd {
       ndt::type resolve(base_callable *caller, char *DYND_UNUSED(data), call_graph &cg, const ndt::type &dst_tp,
                         size_t nsrc, const ndt::type *src_tp, size_t nkwd, const array *kwds,
                         const std::map<std::string, ndt::type> &tp_vars) {
-        data_type data{m_child ? m_child.get() : caller, m_res_ignore, false, 0, true};
+        data_type data{m_child ? m_child.get() : caller, m_res_ignore, false, 0, true, nullptr};
 
         const std::vector<ndt::type> &child_arg_tp = data.child->get_arg_types();
         for (size_t i = 0; i < nsrc; ++i) {
@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+
+#include <dynd/assignment.hpp>
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/fuse_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * A callable for a chain of elementwise stages, see ``nd::functional::fuse``.
+     */
+    class fuse_callable : public base_callable {
+      std::vector<callable> m_children;
+      std::vector<std::vector<intptr_t>> m_args;
+
+    public:
+      fuse_callable(const ndt::type &tp, const std::vector<callable> &children,
+                    const std::vector<std::vector<intptr_t>> &args)
+          : base_callable(tp), m_children(children), m_args(args) {}
+
+      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                        const ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp, size_t nkwd, const array *kwds,
+                        const std::map<std::string, ndt::type> &tp_vars) {
+        // The buffer types, and whether the result needs a conversion, are only known once the stages are resolved
+        std::shared_ptr<std::vector<ndt::type>> buffer_tp = std::make_shared<std::vector<ndt::type>>();
+        std::shared_ptr<std::vector<std::vector<intptr_t>>> all_args =
+            std::make_shared<std::vector<std::vector<intptr_t>>>(m_args);
+
+        cg.emplace_back([nsrc, all_args, buffer_tp](kernel_builder &kb, kernel_request_t kernreq,
+                                                    char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                    size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          const std::vector<std::vector<intptr_t>> &args = *all_args;
+          intptr_t root_kb_offset = kb.size();
+          kb.emplace_back<fuse_kernel>(kernreq, nsrc, args, *buffer_tp);
+
+          std::vector<const char *> child_src_arrmeta;
+          for (size_t i = 0; i < args.size(); ++i) {
+            fuse_kernel *self = kb.get_at<fuse_kernel>(root_kb_offset);
+            self->offsets[i] = kb.size() - root_kb_offset;
+
+            child_src_arrmeta.clear();
+            for (intptr_t j : args[i]) {
+              child_src_arrmeta.push_back(j < static_cast<intptr_t>(nsrc) ? src_arrmeta[j]
+                                                                          : self->get_buffer_arrmeta(j - nsrc));
+            }
+            const char *child_dst_arrmeta = (i == args.size() - 1) ? dst_arrmeta : self->get_buffer_arrmeta(i);
+            kb(kernel_request_strided, nullptr, child_dst_arrmeta, child_src_arrmeta.size(),
+               child_src_arrmeta.data());
+          }
+        });
+
+        ndt::type ret_tp;
+        std::vector<ndt::type> child_src_tp;
+        for (size_t i = 0; i < m_children.size(); ++i) {
+          child_src_tp.clear();
+          for (intptr_t j : m_args[i]) {
+            child_src_tp.push_back(j < static_cast<intptr_t>(nsrc) ? src_tp[j] : (*buffer_tp)[j - nsrc]);
+          }
+
+          ret_tp = m_children[i]->resolve(this, nullptr, cg, m_children[i]->get_ret_type(), child_src_tp.size(),
+                                          child_src_tp.data(), nkwd, kwds, tp_vars);
+          if (ret_tp.is_symbolic()) {
+            throw std::runtime_error("could not resolve the type of stage " + std::to_string(i) +
+                                     " in a fused callable, got " + ret_tp.str());
+          }
+          if (i != m_children.size() - 1) {
+            buffer_tp->push_back(ret_tp);
+          }
+        }
+
+        // The children write their own result types, so a different destination gets a final conversion
+        if (!dst_tp.is_symbolic() && dst_tp != ret_tp) {
+          buffer_tp->push_back(ret_tp);
+          all_args->push_back({static_cast<intptr_t>(nsrc + m_children.size() - 1)});
+
+          nd::array error_mode = assign_error_default;
+          assign->resolve(this, nullptr, cg, dst_tp, 1, &ret_tp, 1, &error_mode, tp_vars);
+          return dst_tp;
+        }
+
+        return ret_tp;
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,16 +5,13 @@
 
 #pragma once
 
-#include <dynd/callables/apply_function_callable.hpp>
-#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/callables/arithmetic_callable.hpp>
 
 namespace dynd {
 namespace nd {
 
   template <typename Arg0Type, typename Arg1Type>
-  using multiply_callable =
-      functional::apply_function_callable<decltype(&dynd::detail::inline_multiply<Arg0Type, Arg1Type>::f),
-                                          &dynd::detail::inline_multiply<Arg0Type, Arg1Type>::f>;
+  using multiply_callable = arithmetic_callable<dynd::detail::inline_multiply, simd::op_multiply, Arg0Type, Arg1Type>;
 
 } // namespace dynd::nd
 } // namespace dynd
@@ -16,10 +16,12 @@ namespace nd {
     class reduction_dispatch_callable : public base_callable {
       callable m_identity;
       callable m_child;
+      callable_property m_properties;
 
     public:
-      reduction_dispatch_callable(const ndt::type &tp, const callable &identity, const callable &child)
-          : base_callable(tp), m_identity(identity), m_child(child) {}
+      reduction_dispatch_callable(const ndt::type &tp, const callable &identity, const callable &child,
+                                  callable_property properties = none)
+          : base_callable(tp), m_identity(identity), m_child(child), m_properties(properties) {}
 
       typedef typename base_reduction_callable::data_type new_data_type;
 
@@ -30,6 +32,7 @@ namespace nd {
         if (data == nullptr) {
           new_data.identity = m_identity;
           new_data.child = m_child;
+          new_data.associative = (m_properties & associative) != 0;
           if (kwds[0].is_na()) {
             new_data.naxis = src_tp[0].get_ndim() - m_child->get_ret_type().get_ndim();
             new_data.axes = NULL;
@@ -90,7 +93,7 @@ namespace nd {
 
           ndt::type ret_tp = m_child->resolve(this, nullptr, cg, dst_tp, nsrc, src_tp, nkwd - 2, kwds + 2, tp_vars);
 
-          m_identity->resolve(this, nullptr, cg, ret_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+          base_reduction_callable::resolve_identity(this, m_identity, cg, ret_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
 
           return ret_tp;
         }
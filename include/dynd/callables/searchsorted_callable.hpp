@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/comparison.hpp>
+#include <dynd/kernels/binary_search_kernel.hpp>
+#include <dynd/types/option_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  class searchsorted_callable : public base_callable {
+    /**
+     * Resolves to a branchless search of the values of type ``T``.
+     */
+    template <typename T>
+    static void resolve_search(call_graph &cg, bool right) {
+      cg.emplace_back([right](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                              const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<searchsorted_kernel<T>>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[1])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[1])->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta)->stride, right);
+      });
+    }
+
+  public:
+    searchsorted_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<intptr_t>()),
+              {ndt::type("Fixed * Scalar"), ndt::type("Fixed * Scalar")},
+              {{ndt::make_type<ndt::option_type>(ndt::make_type<dynd::string>()), "side"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+      // A missing string keyword is assigned the empty string
+      std::string side = kwds[0].is_na() ? std::string() : kwds[0].as<std::string>();
+      if (!side.empty() && side != "left" && side != "right") {
+        throw std::invalid_argument("searchsorted: side must be \"left\" or \"right\", not \"" + side + "\"");
+      }
+      bool right = side == "right";
+
+      const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      const ndt::type &src1_element_tp = src_tp[1].extended<ndt::fixed_dim_type>()->get_element_type();
+      if (src0_element_tp != src1_element_tp) {
+        std::stringstream ss;
+        ss << "searchsorted: the needles have type " << src1_element_tp << ", but the sorted values have type "
+           << src0_element_tp;
+        throw type_error(ss.str());
+      }
+
+      ndt::type ret_tp = ndt::make_fixed_dim(src_tp[1].get_dim_size(NULL, NULL), ndt::make_type<intptr_t>());
+      switch (src0_element_tp.get_id()) {
+      case int8_id:
+        resolve_search<int8_t>(cg, right);
+        return ret_tp;
+      case int16_id:
+        resolve_search<int16_t>(cg, right);
+        return ret_tp;
+      case int32_id:
+        resolve_search<int32_t>(cg, right);
+        return ret_tp;
+      case int64_id:
+        resolve_search<int64_t>(cg, right);
+        return ret_tp;
+      case uint8_id:
+        resolve_search<uint8_t>(cg, right);
+        return ret_tp;
+      case uint16_id:
+        resolve_search<uint16_t>(cg, right);
+        return ret_tp;
+      case uint32_id:
+        resolve_search<uint32_t>(cg, right);
+        return ret_tp;
+      case uint64_id:
+        resolve_search<uint64_t>(cg, right);
+        return ret_tp;
+      case float32_id:
+        resolve_search<float>(cg, right);
+        return ret_tp;
+      case float64_id:
+        resolve_search<double>(cg, right);
+        return ret_tp;
+      default:
+        break;
+      }
+
+      // Any other type is compared with less
+      cg.emplace_back([right](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                              const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<searchsorted_less_kernel>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[1])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[1])->stride,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta)->stride, right);
+
+        kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+      });
+
+      const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+      less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+
+      return ret_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
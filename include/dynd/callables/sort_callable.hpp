@@ -13,6 +13,20 @@ namespace dynd {
 namespace nd {
 
   class sort_callable : public base_callable {
+    /**
+     * Resolves to a radix sort of the values of type ``T``.
+     */
+    template <typename T>
+    static void resolve_radix(call_graph &cg) {
+      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                         const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                         const char *const *src_arrmeta) {
+        kb.emplace_back<radix_sort_kernel<T>>(
+            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride);
+      });
+    }
+
   public:
     sort_callable()
         : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Scalar")})) {}
@@ -22,15 +36,57 @@ namespace nd {
                       size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
                       const std::map<std::string, ndt::type> &tp_vars) {
       const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      switch (src0_element_tp.get_id()) {
+      case int8_id:
+        resolve_radix<int8_t>(cg);
+        return dst_tp;
+      case int16_id:
+        resolve_radix<int16_t>(cg);
+        return dst_tp;
+      case int32_id:
+        resolve_radix<int32_t>(cg);
+        return dst_tp;
+      case int64_id:
+        resolve_radix<int64_t>(cg);
+        return dst_tp;
+      case uint8_id:
+        resolve_radix<uint8_t>(cg);
+        return dst_tp;
+      case uint16_id:
+        resolve_radix<uint16_t>(cg);
+        return dst_tp;
+      case uint32_id:
+        resolve_radix<uint32_t>(cg);
+        return dst_tp;
+      case uint64_id:
+        resolve_radix<uint64_t>(cg);
+        return dst_tp;
+      case float32_id:
+        resolve_radix<float>(cg);
+        return dst_tp;
+      case float64_id:
+        resolve_radix<double>(cg);
+        return dst_tp;
+      default:
+        break;
+      }
+
+      // Any other type is compared with less, in a merge sort over several threads
       size_t src0_element_data_size = src0_element_tp.get_data_size();
       cg.emplace_back([src0_element_data_size](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
                                                const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
                                                const char *const *src_arrmeta) {
-        kb.emplace_back<sort_kernel>(
-            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
-            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride, src0_element_data_size);
+        intptr_t src0_size = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size;
+        const eval::eval_context *ectx = &eval::default_eval_context;
+        intptr_t self_offset = kb.size();
+        kb.emplace_back<sort_kernel>(kernreq, src0_size,
+                                     reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
+                                     src0_element_data_size, detail::sort_nchunks(src0_size, ectx));
 
+        // Every chunk of the sort compares with its own less child
+        call_node *child_call = kb.get_call();
         kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        kb.get_at<sort_kernel>(self_offset)->children.instantiate(child_call);
       });
 
       const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
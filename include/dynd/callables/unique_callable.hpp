@@ -5,42 +5,151 @@
 
 #pragma once
 
+#include <dynd/assignment.hpp>
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/kernels/unique_kernel.hpp>
+#include <dynd/types/struct_type.hpp>
 
 namespace dynd {
 namespace nd {
 
+  /**
+   * A callable which finds the distinct values of a dimension with a hash
+   * table, see ``nd::unique``, ``nd::value_counts`` and ``nd::factorize``.
+   */
   class unique_callable : public base_callable {
-  public:
-    unique_callable()
-        : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Scalar")})) {}
+    unique_mode m_mode;
 
-    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &DYND_UNUSED(cg),
-                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
-                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
-                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
-      return dst_tp;
+    static ndt::type make_ret_type(unique_mode mode) {
+      switch (mode) {
+      case unique_value_counts:
+        return ndt::type("{values: var * Scalar, counts: var * intptr}");
+      case unique_factorize:
+        return ndt::type("{codes: Fixed * intptr, uniques: var * Scalar}");
+      default:
+        return ndt::type("var * Scalar");
+      }
+    }
+
+    static ndt::type make_ret_type(unique_mode mode, const ndt::type &element_tp, intptr_t size) {
+      ndt::type uniques_tp = ndt::make_type<ndt::var_dim_type>(element_tp);
+      switch (mode) {
+      case unique_value_counts:
+        return ndt::make_type<ndt::struct_type>(
+            {{uniques_tp, "values"}, {ndt::make_type<ndt::var_dim_type>(ndt::make_type<intptr_t>()), "counts"}});
+      case unique_factorize:
+        return ndt::make_type<ndt::struct_type>(
+            {{ndt::make_fixed_dim(size, ndt::make_type<intptr_t>()), "codes"}, {uniques_tp, "uniques"}});
+      default:
+        return uniques_tp;
+      }
     }
 
-    /*
-        void instantiate(call_node *&node, char *data, kernel_builder *ckb, const ndt::type &DYND_UNUSED(dst_tp),
-                         const char *DYND_UNUSED(dst_arrmeta), intptr_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
-                         const char *const *src_arrmeta, kernel_request_t kernreq, intptr_t nkwd, const nd::array *kwds,
-                         const std::map<std::string, ndt::type> &tp_vars) {
-          const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
-          ckb->emplace_back<unique_kernel>(
-              kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
-              reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride,
-       src0_element_tp.get_data_size());
-          node = next(node);
-
-          const ndt::type equal_src_tp[2] = {src0_element_tp, src0_element_tp};
-          equal->instantiate(node, data, ckb, ndt::make_type<bool1>(), NULL, 2, equal_src_tp, NULL,
-       kernel_request_single,
-                             nkwd, kwds, tp_vars);
+    template <typename HasherType>
+    void resolve_hasher(call_graph &cg, const HasherType &hasher, const ndt::type &ret_tp) {
+      unique_mode mode = m_mode;
+      cg.emplace_back([hasher, mode, ret_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                             const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                             const char *const *src_arrmeta) {
+        typedef unique_kernel<HasherType> self_type;
+
+        intptr_t self_offset = kb.size();
+        kb.emplace_back<self_type>(kernreq, hasher, mode,
+                                   reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
+                                   reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride);
+
+        self_type *self = kb.get_at<self_type>(self_offset);
+        if (mode == unique_values) {
+          self->uniques_arrmeta = dst_arrmeta;
+        } else {
+          // The outputs are fields of a struct, whose arrmeta starts with their data offsets
+          const ndt::struct_type *ret_sd = ret_tp.extended<ndt::struct_type>();
+          const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(dst_arrmeta);
+          intptr_t uniques_i = (mode == unique_value_counts) ? 0 : 1;
+          self->uniques_arrmeta = dst_arrmeta + ret_sd->get_arrmeta_offset(uniques_i);
+          self->uniques_offset = data_offsets[uniques_i];
+          if (mode == unique_value_counts) {
+            self->counts_arrmeta = dst_arrmeta + ret_sd->get_arrmeta_offset(1);
+            self->counts_offset = data_offsets[1];
+          } else {
+            self->codes_stride =
+                reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta + ret_sd->get_arrmeta_offset(0))->stride;
+            self->codes_offset = data_offsets[0];
+          }
         }
-    */
+
+        const char *child_dst_arrmeta = self->uniques_arrmeta + sizeof(ndt::var_dim_type::metadata_type);
+        const char *child_src_arrmeta = src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta);
+        kb(kernel_request_single, nullptr, child_dst_arrmeta, 1, &child_src_arrmeta);
+      });
+    }
+
+  public:
+    unique_callable(unique_mode mode = unique_values)
+        : base_callable(ndt::make_type<ndt::callable_type>(make_ret_type(mode), {ndt::type("Fixed * Scalar")})),
+          m_mode(mode) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      ndt::type ret_tp = make_ret_type(m_mode, src0_element_tp, src_tp[0].get_dim_size(NULL, NULL));
+
+      switch (src0_element_tp.get_id()) {
+      case bool_id:
+      case uint8_id:
+        resolve_hasher(cg, detail::value_hasher<uint8_t>(), ret_tp);
+        break;
+      case int8_id:
+        resolve_hasher(cg, detail::value_hasher<int8_t>(), ret_tp);
+        break;
+      case int16_id:
+        resolve_hasher(cg, detail::value_hasher<int16_t>(), ret_tp);
+        break;
+      case int32_id:
+        resolve_hasher(cg, detail::value_hasher<int32_t>(), ret_tp);
+        break;
+      case int64_id:
+        resolve_hasher(cg, detail::value_hasher<int64_t>(), ret_tp);
+        break;
+      case uint16_id:
+        resolve_hasher(cg, detail::value_hasher<uint16_t>(), ret_tp);
+        break;
+      case uint32_id:
+        resolve_hasher(cg, detail::value_hasher<uint32_t>(), ret_tp);
+        break;
+      case uint64_id:
+        resolve_hasher(cg, detail::value_hasher<uint64_t>(), ret_tp);
+        break;
+      case float32_id:
+        resolve_hasher(cg, detail::value_hasher<float>(), ret_tp);
+        break;
+      case float64_id:
+        resolve_hasher(cg, detail::value_hasher<double>(), ret_tp);
+        break;
+      case fixed_string_id:
+      case fixed_bytes_id:
+        resolve_hasher(cg, detail::fixed_bytes_hasher(src0_element_tp.get_data_size()), ret_tp);
+        break;
+      case string_id:
+        resolve_hasher(cg, detail::string_hasher<dynd::string>(), ret_tp);
+        break;
+      case bytes_id:
+        resolve_hasher(cg, detail::string_hasher<dynd::bytes>(), ret_tp);
+        break;
+      default: {
+        std::stringstream ss;
+        ss << "unique: cannot hash values of type " << src0_element_tp;
+        throw type_error(ss.str());
+      }
+      }
+
+      nd::array error_mode = assign_error_default;
+      assign->resolve(this, nullptr, cg, src0_element_tp, 1, &src0_element_tp, 1, &error_mode, tp_vars);
+
+      return ret_tp;
+    }
   };
 
 } // namespace dynd::nd
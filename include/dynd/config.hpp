@@ -32,6 +32,9 @@
 /** The number of elements to process at once when doing chunking/buffering */
 #define DYND_BUFFER_CHUNK_SIZE 128
 
+/** The number of elements along each side of a tile, when two dimensions are visited in tiles */
+#define DYND_TILE_SIZE 32
+
 #ifdef __clang__
 
 #if __has_feature(cxx_constexpr)
@@ -170,6 +173,13 @@ public:
 
 #endif // end of compiler vendor checks
 
+/** Hints that the memory at ADDR is about to be read */
+#if defined(__GNUC__) || defined(__clang__)
+#define DYND_PREFETCH(ADDR) __builtin_prefetch(ADDR)
+#else
+#define DYND_PREFETCH(ADDR)
+#endif
+
 // If being run from the CLING C++ interpreter
 #ifdef DYND_CLING
 // Don't use the memcpy function (it has inline assembly).
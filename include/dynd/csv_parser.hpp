@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstring>
+
+#include <dynd/array.hpp>
+#include <dynd/parse_util.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace csv {
+
+    /**
+     * How the delimited text given to ``nd::csv::read`` is laid out.
+     */
+    struct read_options {
+      // The character between the fields of a row
+      char delimiter;
+      // The character around fields which contain the delimiter, a newline or
+      // the quote itself, which is written twice within them
+      char quote;
+      // Whether the first row holds the names of the columns
+      bool header;
+      // How many rows the type is inferred from when none is given
+      intptr_t sample_rows;
+
+      read_options() : delimiter(','), quote('"'), header(true), sample_rows(1024) {}
+    };
+
+  } // namespace dynd::nd::csv
+} // namespace dynd::nd
+
+namespace ndt {
+  namespace csv {
+
+    /**
+     * Infers the type of a row of delimited text from its first
+     * ``options.sample_rows`` rows, as a struct with a field for every column.
+     * A column is ``bool`` if every value in it is "true" or "false", ``int64``
+     * or ``float64`` if every value is a number which fits, and ``string``
+     * otherwise. Columns of numbers or booleans which have missing values,
+     * such as empty fields or "NA", have option types. The fields are named by
+     * the header, or "f0", "f1", ... without one.
+     */
+    DYND_API type discover(const char *begin, const char *end,
+                           const nd::csv::read_options &options = nd::csv::read_options());
+
+  } // namespace dynd::ndt::csv
+} // namespace dynd::ndt
+
+namespace nd {
+  namespace csv {
+
+    /**
+     * Parses delimited text, encoded as UTF-8, such as CSV. ``tp`` is either the
+     * type of a row, ``{name0: T0, name1: T1, ...}``, optionally given as
+     * ``Fixed * {...}`` or ``var * {...}``, which is read into an array of type
+     * ``N * {...}``, or a struct of columns, ``{name0: Fixed * T0, ...}``, which
+     * is read into an array of type ``{name0: N * T0, ...}``. The fields are
+     * matched to the columns by position. The header row, if there is one, and
+     * blank lines are skipped.
+     *
+     * The text is split into chunks of whole rows, keeping quoted fields which
+     * span lines whole, and the chunks are parsed on up to ``ectx->nthreads``
+     * threads, each straight into its part of the result.
+     *
+     * \param tp  The type of a row, or of the columns.
+     * \param begin  The beginning of the UTF-8 buffer.
+     * \param end  One past the end of the UTF-8 buffer.
+     * \param options  The delimiter and quote characters, and whether there is a header.
+     * \param ectx  An evaluation context.
+     */
+    DYND_API array read(const ndt::type &tp, const char *begin, const char *end,
+                        const read_options &options = read_options(),
+                        const eval::eval_context *ectx = &eval::default_eval_context);
+
+    /**
+     * Parses delimited text from a string or a bytes array, such as a memory
+     * mapped file. Bytes are assumed to be UTF-8.
+     */
+    DYND_API array read(const ndt::type &tp, const array &buffer, const read_options &options = read_options(),
+                        const eval::eval_context *ectx = &eval::default_eval_context);
+
+    inline array read(const ndt::type &tp, const std::string &buffer, const read_options &options = read_options(),
+                      const eval::eval_context *ectx = &eval::default_eval_context) {
+      return read(tp, buffer.data(), buffer.data() + buffer.size(), options, ectx);
+    }
+
+    inline array read(const ndt::type &tp, const char *buffer, const read_options &options = read_options(),
+                      const eval::eval_context *ectx = &eval::default_eval_context) {
+      return read(tp, buffer, buffer + strlen(buffer), options, ectx);
+    }
+
+    /**
+     * Parses delimited text, the type of whose rows is inferred with
+     * ``ndt::csv::discover``, into an array of type ``N * {...}``.
+     */
+    inline array read(const char *begin, const char *end, const read_options &options = read_options(),
+                      const eval::eval_context *ectx = &eval::default_eval_context) {
+      return read(ndt::csv::discover(begin, end, options), begin, end, options, ectx);
+    }
+
+    DYND_API array read(const array &buffer, const read_options &options = read_options(),
+                        const eval::eval_context *ectx = &eval::default_eval_context);
+
+    inline array read(const std::string &buffer, const read_options &options = read_options(),
+                      const eval::eval_context *ectx = &eval::default_eval_context) {
+      return read(buffer.data(), buffer.data() + buffer.size(), options, ectx);
+    }
+
+    inline array read(const char *buffer, const read_options &options = read_options(),
+                      const eval::eval_context *ectx = &eval::default_eval_context) {
+      return read(buffer, buffer + strlen(buffer), options, ectx);
+    }
+
+  } // namespace dynd::nd::csv
+} // namespace dynd::nd
+} // namespace dynd
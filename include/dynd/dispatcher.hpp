@@ -5,9 +5,11 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
-
-// #include <sparsehash/dense_hash_map>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 #include <dynd/type_registry.hpp>
 
@@ -91,6 +93,100 @@ namespace detail {
     }
   }
 
+  /**
+   * A hash table with open addressing and linear probing, mapping a tuple of
+   * type ids to the index of a child of a dispatcher. The slots are kept in one
+   * flat array, which is grown to keep it at most half full.
+   */
+  template <size_t N>
+  class dispatch_table {
+  public:
+    typedef std::array<type_id_t, N> key_type;
+
+  private:
+    struct slot {
+      key_type key;
+      intptr_t value;
+    };
+
+    // An empty slot has uninitialized_id as its first id, which no dispatched type has
+    std::vector<slot> m_slots;
+    size_t m_size;
+
+    void grow() {
+      std::vector<slot> slots(m_slots.empty() ? 16 : 2 * m_slots.size());
+      for (slot &s : slots) {
+        s.key[0] = uninitialized_id;
+      }
+
+      m_slots.swap(slots);
+      m_size = 0;
+      for (const slot &s : slots) {
+        if (s.key[0] != uninitialized_id) {
+          insert(s.key, hash(s.key), s.value);
+        }
+      }
+    }
+
+  public:
+    dispatch_table() : m_size(0) {}
+
+    size_t size() const { return m_size; }
+
+    void clear() {
+      m_slots.clear();
+      m_size = 0;
+    }
+
+    /**
+     * Returns a pointer to the value for ``key``, or NULL if it is not in the table.
+     */
+    const intptr_t *find(const key_type &key, size_t h) const {
+      if (m_slots.empty()) {
+        return NULL;
+      }
+
+      size_t mask = m_slots.size() - 1;
+      for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const slot &s = m_slots[i];
+        if (s.key == key) {
+          return &s.value;
+        }
+        if (s.key[0] == uninitialized_id) {
+          return NULL;
+        }
+      }
+    }
+
+    /**
+     * Inserts ``key``, which must not already be in the table.
+     */
+    void insert(const key_type &key, size_t h, intptr_t value) {
+      if (2 * (m_size + 1) > m_slots.size()) {
+        grow();
+      }
+
+      size_t mask = m_slots.size() - 1;
+      size_t i = h & mask;
+      while (m_slots[i].key[0] != uninitialized_id) {
+        i = (i + 1) & mask;
+      }
+
+      m_slots[i].key = key;
+      m_slots[i].value = value;
+      ++m_size;
+    }
+
+    static size_t hash(const key_type &key) {
+      size_t seed = 0;
+      for (size_t i = 0; i < N; ++i) {
+        seed ^= static_cast<size_t>(key[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+
+      return seed;
+    }
+  };
+
 } // namespace dynd::detail
 
 template <typename VertexIterator, typename EdgeIterator, typename Iterator>
@@ -132,22 +228,27 @@ inline std::ostream &print_ids(std::ostream &o, size_t nids, const ndt::type *tp
 
 template <size_t N, typename T>
 class dispatcher {
-  typedef std::map<size_t, T> Map;
-
 public:
   typedef T value_type;
 
-  typedef Map map_type;
-  //  typedef google::dense_hash_map<size_t, value_type> map_type;
+  typedef detail::dispatch_table<N> map_type;
 
   typedef typename std::vector<T>::iterator iterator;
   typedef typename std::vector<T>::const_iterator const_iterator;
 
 private:
+  // Sorted so that the first child whose signature matches is the most specific
   std::vector<T> m_children;
-  //  map_type m_map;
   dispatch_t m_dispatch;
 
+  // The children whose signatures are exact tuples of builtin types, which are
+  // looked up without a lock since they only change in assign
+  map_type m_exact;
+  // The results of other lookups of builtin types, including failed ones as -1,
+  // which are added as they are resolved
+  map_type m_resolved;
+  std::unique_ptr<std::mutex> m_mutex;
+
   static size_t hash_combine(size_t seed, type_id_t id) { return seed ^ (id + (seed << 6) + (seed >> 2)); }
 
   template <typename... IDTypes>
@@ -164,20 +265,75 @@ private:
     return seed;
   }
 
+  /**
+   * Gets the ids of ``tps`` as a key, returning false if any of them is not builtin,
+   * in which case its id alone does not say which children it matches.
+   */
+  static bool make_key(const std::vector<ndt::type> &tps, typename map_type::key_type &key) {
+    for (size_t i = 0; i < N; ++i) {
+      if (!tps[i].is_builtin()) {
+        return false;
+      }
+      key[i] = tps[i].get_id();
+    }
+
+    return true;
+  }
+
+  intptr_t find(const std::vector<ndt::type> &tps) const {
+    std::array<ndt::type, N> arr_tps = as_array<N>(tps);
+    for (size_t i = 0; i < m_children.size(); ++i) {
+      const T &child = m_children[i];
+      std::array<ndt::type, N> other_tps =
+          as_array<N>(m_dispatch(child->get_ret_type(), child->get_narg(), child->get_arg_types().data()));
+
+      if (supercedes(arr_tps, other_tps)) {
+        return i;
+      }
+    }
+
+    return -1;
+  }
+
+  void build_exact() {
+    m_exact.clear();
+    m_resolved.clear();
+
+    typename map_type::key_type key;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+      const T &child = m_children[i];
+      std::vector<ndt::type> tps = m_dispatch(child->get_ret_type(), child->get_narg(), child->get_arg_types().data());
+      if (make_key(tps, key)) {
+        size_t h = map_type::hash(key);
+        if (m_exact.find(key, h) == NULL) {
+          m_exact.insert(key, h, i);
+        }
+      }
+    }
+  }
+
 public:
-  dispatcher(dispatch_t dispatch) : m_dispatch(dispatch) {}
+  dispatcher(dispatch_t dispatch) : m_dispatch(dispatch), m_mutex(new std::mutex) {}
 
-  dispatcher(const dispatcher &other) : m_children(other.m_children), m_dispatch(other.m_dispatch) {}
+  dispatcher(const dispatcher &other)
+      : m_children(other.m_children), m_dispatch(other.m_dispatch), m_exact(other.m_exact), m_mutex(new std::mutex) {}
 
   template <typename Iterator>
-  dispatcher(dispatch_t dispatch, Iterator begin, Iterator end) : m_dispatch(dispatch) {
-    //    m_map.set_empty_key(uninitialized_id);
-
+  dispatcher(dispatch_t dispatch, Iterator begin, Iterator end) : m_dispatch(dispatch), m_mutex(new std::mutex) {
     assign(begin, end);
   }
 
   dispatcher(dispatch_t dispatch, std::initializer_list<T> pairs) : dispatcher(dispatch, pairs.begin(), pairs.end()) {}
 
+  dispatcher &operator=(const dispatcher &other) {
+    m_children = other.m_children;
+    m_dispatch = other.m_dispatch;
+    m_exact = other.m_exact;
+    m_resolved.clear();
+
+    return *this;
+  }
+
   template <typename Iterator>
   void assign(Iterator begin, Iterator end) {
     m_children.resize(end - begin);
@@ -225,7 +381,7 @@ public:
 
     topological_sort(begin, end, edges, m_children.begin());
 
-    //    m_map.clear();
+    build_exact();
   }
 
   void assign(std::initializer_list<T> pairs) { assign(pairs.begin(), pairs.end()); }
@@ -251,37 +407,39 @@ public:
   const_iterator cend() const { return m_children.cend(); }
 
   const value_type &operator()(const ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp) {
-    std::vector<ndt::type> vector_tps = m_dispatch(dst_tp, nsrc, src_tp);
-    std::array<ndt::type, N> tps;
+    std::vector<ndt::type> tps = m_dispatch(dst_tp, nsrc, src_tp);
+
+    typename map_type::key_type key;
+    bool builtin = make_key(tps, key);
+    size_t h = 0;
+    intptr_t i = -1;
+    if (builtin) {
+      h = map_type::hash(key);
+      const intptr_t *exact = m_exact.find(key, h);
+      if (exact != NULL) {
+        return m_children[*exact];
+      }
 
-    std::array<type_id_t, N> ids;
-    for (size_t i = 0; i < N; ++i) {
-      tps[i] = vector_tps[i];
-      ids[i] = tps[i].get_id();
+      std::lock_guard<std::mutex> lock(*m_mutex);
+      const intptr_t *resolved = m_resolved.find(key, h);
+      if (resolved == NULL) {
+        i = find(tps);
+        m_resolved.insert(key, h, i);
+      } else {
+        i = *resolved;
+      }
+    } else {
+      i = find(tps);
     }
 
-    //    size_t key = hash(ids);
-
-    /*
-        const auto &it = m_map.find(key);
-        if (it != m_map.end()) {
-          return it->second;
-        }
-    */
-
-    for (const T &child : m_children) {
-      std::array<ndt::type, N> other_tps =
-          as_array<N>(m_dispatch(child->get_ret_type(), child->get_narg(), child->get_arg_types().data()));
-
-      if (supercedes(tps, other_tps)) {
-        return child;
-      }
+    if (i >= 0) {
+      return m_children[i];
     }
 
     std::stringstream ss;
     ss << "signature not found for (";
-    for (size_t i = 0; i < N; ++i) {
-      ss << tps[i] << ", ";
+    for (size_t j = 0; j < N; ++j) {
+      ss << tps[j] << ", ";
     }
     ss << ")";
 
@@ -13,8 +13,13 @@ namespace eval {
   struct DYNDT_API eval_context {
     // Default error mode for computations
     assign_error_mode errmode;
+    // Maximum number of threads an elwise kernel may split its outermost
+    // dimension across, 1 disables parallel execution
+    size_t nthreads;
+    // Minimum number of elements of the outermost dimension given to each thread
+    intptr_t min_grain_size;
 
-    eval_context() : errmode(assign_error_fractional) {}
+    eval_context() : errmode(assign_error_fractional), nthreads(1), min_grain_size(16384) {}
   };
 
   extern DYNDT_API eval_context default_eval_context;
@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dynd/array.hpp>
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * A deferred elementwise expression, which records the callables applied to
+   * its operands instead of computing them. Nothing is allocated or computed
+   * until ``eval`` is called, or the expression is converted to an array.
+   *
+   * The whole expression is then evaluated at once. Subexpressions which are
+   * repeated, either as the same object or as the same callable applied to the
+   * same operands, are only computed once. The remaining operations run together
+   * as one fused kernel (see ``nd::functional::fuse``), with temporaries of a
+   * single block that are reused as the evaluation goes, and the result is
+   * written straight into the destination.
+   *
+   * Every callable in an expression must be elementwise, like the arithmetic
+   * callables.
+   */
+  class DYND_API expression {
+  public:
+    // The operation or value at the root of an expression, defined in expression.cpp
+    struct node;
+
+  private:
+    std::shared_ptr<const node> m_node;
+
+  public:
+    /**
+     * An expression which is the value of ``a``.
+     */
+    expression(const array &a);
+
+    /**
+     * An expression which applies ``child`` to ``args``.
+     */
+    expression(const callable &child, const std::vector<expression> &args);
+
+    /**
+     * Whether this expression is the value of an array, with nothing to compute.
+     */
+    bool is_value() const;
+
+    /**
+     * Evaluates the expression into a newly allocated array.
+     */
+    array eval() const;
+
+    /**
+     * Evaluates the expression into ``dst``, which must be broadcastable from
+     * the operands.
+     */
+    void eval(const array &dst) const;
+
+    operator array() const { return eval(); }
+  };
+
+  /**
+   * Returns ``a`` as an expression, so that the operators applied to it are deferred.
+   */
+  inline expression lazy(const array &a) { return expression(a); }
+
+  DYND_API expression operator+(const expression &a0);
+  DYND_API expression operator-(const expression &a0);
+
+  DYND_API expression operator+(const expression &op0, const expression &op1);
+  DYND_API expression operator-(const expression &op0, const expression &op1);
+  DYND_API expression operator*(const expression &op0, const expression &op1);
+  DYND_API expression operator/(const expression &op0, const expression &op1);
+
+  DYND_API expression operator+(const expression &op0, const array &op1);
+  DYND_API expression operator-(const expression &op0, const array &op1);
+  DYND_API expression operator*(const expression &op0, const array &op1);
+  DYND_API expression operator/(const expression &op0, const array &op1);
+
+  DYND_API expression operator+(const array &op0, const expression &op1);
+  DYND_API expression operator-(const array &op0, const expression &op1);
+  DYND_API expression operator*(const array &op0, const expression &op1);
+  DYND_API expression operator/(const array &op0, const expression &op1);
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,45 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * The most characters written by ``format_int64`` and ``format_uint64``.
+ */
+static const size_t max_format_int64_size = 20;
+
+/**
+ * The most characters written by ``format_float32`` and ``format_float64``.
+ */
+static const size_t max_format_float32_size = 22;
+static const size_t max_format_float64_size = 25;
+
+/**
+ * Writes the decimal digits of an integer to ``out``, which must have room
+ * for ``max_format_int64_size`` characters, and returns the end of what was
+ * written. No NUL terminator is written.
+ */
+DYND_API char *format_int64(char *out, int64_t value);
+DYND_API char *format_uint64(char *out, uint64_t value);
+
+/**
+ * Writes the shortest decimal representation of a floating point value which
+ * parses back to the same value, choosing the closest one when there are
+ * several, to ``out`` and returns the end of what was written. The notation
+ * is that of JavaScript, so integers below 1e21 have no fraction or exponent
+ * and very large or small values use one, as in "1e+21" or "1.5e-7". NaN and
+ * the infinities are written as "nan", "inf" and "-inf".
+ *
+ * The digits are found with the Ryu algorithm by Ulf Adams, which needs no
+ * arbitrary precision arithmetic.
+ */
+DYND_API char *format_float32(char *out, float value);
+DYND_API char *format_float64(char *out, double value);
+
+} // namespace dynd
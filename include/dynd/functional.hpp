@@ -75,6 +75,26 @@ namespace nd {
      */
     DYND_API callable compose(const callable &first, const callable &second, const ndt::type &buf_tp = ndt::type());
 
+    /**
+     * One stage of a fused expression, which applies ``child`` to the arguments
+     * at the indices in ``args``. An index below the number of arguments of the
+     * fused callable refers to that argument, and an index ``nsrc + i`` refers to
+     * the result of stage ``i``.
+     */
+    struct fuse_stage {
+      callable child;
+      std::vector<intptr_t> args;
+    };
+
+    /**
+     * Returns an elementwise callable of ``nsrc`` arguments which evaluates the
+     * stages in order, writing the result of the last one. The stages are run
+     * together over blocks of DYND_BUFFER_CHUNK_SIZE elements, so the
+     * intermediate results are never allocated in full. For example, ``a * b + c``
+     * is ``fuse(3, {{multiply, {0, 1}}, {add, {3, 2}}})``.
+     */
+    DYND_API callable fuse(size_t nsrc, const std::vector<fuse_stage> &stages);
+
     /**
      * Makes a ckernel that ignores the src values, and writes
      * constant values to the output.
@@ -158,8 +178,12 @@ namespace nd {
     /**
      * Lifts the provided callable, broadcasting it as necessary to execute
      * across the additional dimensions in the ``lifted_types`` array.
+     *
+     * \param properties  If ``associative`` is set, the reduction of a whole
+     *                    dimension may be split into ranges reduced on
+     *                    separate threads, whose partial results are merged.
      */
-    DYND_API callable reduction(const callable &identity, const callable &child);
+    DYND_API callable reduction(const callable &identity, const callable &child, callable_property properties = none);
 
     DYND_API callable where(const callable &child);
 
@@ -12,5 +12,36 @@ namespace nd {
 
   extern DYND_API callable serialize;
 
+  /**
+   * Writes an array to a binary file, which ``nd::load`` maps back into an
+   * array. The file holds the datashape, the arrmeta and the data, laid out
+   * as ``nd::empty`` would lay it out. The elements of var dims, and strings
+   * or bytes too long to be stored inline, are written to blocks of their
+   * own, and the pointers to them are stored as offsets within the file.
+   *
+   * The file is in the byte order and pointer size of the machine writing
+   * it. The array may be of any type built from fixed and var dims, structs,
+   * tuples, options, strings, bytes and types of plain data.
+   *
+   * \param filename  The name of the file to write.
+   * \param a  The array to write.
+   */
+  DYND_API void save(const std::string &filename, const array &a);
+
+  /**
+   * Loads an array written by ``nd::save``. The array views a memory map of
+   * the file, with no copy of its data. The offsets which the file holds in
+   * place of pointers are turned back into pointers within a private map,
+   * so only the pages holding them are copied.
+   *
+   * The array is read-only, unless ``options.copy_on_write`` is set and its
+   * type holds no pointers, in which case it can be written without changing
+   * the file.
+   *
+   * \param filename  The name of the file to load.
+   * \param options  How the file is memory mapped.
+   */
+  DYND_API array load(const std::string &filename, const memmap_options &options = memmap_options());
+
 } // namespace dynd::nd
 } // namespace dynd
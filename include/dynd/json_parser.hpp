@@ -5,7 +5,12 @@
 
 #pragma once
 
+#include <functional>
+#include <istream>
+#include <vector>
+
 #include <dynd/array.hpp>
+#include <dynd/parse_util.hpp>
 
 namespace dynd {
 namespace ndt {
@@ -25,11 +30,155 @@ namespace ndt {
   } // namespace dynd::ndt::json
 } // namespace dynd::ndt
 
+namespace json {
+
+  /**
+   * The first stage of the JSON parser, which finds the structural characters
+   * ``{}[]:,``, the quotes around strings and the first character of every
+   * other value, 64 bytes at a time with vector bitmasks. The parser steps over
+   * whitespace and strings with it, instead of a character at a time.
+   *
+   * The input is indexed a window at a time as the parser moves through it, so
+   * the index takes the same memory however large the input is.
+   */
+  class DYND_API structural_index {
+    const char *m_end;
+    // The indexed window, with the offsets in it of everything found
+    const char *m_window_begin, *m_window_end;
+    std::vector<uint32_t> m_offsets;
+    size_t m_noffsets, m_cursor;
+    // The state carried over from the previous 64 bytes
+    uint64_t m_prev_in_string, m_prev_escaped, m_prev_scalar;
+
+    void index_next_window();
+
+    /**
+     * Returns the first indexed position at or after ``it``, or the end.
+     */
+    const char *next(const char *it);
+
+  public:
+    static const size_t window_size = 65536;
+
+    structural_index(const char *begin, const char *end);
+
+    /**
+     * Returns the first character at or after ``it`` which is not whitespace,
+     * or the end. ``it`` must not be within a string.
+     */
+    const char *skip_whitespace(const char *it) {
+      if (it == m_end || !DYND_ISSPACE(*it)) {
+        return it;
+      }
+      if (it < m_window_begin) {
+        dynd::skip_whitespace(it, m_end);
+        return it;
+      }
+      return next(it);
+    }
+
+    /**
+     * Returns the closing quote of the string whose opening quote is at ``it``,
+     * or NULL if it has none or ``it`` is before the indexed window.
+     */
+    const char *find_string_end(const char *it);
+  };
+
+} // namespace dynd::json
+
 namespace nd {
   namespace json {
 
     DYND_API array parse2(const ndt::type &tp, const std::string &str);
 
+    /**
+     * Parses newline-delimited JSON, encoded as UTF-8, which has a value of type
+     * ``tp`` on every line that is not blank, into an array of type ``var * tp``.
+     * The type may also be given as ``var * tp``.
+     *
+     * The buffer is split into chunks of whole lines, which are parsed on up to
+     * ``ectx->nthreads`` threads, each straight into its part of the result.
+     * Elements which have variable-sized dimensions are parsed on one thread.
+     *
+     * \param tp  The type of the value on every line.
+     * \param json_begin  The beginning of the UTF-8 buffer containing the JSON.
+     * \param json_end  One past the end of the UTF-8 buffer containing the JSON.
+     * \param ectx  An evaluation context.
+     */
+    DYND_API array parse_lines(const ndt::type &tp, const char *json_begin, const char *json_end,
+                               const eval::eval_context *ectx = &eval::default_eval_context);
+
+    /**
+     * Parses newline-delimited JSON from a string or a bytes array, such as a
+     * memory mapped file. Bytes are assumed to be UTF-8.
+     */
+    DYND_API array parse_lines(const ndt::type &tp, const array &json,
+                               const eval::eval_context *ectx = &eval::default_eval_context);
+
+    inline array parse_lines(const ndt::type &tp, const std::string &json,
+                             const eval::eval_context *ectx = &eval::default_eval_context) {
+      return parse_lines(tp, json.data(), json.data() + json.size(), ectx);
+    }
+
+    inline array parse_lines(const ndt::type &tp, const char *json,
+                             const eval::eval_context *ectx = &eval::default_eval_context) {
+      return parse_lines(tp, json, json + strlen(json), ectx);
+    }
+
+    /**
+     * Parses a JSON array, whose elements have type ``tp``, as its text is read
+     * a chunk at a time, returning the elements in batches. Only the text of the
+     * batch being parsed is kept, so the memory used depends on the batch size
+     * rather than on the size of the input.
+     */
+    class DYND_API stream_parser {
+      enum state { before_array, array_begin, in_element, after_array };
+
+      ndt::type m_tp;
+      std::function<size_t(char *, size_t)> m_read;
+      intptr_t m_batch_size;
+      const eval::eval_context *m_ectx;
+
+      // The text read but not yet parsed, where the next element starts in it,
+      // and how much of it has been scanned for the ends of elements
+      std::vector<char> m_buffer;
+      size_t m_begin, m_scanned;
+      bool m_eof;
+      // The line and column where the buffer starts, for error messages
+      int m_line, m_column;
+
+      // The state of the scan, which carries over from one chunk to the next
+      state m_state;
+      intptr_t m_depth;
+      bool m_in_string, m_escaped;
+      // The offsets of the commas and the bracket which end the elements found
+      std::vector<size_t> m_element_ends;
+
+      bool read_chunk();
+      void scan();
+      void consume(size_t size);
+
+    public:
+      static const size_t chunk_size = 65536;
+
+      /**
+       * Parses the text returned by ``read``, which fills a buffer of the given
+       * size and returns how much it filled, or 0 once there is no more.
+       */
+      stream_parser(const ndt::type &tp, const std::function<size_t(char *, size_t)> &read, intptr_t batch_size = 1024,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+      stream_parser(const ndt::type &tp, std::istream &in, intptr_t batch_size = 1024,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+      /**
+       * Parses the next batch of up to ``batch_size`` elements into ``out``, as
+       * an array of type ``var * tp``. Returns false, leaving ``out`` alone, once
+       * every element has been returned.
+       */
+      bool next(array &out);
+    };
+
   } // namespace dynd::nd::json
 } // namespace dynd::nd
 
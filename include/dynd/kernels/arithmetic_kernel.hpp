@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/simd.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Kernel for a binary arithmetic operator. When the destination is contiguous, and
+   * each source is either contiguous or broadcast, the strided loop runs without the
+   * per-element call, and uses the vectorized loop for the instruction set detected
+   * at runtime if there is one for these types.
+   */
+  template <template <typename, typename> class FuncType, simd::binary_op Op, typename Arg0Type, typename Arg1Type>
+  struct arithmetic_kernel : base_strided_kernel<arithmetic_kernel<FuncType, Op, Arg0Type, Arg1Type>, 2> {
+    typedef decltype(FuncType<Arg0Type, Arg1Type>::f(std::declval<Arg0Type>(), std::declval<Arg1Type>())) dst_type;
+
+    simd::binary_loop_t m_loop;
+
+    arithmetic_kernel()
+        : m_loop(get_loop(std::integral_constant<bool, std::is_same<dst_type, Arg0Type>::value &&
+                                                           std::is_same<dst_type, Arg1Type>::value>())) {}
+
+    // The vectorized loops only exist for operands of the same type as the result
+    static simd::binary_loop_t get_loop(std::true_type) {
+      return simd::get_binary_loop(Op, ndt::id_of<dst_type>::value);
+    }
+
+    static simd::binary_loop_t get_loop(std::false_type) { return NULL; }
+
+    void single(char *dst, char *const *src) {
+      *reinterpret_cast<dst_type *>(dst) = FuncType<Arg0Type, Arg1Type>::f(*reinterpret_cast<Arg0Type *>(src[0]),
+                                                                          *reinterpret_cast<Arg1Type *>(src[1]));
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      if (dst_stride == sizeof(dst_type) && (src_stride[0] == sizeof(Arg0Type) || src_stride[0] == 0) &&
+          (src_stride[1] == sizeof(Arg1Type) || src_stride[1] == 0)) {
+        if (m_loop != NULL) {
+          m_loop(dst, src, src_stride, count);
+          return;
+        }
+
+        dst_type *d = reinterpret_cast<dst_type *>(dst);
+        const Arg0Type *s0 = reinterpret_cast<const Arg0Type *>(src[0]);
+        const Arg1Type *s1 = reinterpret_cast<const Arg1Type *>(src[1]);
+        if (src_stride[0] != 0 && src_stride[1] != 0) {
+          for (size_t i = 0; i < count; ++i) {
+            d[i] = FuncType<Arg0Type, Arg1Type>::f(s0[i], s1[i]);
+          }
+          return;
+        }
+        if (src_stride[0] == 0 && src_stride[1] != 0) {
+          const Arg0Type a = *s0;
+          for (size_t i = 0; i < count; ++i) {
+            d[i] = FuncType<Arg0Type, Arg1Type>::f(a, s1[i]);
+          }
+          return;
+        }
+        if (src_stride[0] != 0 && src_stride[1] == 0) {
+          const Arg1Type b = *s1;
+          for (size_t i = 0; i < count; ++i) {
+            d[i] = FuncType<Arg0Type, Arg1Type>::f(s0[i], b);
+          }
+          return;
+        }
+      }
+
+      base_strided_kernel<arithmetic_kernel, 2>::strided(dst, dst_stride, src, src_stride, count);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
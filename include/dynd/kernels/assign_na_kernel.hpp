@@ -134,12 +134,12 @@ namespace nd {
   };
 
   template <>
-  struct assign_na_kernel<bytes> : base_strided_kernel<assign_na_kernel<bytes>, 1> {
+  struct assign_na_kernel<bytes> : base_strided_kernel<assign_na_kernel<bytes>, 0> {
     void single(char *res, char *const *DYND_UNUSED(args)) { reinterpret_cast<bytes *>(res)->clear(); }
   };
 
   template <>
-  struct assign_na_kernel<string> : base_strided_kernel<assign_na_kernel<string>, 1> {
+  struct assign_na_kernel<string> : base_strided_kernel<assign_na_kernel<string>, 0> {
     void single(char *res, char *const *DYND_UNUSED(args)) { reinterpret_cast<bytes *>(res)->clear(); }
   };
 
@@ -1007,13 +1007,15 @@ namespace nd {
         : base_strided_kernel<assignment_kernel<string, ndt::fixed_string_type, ErrorMode>, 1> {
       string_encoding_t m_dst_encoding, m_src_encoding;
       intptr_t m_src_element_size;
+      transcode_unicode_t m_transcode_fn;
       next_unicode_codepoint_t m_next_fn;
       append_unicode_codepoint_t m_append_fn;
 
       assignment_kernel(string_encoding_t dst_encoding, string_encoding_t src_encoding, intptr_t src_element_size,
                         next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn)
           : m_dst_encoding(dst_encoding), m_src_encoding(src_encoding), m_src_element_size(src_element_size),
-            m_next_fn(next_fn), m_append_fn(append_fn) {}
+            m_transcode_fn(get_transcode_unicode_function(src_encoding, dst_encoding)), m_next_fn(next_fn),
+            m_append_fn(append_fn) {}
 
       void single(char *dst, char *const *src) {
         dynd::string *dst_d = reinterpret_cast<dynd::string *>(dst);
@@ -1022,6 +1024,7 @@ namespace nd {
         char *dst_current;
         const char *src_begin = src[0];
         const char *src_end = src[0] + m_src_element_size;
+        transcode_unicode_t transcode_fn = m_transcode_fn;
         next_unicode_codepoint_t next_fn = m_next_fn;
         append_unicode_codepoint_t append_fn = m_append_fn;
         uint32_t cp;
@@ -1033,20 +1036,24 @@ namespace nd {
 
         dst_current = dst_begin;
         while (src_begin < src_end) {
+          // Convert as much as possible in bulk, then the code point it stopped at
+          transcode_fn(src_begin, src_end, dst_current, dst_end);
+          if (src_begin == src_end) {
+            break;
+          }
+
+          // Increase the allocated memory as necessary
+          if (dst_end - dst_current < 8) {
+            char *dst_begin_saved = dst_begin;
+            dst_d->resize(2 * (dst_end - dst_begin));
+            dst_begin = dst_d->begin();
+            dst_end = dst_d->end();
+            dst_current = dst_begin + (dst_current - dst_begin_saved);
+          }
+
           cp = next_fn(src_begin, src_end);
-          // Append the codepoint, or increase the allocated memory as necessary
           if (cp != 0) {
-            if (dst_end - dst_current >= 8) {
-              append_fn(cp, dst_current, dst_end);
-            } else {
-              char *dst_begin_saved = dst_begin;
-              dst_d->resize(2 * (dst_end - dst_begin));
-              dst_begin = dst_d->begin();
-              dst_end = dst_d->end();
-              dst_current = dst_begin + (dst_current - dst_begin_saved);
-
-              append_fn(cp, dst_current, dst_end);
-            }
+            append_fn(cp, dst_current, dst_end);
           } else {
             break;
           }
@@ -1295,25 +1302,34 @@ namespace nd {
     template <assign_error_mode ErrorMode>
     struct assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, ErrorMode>
         : base_strided_kernel<assignment_kernel<ndt::fixed_string_type, ndt::fixed_string_type, ErrorMode>, 1> {
+      transcode_unicode_t m_transcode_fn;
       next_unicode_codepoint_t m_next_fn;
       append_unicode_codepoint_t m_append_fn;
       intptr_t m_dst_data_size, m_src_data_size;
       bool m_overflow_check;
 
-      assignment_kernel(next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn, intptr_t dst_data_size,
-                        intptr_t src_data_size, bool overflow_check)
-          : m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size), m_src_data_size(src_data_size),
-            m_overflow_check(overflow_check) {}
+      assignment_kernel(transcode_unicode_t transcode_fn, next_unicode_codepoint_t next_fn,
+                        append_unicode_codepoint_t append_fn, intptr_t dst_data_size, intptr_t src_data_size,
+                        bool overflow_check)
+          : m_transcode_fn(transcode_fn), m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size),
+            m_src_data_size(src_data_size), m_overflow_check(overflow_check) {}
 
       void single(char *dst, char *const *src) {
         char *dst_end = dst + m_dst_data_size;
         const char *src_end = src[0] + m_src_data_size;
+        transcode_unicode_t transcode_fn = m_transcode_fn;
         next_unicode_codepoint_t next_fn = m_next_fn;
         append_unicode_codepoint_t append_fn = m_append_fn;
         uint32_t cp = 0;
 
         char *src_copy = src[0];
         while (src_copy < src_end && dst < dst_end) {
+          // Convert as much as possible in bulk, then the code point it stopped at
+          transcode_fn(const_cast<const char *&>(src_copy), src_end, dst, dst_end);
+          if (src_copy == src_end || dst == dst_end) {
+            break;
+          }
+
           cp = next_fn(const_cast<const char *&>(src_copy), src_end);
           // The fixed_string type uses null-terminated strings
           if (cp == 0) {
@@ -1357,14 +1373,15 @@ namespace nd {
     template <assign_error_mode ErrorMode>
     struct assignment_kernel<ndt::fixed_string_type, string, ErrorMode>
         : base_strided_kernel<assignment_kernel<ndt::fixed_string_type, string, ErrorMode>, 1> {
+      transcode_unicode_t m_transcode_fn;
       next_unicode_codepoint_t m_next_fn;
       append_unicode_codepoint_t m_append_fn;
       intptr_t m_dst_data_size;
       bool m_overflow_check;
 
-      assignment_kernel(next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn, intptr_t dst_data_size,
-                        bool overflow_check)
-          : m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size),
+      assignment_kernel(transcode_unicode_t transcode_fn, next_unicode_codepoint_t next_fn,
+                        append_unicode_codepoint_t append_fn, intptr_t dst_data_size, bool overflow_check)
+          : m_transcode_fn(transcode_fn), m_next_fn(next_fn), m_append_fn(append_fn), m_dst_data_size(dst_data_size),
             m_overflow_check(overflow_check) {}
 
       void single(char *dst, char *const *src) {
@@ -1372,11 +1389,18 @@ namespace nd {
         const dynd::string *src_d = reinterpret_cast<const dynd::string *>(src[0]);
         const char *src_begin = src_d->begin();
         const char *src_end = src_d->end();
+        transcode_unicode_t transcode_fn = m_transcode_fn;
         next_unicode_codepoint_t next_fn = m_next_fn;
         append_unicode_codepoint_t append_fn = m_append_fn;
         uint32_t cp;
 
         while (src_begin < src_end && dst < dst_end) {
+          // Convert as much as possible in bulk, then the code point it stopped at
+          transcode_fn(src_begin, src_end, dst, dst_end);
+          if (src_begin == src_end || dst == dst_end) {
+            break;
+          }
+
           cp = next_fn(src_begin, src_end);
           append_fn(cp, dst, dst_end);
         }
@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/sort_kernel.hpp>
 
 namespace dynd {
 namespace nd {
@@ -53,5 +56,172 @@ namespace nd {
     }
   };
 
+  /**
+   * A kernel which finds where each of a strided dimension of needles goes in
+   * a sorted strided dimension of integers or floating point values, in the
+   * order of ``nd::sort``. Each index is the first one whose value is not less
+   * than the needle, or with ``right``, the first one whose value is greater.
+   *
+   * Each needle is found with a branchless binary search. Needles which are
+   * sorted themselves start their search where the previous one ended, and
+   * when there are enough of them, the two dimensions are merged instead.
+   */
+  template <typename T>
+  struct searchsorted_kernel : base_strided_kernel<searchsorted_kernel<T>, 2> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t src1_size;
+    const intptr_t src1_stride;
+    const intptr_t dst_stride;
+    const bool right;
+
+    searchsorted_kernel(intptr_t src0_size, intptr_t src0_stride, intptr_t src1_size, intptr_t src1_stride,
+                        intptr_t dst_stride, bool right)
+        : src0_size(src0_size), src0_stride(src0_stride), src1_size(src1_size), src1_stride(src1_stride),
+          dst_stride(dst_stride), right(right) {}
+
+    T value_at(const char *src0, intptr_t i) const { return *reinterpret_cast<const T *>(src0 + i * src0_stride); }
+
+    /**
+     * Whether the value ``lhs`` goes before a needle ``rhs`` which is not NaN.
+     * A NaN value, which is sorted last, never does.
+     */
+    template <bool Right>
+    static bool before(T lhs, T rhs) {
+      return Right ? lhs <= rhs : lhs < rhs;
+    }
+
+    /**
+     * The first index in [first, last) whose value the needle goes before.
+     */
+    template <bool Right>
+    intptr_t search(const char *src0, intptr_t first, intptr_t last, T needle) const {
+      intptr_t size = last - first;
+      if (size == 0) {
+        return first;
+      }
+
+      // The loop only narrows the range, so it does not branch on the comparison
+      while (size > 1) {
+        intptr_t half = size / 2;
+        intptr_t next_half = (size - half) / 2;
+        DYND_PREFETCH(src0 + (first + next_half) * src0_stride);
+        DYND_PREFETCH(src0 + (first + half + next_half) * src0_stride);
+        first = before<Right>(value_at(src0, first + half), needle) ? first + half : first;
+        size -= half;
+      }
+
+      return first + before<Right>(value_at(src0, first), needle);
+    }
+
+    /**
+     * Where a NaN needle goes, which is before the NaN values on the left.
+     */
+    template <bool Right>
+    intptr_t search_nan(const char *src0) const {
+      if (Right) {
+        return src0_size;
+      }
+
+      intptr_t first = 0, size = src0_size;
+      while (size > 0) {
+        intptr_t half = size / 2;
+        T value = value_at(src0, first + half);
+        if (value == value) {
+          first += half + 1;
+          size -= half + 1;
+        } else {
+          size = half;
+        }
+      }
+      return first;
+    }
+
+    template <bool Right>
+    void search_all(char *dst, const char *src0, const char *src1) {
+      // The needles count as sorted in the order of nd::sort, with NaNs last
+      bool sorted = true;
+      for (intptr_t j = 1; j < src1_size && sorted; ++j) {
+        sorted = detail::radix_key<T>::from(*reinterpret_cast<const T *>(src1 + (j - 1) * src1_stride)) <=
+                 detail::radix_key<T>::from(*reinterpret_cast<const T *>(src1 + j * src1_stride));
+      }
+
+      intptr_t first = 0;
+      for (intptr_t j = 0; j < src1_size; ++j, src1 += src1_stride, dst += dst_stride) {
+        T needle = *reinterpret_cast<const T *>(src1);
+        intptr_t i;
+        if (needle != needle) {
+          i = search_nan<Right>(src0);
+        } else if (sorted && src0_size <= 8 * src1_size) {
+          // A merge of the two dimensions reads each value once
+          for (i = first; i < src0_size && before<Right>(value_at(src0, i), needle); ++i) {
+          }
+        } else {
+          i = search<Right>(src0, sorted ? first : 0, src0_size, needle);
+        }
+
+        *reinterpret_cast<intptr_t *>(dst) = i;
+        if (sorted) {
+          first = i;
+        }
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      if (right) {
+        search_all<true>(dst, src[0], src[1]);
+      } else {
+        search_all<false>(dst, src[0], src[1]);
+      }
+    }
+  };
+
+  /**
+   * A kernel which finds where each of a strided dimension of needles goes in
+   * a sorted strided dimension, like ``searchsorted_kernel``, comparing the
+   * values with the child kernel, which is ``less``.
+   */
+  struct searchsorted_less_kernel : base_strided_kernel<searchsorted_less_kernel, 2> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t src1_size;
+    const intptr_t src1_stride;
+    const intptr_t dst_stride;
+    const bool right;
+
+    searchsorted_less_kernel(intptr_t src0_size, intptr_t src0_stride, intptr_t src1_size, intptr_t src1_stride,
+                             intptr_t dst_stride, bool right)
+        : src0_size(src0_size), src0_stride(src0_stride), src1_size(src1_size), src1_stride(src1_stride),
+          dst_stride(dst_stride), right(right) {}
+
+    ~searchsorted_less_kernel() { get_child()->destroy(); }
+
+    void single(char *dst, char *const *src) {
+      kernel_prefix *child = get_child();
+      auto less = [child](char *lhs, char *rhs) {
+        bool1 res;
+        char *child_src[2] = {lhs, rhs};
+        child->single(reinterpret_cast<char *>(&res), child_src);
+        return static_cast<bool>(res);
+      };
+
+      char *needle = src[1];
+      for (intptr_t j = 0; j < src1_size; ++j, needle += src1_stride, dst += dst_stride) {
+        intptr_t first = 0, size = src0_size;
+        while (size > 0) {
+          intptr_t half = size / 2;
+          char *trial = src[0] + (first + half) * src0_stride;
+          if (right ? !less(needle, trial) : less(trial, needle)) {
+            first += half + 1;
+            size -= half + 1;
+          } else {
+            size = half;
+          }
+        }
+        *reinterpret_cast<intptr_t *>(dst) = first;
+      }
+    }
+  };
+
 } // namespace dynd::nd
 } // namespace dynd
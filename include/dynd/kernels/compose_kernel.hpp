@@ -5,7 +5,7 @@
 
 #pragma once
 
-#include <dynd/arrmeta_holder.hpp>
+#include <dynd/array.hpp>
 #include <dynd/callable.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/convert_kernel.hpp>
@@ -15,21 +15,27 @@ namespace nd {
   namespace functional {
 
     /**
-     * A kernel for chaining two other kernels, using temporary buffers
-     * dynamically allocated on the heap.
+     * A kernel for chaining two other kernels, through a temporary buffer of
+     * DYND_BUFFER_CHUNK_SIZE elements which is allocated once with the kernel
+     * and reused by every call.
      */
     // All methods are inlined, so this does not need to be declared DYND_API.
     struct compose_kernel : base_strided_kernel<compose_kernel, 1> {
       intptr_t second_offset; // The offset to the second child kernel
       ndt::type buffer_tp;
-      arrmeta_holder buffer_arrmeta;
-      std::vector<intptr_t> buffer_shape;
-
-      compose_kernel(const ndt::type &buffer_tp) : buffer_tp(buffer_tp)
+      array buffer;
+      intptr_t buffer_stride;
+      // Whether the elements of the buffer hold references or resources which must be released
+      bool reset;
+      // The number of elements written since the buffer was last reset
+      size_t used;
+
+      compose_kernel(const ndt::type &buffer_tp)
+          : buffer_tp(buffer_tp), buffer(empty(DYND_BUFFER_CHUNK_SIZE, buffer_tp)),
+            buffer_stride(reinterpret_cast<const fixed_dim_type_arrmeta *>(buffer->metadata())->stride),
+            reset((buffer_tp.get_flags() & (type_flag_blockref | type_flag_zeroinit | type_flag_destructor)) != 0),
+            used(0)
       {
-        arrmeta_holder(this->buffer_tp).swap(buffer_arrmeta);
-        buffer_arrmeta.arrmeta_default_construct(true);
-        buffer_shape.push_back(DYND_BUFFER_CHUNK_SIZE);
       }
 
       ~compose_kernel()
@@ -40,10 +46,34 @@ namespace nd {
         get_child(second_offset)->destroy();
       }
 
+      /**
+       * The arrmeta of one element of the buffer.
+       */
+      const char *get_buffer_arrmeta() const { return buffer->metadata() + sizeof(fixed_dim_type_arrmeta); }
+
+      /**
+       * Returns the buffer to its freshly allocated state, releasing whatever
+       * the elements written since the last reset hold.
+       */
+      void reset_buffer()
+      {
+        if (reset && used != 0) {
+          if (buffer_tp.get_flags() & type_flag_blockref) {
+            reset_strided_buffer_array(buffer);
+          }
+          else {
+            if (buffer_tp.get_flags() & type_flag_destructor) {
+              buffer_tp.extended()->data_destruct_strided(get_buffer_arrmeta(), buffer.data(), buffer_stride, used);
+            }
+            memset(buffer.data(), 0, used * buffer_stride);
+          }
+        }
+        used = 0;
+      }
+
       void single(char *dst, char *const *src)
       {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_tp);
+        reset_buffer();
         char *buffer_data = buffer.data();
 
         kernel_prefix *first = get_child();
@@ -52,16 +82,14 @@ namespace nd {
         kernel_prefix *second = get_child(second_offset);
         kernel_single_t second_func = second->get_function<kernel_single_t>();
 
+        used = 1;
         first_func(first, buffer_data, src);
         second_func(second, dst, &buffer_data);
       }
 
       void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
       {
-        // Allocate a temporary buffer on the heap
-        array buffer = empty(buffer_shape[0], buffer_tp);
         char *buffer_data = buffer.data();
-        intptr_t buffer_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(buffer.get()->metadata())->stride;
 
         kernel_prefix *first = get_child();
         kernel_strided_t first_func = first->get_function<kernel_strided_t>();
@@ -72,17 +100,14 @@ namespace nd {
         char *src0 = src[0];
         intptr_t src0_stride = src_stride[0];
 
-        size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
-        first_func(first, buffer_data, buffer_stride, &src0, src_stride, chunk_size);
-        second_func(second, dst, dst_stride, &buffer_data, &buffer_stride, chunk_size);
-        count -= chunk_size;
         while (count) {
-          src0 += chunk_size * src0_stride;
-          dst += chunk_size * dst_stride;
-          reset_strided_buffer_array(buffer);
-          chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+          reset_buffer();
+          size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+          used = chunk_size;
           first_func(first, buffer_data, buffer_stride, &src0, src_stride, chunk_size);
           second_func(second, dst, dst_stride, &buffer_data, &buffer_stride, chunk_size);
+          src0 += chunk_size * src0_stride;
+          dst += chunk_size * dst_stride;
           count -= chunk_size;
         }
       }
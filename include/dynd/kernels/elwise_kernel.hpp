@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <array>
+
 #include <dynd/callable.hpp>
 #include <dynd/kernels/base_kernel.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
 namespace nd {
@@ -77,6 +80,99 @@ namespace nd {
       }
     };
 
+    /**
+     * Expr kernel for two nested strided dimensions which the operands disagree
+     * on the order of, for example when copying a transposed array. The
+     * dimensions are visited in square tiles of DYND_TILE_SIZE elements a side,
+     * so that every operand touches only a few cache lines and pages in each tile,
+     * and the child runs along the inner dimension of a tile.
+     */
+    template <size_t N>
+    struct tiled_elwise_kernel : base_strided_kernel<tiled_elwise_kernel<N>, N> {
+      typedef tiled_elwise_kernel self_type;
+
+      intptr_t m_size[2];
+      intptr_t m_dst_stride[2];
+      std::array<intptr_t, N> m_src_stride[2];
+
+      tiled_elwise_kernel(intptr_t outer_size, intptr_t outer_dst_stride, const intptr_t *outer_src_stride,
+                          intptr_t inner_size, intptr_t inner_dst_stride, const intptr_t *inner_src_stride)
+          : m_size{outer_size, inner_size}, m_dst_stride{outer_dst_stride, inner_dst_stride} {
+        std::copy(outer_src_stride, outer_src_stride + N, m_src_stride[0].begin());
+        std::copy(inner_src_stride, inner_src_stride + N, m_src_stride[1].begin());
+      }
+
+      ~tiled_elwise_kernel() { this->get_child()->destroy(); }
+
+      void single(char *dst, char *const *src) {
+        kernel_prefix *child = this->get_child();
+        kernel_strided_t opchild = child->get_function<kernel_strided_t>();
+
+        std::array<char *, N> row_src;
+        for (intptr_t i0 = 0; i0 < m_size[0]; i0 += DYND_TILE_SIZE) {
+          intptr_t i_end = std::min<intptr_t>(i0 + DYND_TILE_SIZE, m_size[0]);
+          for (intptr_t j0 = 0; j0 < m_size[1]; j0 += DYND_TILE_SIZE) {
+            intptr_t count = std::min<intptr_t>(DYND_TILE_SIZE, m_size[1] - j0);
+            for (intptr_t i = i0; i < i_end; ++i) {
+              for (size_t k = 0; k < N; ++k) {
+                row_src[k] = src[k] + i * m_src_stride[0][k] + j0 * m_src_stride[1][k];
+              }
+              opchild(child, dst + i * m_dst_stride[0] + j0 * m_dst_stride[1], m_dst_stride[1], row_src.data(),
+                      m_src_stride[1].data(), count);
+            }
+          }
+        }
+      }
+    };
+
+    /**
+     * Expr kernel for an outermost strided dimension which splits the
+     * dimension into contiguous ranges and runs them concurrently on the
+     * library's thread pool. The first range runs through the child kernel
+     * that follows this one, every other range through its own copy of the
+     * child, instantiated from the same call graph node, so no child kernel
+     * is ever shared between threads.
+     */
+    template <size_t N>
+    struct parallel_elwise_kernel : base_strided_kernel<parallel_elwise_kernel<N>, N> {
+      typedef parallel_elwise_kernel self_type;
+
+      intptr_t m_size;
+      intptr_t m_dst_stride;
+      std::array<intptr_t, N> m_src_stride;
+      size_t m_nchunks;
+      // The children for every range but the first
+      kernel_builder **m_clones;
+
+      parallel_elwise_kernel(intptr_t size, intptr_t dst_stride, const intptr_t *src_stride, size_t nchunks)
+          : m_size(size), m_dst_stride(dst_stride), m_nchunks(nchunks), m_clones(new kernel_builder *[nchunks - 1]()) {
+        std::copy(src_stride, src_stride + N, m_src_stride.begin());
+      }
+
+      ~parallel_elwise_kernel() {
+        this->get_child()->destroy();
+        for (size_t i = 0; i < m_nchunks - 1; ++i) {
+          delete m_clones[i];
+        }
+        delete[] m_clones;
+      }
+
+      void single(char *dst, char *const *src) {
+        thread_pool::get().parallel_for(m_nchunks, [this, dst, src](size_t i) {
+          intptr_t begin = m_size * i / m_nchunks;
+          intptr_t end = m_size * (i + 1) / m_nchunks;
+
+          std::array<char *, N> chunk_src;
+          for (size_t j = 0; j < N; ++j) {
+            chunk_src[j] = src[j] + begin * m_src_stride[j];
+          }
+
+          kernel_prefix *child = (i == 0) ? this->get_child() : m_clones[i - 1]->get();
+          child->strided(dst + begin * m_dst_stride, m_dst_stride, chunk_src.data(), m_src_stride.data(), end - begin);
+        });
+      }
+    };
+
     /**
      * Generic expr kernel + destructor for a strided/var dimensions with
      * a fixed number of src operands, outputing to a strided dimension.
@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/convert_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * A kernel for a chain of elementwise stages, which passes blocks of
+     * DYND_BUFFER_CHUNK_SIZE elements through every stage in turn. The result of
+     * each stage but the last goes to a buffer of one block, allocated with the
+     * kernel, so intermediate results are never materialized in full. A buffer
+     * is reused by a later stage of the same type once its last reader has run.
+     */
+    // All methods are inlined, so this does not need to be declared DYND_API.
+    struct fuse_kernel : base_strided_kernel<fuse_kernel> {
+      size_t nsrc;
+      // The arguments of every stage, indexing the sources then the buffers
+      std::vector<std::vector<intptr_t>> args;
+      // The offsets to the child kernels of every stage
+      std::vector<intptr_t> offsets;
+      // The buffer written by every stage but the last
+      std::vector<size_t> slots;
+      std::vector<array> buffers;
+      std::vector<intptr_t> buffer_strides;
+      // Whether some buffer needs to be reset between blocks
+      bool reset;
+      // Scratch space for the arguments of a child, and the sources of the current block
+      std::vector<char *> child_src;
+      std::vector<intptr_t> child_src_stride;
+      std::vector<char *> block_src;
+      std::vector<intptr_t> zero_stride;
+
+      fuse_kernel(size_t nsrc, const std::vector<std::vector<intptr_t>> &args, const std::vector<ndt::type> &buffer_tp)
+          : nsrc(nsrc), args(args), offsets(args.size()), reset(false), block_src(nsrc), zero_stride(nsrc) {
+        size_t max_narg = 0;
+        for (const std::vector<intptr_t> &stage_args : args) {
+          max_narg = std::max(max_narg, stage_args.size());
+        }
+        child_src.resize(max_narg);
+        child_src_stride.resize(max_narg);
+
+        // The last stage which reads the result of every stage
+        std::vector<size_t> last_use(buffer_tp.size());
+        for (size_t i = 0; i < buffer_tp.size(); ++i) {
+          last_use[i] = i;
+        }
+        for (size_t i = 0; i < args.size(); ++i) {
+          for (intptr_t j : args[i]) {
+            if (j >= static_cast<intptr_t>(nsrc)) {
+              last_use[j - nsrc] = i;
+            }
+          }
+        }
+
+        // Only buffers of plain data are shared, so that nothing is written over a value which needs destruction
+        std::vector<ndt::type> slot_tp;
+        std::vector<size_t> free_slots;
+        for (size_t i = 0; i < buffer_tp.size(); ++i) {
+          auto it = std::find_if(free_slots.begin(), free_slots.end(),
+                                 [&](size_t slot) { return slot_tp[slot] == buffer_tp[i]; });
+          if (it == free_slots.end()) {
+            slot_tp.push_back(buffer_tp[i]);
+            slots.push_back(buffers.size());
+            buffers.push_back(empty(DYND_BUFFER_CHUNK_SIZE, buffer_tp[i]));
+            buffer_strides.push_back(
+                reinterpret_cast<const fixed_dim_type_arrmeta *>(buffers.back()->metadata())->stride);
+            if ((buffer_tp[i].get_flags() & (type_flag_blockref | type_flag_zeroinit | type_flag_destructor)) != 0) {
+              reset = true;
+            }
+          } else {
+            slots.push_back(*it);
+            free_slots.erase(it);
+          }
+
+          // Release the buffers whose last reader is this stage, after its own was taken
+          for (size_t j = 0; j <= i; ++j) {
+            if (last_use[j] == i && (buffer_tp[j].get_flags() & (type_flag_blockref | type_flag_destructor)) == 0) {
+              free_slots.push_back(slots[j]);
+            }
+          }
+        }
+      }
+
+      ~fuse_kernel() {
+        for (intptr_t offset : offsets) {
+          get_child(offset)->destroy();
+        }
+      }
+
+      /**
+       * The arrmeta of one element of the buffer for stage ``i``.
+       */
+      const char *get_buffer_arrmeta(size_t i) const {
+        return buffers[slots[i]]->metadata() + sizeof(fixed_dim_type_arrmeta);
+      }
+
+      void call(array *dst, const array *src) {
+        for (size_t i = 0; i < nsrc; ++i) {
+          block_src[i] = const_cast<char *>(src[i].cdata());
+        }
+        run(const_cast<char *>(dst->cdata()), 0, block_src.data(), zero_stride.data(), 1);
+      }
+
+      void single(char *dst, char *const *src) {
+        std::copy(src, src + nsrc, block_src.begin());
+        run(dst, 0, block_src.data(), zero_stride.data(), 1);
+      }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        std::copy(src, src + nsrc, block_src.begin());
+
+        size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+        run(dst, dst_stride, block_src.data(), src_stride, chunk_size);
+        count -= chunk_size;
+        while (count) {
+          for (size_t i = 0; i < nsrc; ++i) {
+            block_src[i] += chunk_size * src_stride[i];
+          }
+          dst += chunk_size * dst_stride;
+          if (reset) {
+            for (const array &buffer : buffers) {
+              reset_strided_buffer_array(buffer);
+            }
+          }
+          chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+          run(dst, dst_stride, block_src.data(), src_stride, chunk_size);
+          count -= chunk_size;
+        }
+      }
+
+      /**
+       * Runs one block of at most DYND_BUFFER_CHUNK_SIZE elements through every stage.
+       */
+      void run(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        size_t last = args.size() - 1;
+        for (size_t i = 0; i <= last; ++i) {
+          const std::vector<intptr_t> &stage_args = args[i];
+          for (size_t j = 0; j < stage_args.size(); ++j) {
+            intptr_t k = stage_args[j];
+            if (k < static_cast<intptr_t>(nsrc)) {
+              child_src[j] = src[k];
+              child_src_stride[j] = src_stride[k];
+            } else {
+              size_t slot = slots[k - nsrc];
+              child_src[j] = buffers[slot].data();
+              child_src_stride[j] = buffer_strides[slot];
+            }
+          }
+
+          kernel_prefix *child = get_child(offsets[i]);
+          if (i == last) {
+            child->strided(dst, dst_stride, child_src.data(), child_src_stride.data(), count);
+          } else {
+            child->strided(buffers[slots[i]].data(), buffer_strides[slots[i]], child_src.data(), child_src_stride.data(),
+                           count);
+          }
+        }
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -26,12 +26,18 @@ namespace nd {
     call_node *m_call;
 
   public:
-    kernel_builder(call_node *call = nullptr) : m_call(call) {}
+    kernel_builder(call_node *call = nullptr, storage_arena *arena = NULL)
+        : storagebuf<kernel_prefix, kernel_builder>(arena), m_call(call) {}
 
     DYND_API void destroy();
 
     ~kernel_builder() { destroy(); }
 
+    /**
+     * The call graph node that will be instantiated next.
+     */
+    call_node *get_call() const { return m_call; }
+
     template <typename KernelType, typename... ArgTypes>
     void emplace_back(ArgTypes &&... args) {
       storagebuf<kernel_prefix, kernel_builder>::emplace_back<KernelType>(std::forward<ArgTypes>(args)...);
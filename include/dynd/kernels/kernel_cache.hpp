@@ -0,0 +1,180 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dynd/callables/call_graph.hpp>
+#include <dynd/kernels/kernel_builder.hpp>
+#include <dynd/type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  class array;
+  class base_callable;
+
+  /**
+   * A least recently used cache of the kernels instantiated by ``base_callable::call``,
+   * so that calling a callable repeatedly with the same types, shapes and strides does
+   * not resolve and instantiate it every time.
+   *
+   * Only calls whose arguments and result hold no references or destructors are
+   * cached, since the arrmeta of those is just sizes and strides, and the keyword
+   * arguments must be scalars or fixed dimensions of builtin types, which are compared
+   * by value. The evaluation context and instruction set in effect are part of the key.
+   *
+   * A kernel is taken out of the cache while it runs, so that concurrent and recursive
+   * calls each get their own, and is dropped if it throws.
+   */
+  class DYND_API kernel_cache {
+  public:
+    struct key_type {
+      const base_callable *callable;
+      kernel_request_t kernreq;
+      std::vector<ndt::type> types;
+      // The arrmeta, keyword argument data and evaluation settings
+      std::string bytes;
+      size_t hash;
+
+      bool operator==(const key_type &rhs) const {
+        return hash == rhs.hash && callable == rhs.callable && kernreq == rhs.kernreq && bytes == rhs.bytes &&
+               types == rhs.types;
+      }
+    };
+
+    struct entry_type {
+      ndt::type dst_tp;
+      // The call graph is kept because kernels may refer to data it owns
+      call_graph cg;
+      // Where the storage of the call graph and the kernel comes from, or NULL for the heap
+      storage_arena *arena;
+      // Kernels may keep pointers to the arrmeta they were instantiated with, so
+      // they are instantiated with copies owned by the entry
+      std::unique_ptr<char[]> dst_arrmeta;
+      std::vector<std::unique_ptr<char[]>> src_arrmeta;
+      std::vector<const char *> src_arrmeta_ptrs;
+      std::unique_ptr<kernel_builder> kb;
+
+      /**
+       * An entry whose storage comes from ``arena``, which can only be used by a
+       * call that does not put it back in the cache.
+       */
+      entry_type(storage_arena *arena = NULL) : cg(arena), arena(arena) {}
+
+      /**
+       * Instantiates the kernel for copies of the given arrmeta.
+       */
+      void instantiate(kernel_request_t kernreq, const char *dst_arrmeta, size_t nsrc, const ndt::type *src_tp,
+                       const char *const *src_arrmeta);
+    };
+
+    /**
+     * The number of kernels instantiated by calls, and the bytes taken by the call
+     * graphs and kernel trees of those, in total and for the most recent one.
+     */
+    struct storage_stats {
+      size_t ninstantiated;
+      size_t call_graph_bytes;
+      size_t kernel_bytes;
+      size_t last_call_graph_bytes;
+      size_t last_kernel_bytes;
+    };
+
+  private:
+    struct key_pointer_hash {
+      size_t operator()(const key_type *key) const { return key->hash; }
+    };
+
+    struct key_pointer_equal {
+      bool operator()(const key_type *lhs, const key_type *rhs) const { return *lhs == *rhs; }
+    };
+
+    typedef std::list<std::pair<key_type, std::unique_ptr<entry_type>>> list_type;
+
+    std::mutex m_mutex;
+    size_t m_capacity;
+    size_t m_hits;
+    size_t m_misses;
+    storage_stats m_storage;
+    // The most recently used entry is at the front
+    list_type m_entries;
+    std::unordered_map<const key_type *, list_type::iterator, key_pointer_hash, key_pointer_equal> m_index;
+
+  public:
+    kernel_cache(size_t capacity = 256);
+
+    // non-copyable
+    kernel_cache(const kernel_cache &) = delete;
+
+    /**
+     * The maximum number of kernels kept. A capacity of zero disables the cache.
+     */
+    size_t capacity();
+
+    void set_capacity(size_t capacity);
+
+    /**
+     * The number of kernels currently kept.
+     */
+    size_t size();
+
+    /**
+     * The number of cacheable calls which found, or did not find, their kernel.
+     */
+    size_t hits();
+
+    size_t misses();
+
+    storage_stats get_storage_stats();
+
+    /**
+     * Counts the storage of a kernel which was just instantiated.
+     */
+    void add_storage(size_t call_graph_bytes, size_t kernel_bytes);
+
+    /**
+     * Drops every kernel, and resets the counters.
+     */
+    void clear();
+
+    /**
+     * Builds the key for a call, returning false if the call cannot be cached. A null
+     * ```dst_arrmeta`` means the destination is allocated from the resolved type.
+     */
+    bool make_key(key_type &key, const base_callable *callable, kernel_request_t kernreq, const ndt::type &dst_tp,
+                  const char *dst_arrmeta, size_t nsrc, const ndt::type *src_tp, const char *const *src_arrmeta,
+                  size_t nkwd, const array *kwds, const std::map<std::string, ndt::type> &tp_vars);
+
+    /**
+     * Takes the kernel for ``key`` out of the cache, or returns NULL.
+     */
+    std::unique_ptr<entry_type> take(const key_type &key);
+
+    /**
+     * Gives a kernel which has just run back to the cache.
+     */
+    void put(key_type &&key, std::unique_ptr<entry_type> entry);
+
+    /**
+     * Drops the kernels of a callable which is being destroyed.
+     */
+    void erase(const base_callable *callable);
+
+    /**
+     * Returns the kernel cache used by ``base_callable::call``.
+     */
+    static kernel_cache &get();
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,12 +5,16 @@
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/kernels/constant_kernel.hpp>
 #include <dynd/kernels/reduction_kernel_prefix.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
 namespace nd {
@@ -319,6 +323,115 @@ namespace nd {
       }
     };
 
+    /**
+     * PARALLEL INNER REDUCTION DIMENSION
+     * This ckernel handles a whole one-dimensional reduction of an associative
+     * operation, splitting the source into contiguous ranges which are reduced
+     * on the thread pool into separate partial results. Only the first range
+     * starts from the identity, the others start from a copy of their first
+     * element, and the partial results are then merged pairwise, in order, by
+     * the reduction kernel itself.
+     *
+     * Requirements:
+     *  - The child destination initialization kernel must be *single*.
+     *  - The child reduction kernel must be *strided*, and its return type
+     *    must be the same as its argument type.
+     *
+     */
+    struct parallel_reduction_kernel : base_reduction_kernel<parallel_reduction_kernel, 1> {
+      intptr_t size;
+      intptr_t src_stride;
+      size_t data_size;
+      // The size of one partial result, padded so that each of them is aligned
+      size_t data_stride;
+      size_t nchunks;
+      size_t init_offset;
+      // The reduction children for every range but the first
+      kernel_builder **clones;
+
+      parallel_reduction_kernel(intptr_t size, intptr_t src_stride, size_t data_size, size_t nchunks)
+          : size(size), src_stride(src_stride), data_size(data_size),
+            data_stride((data_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1)),
+            nchunks(nchunks), init_offset(0), clones(new kernel_builder *[nchunks - 1]()) {}
+
+      ~parallel_reduction_kernel() {
+        this->get_child()->destroy();
+        this->get_child(init_offset)->destroy();
+        for (size_t i = 0; i < nchunks - 1; ++i) {
+          delete clones[i];
+        }
+        delete[] clones;
+      }
+
+      void single_first(char *dst, char *const *src) {
+        kernel_prefix *reduction_child = this->get_child();
+
+        // The first range accumulates directly into dst
+        std::vector<char> partials((nchunks - 1) * data_stride);
+        std::vector<char *> acc(nchunks);
+        acc[0] = dst;
+        for (size_t i = 1; i < nchunks; ++i) {
+          acc[i] = partials.data() + (i - 1) * data_stride;
+        }
+
+        this->get_child(init_offset)->single(dst, src);
+
+        thread_pool::get().parallel_for(nchunks, [this, src, &acc](size_t i) {
+          intptr_t begin = size * i / nchunks;
+          intptr_t end = size * (i + 1) / nchunks;
+
+          char *chunk_src = src[0] + begin * src_stride;
+          kernel_prefix *child;
+          if (i == 0) {
+            child = this->get_child();
+          } else {
+            child = clones[i - 1]->get();
+            memcpy(acc[i], chunk_src, data_size);
+            chunk_src += src_stride;
+            ++begin;
+          }
+          child->strided(acc[i], 0, &chunk_src, &src_stride, end - begin);
+        });
+
+        // Merge neighbouring partial results, so only associativity is needed
+        intptr_t zero_stride = 0;
+        for (size_t step = 1; step < nchunks; step *= 2) {
+          for (size_t i = 0; i + step < nchunks; i += 2 * step) {
+            reduction_child->strided(acc[i], 0, &acc[i + step], &zero_stride, 1);
+          }
+        }
+      }
+
+      void strided_first(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        kernel_prefix *init_child = this->get_child(init_offset);
+        kernel_prefix *reduction_child = this->get_child();
+
+        char *child_src = src[0];
+        for (size_t i = 0; i != count; ++i) {
+          if (i == 0 || dst_stride != 0) {
+            init_child->single(dst, &child_src);
+          }
+          reduction_child->strided(dst, 0, &child_src, &this->src_stride, size);
+
+          dst += dst_stride;
+          child_src += src_stride[0];
+        }
+      }
+
+      void strided_followup(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride,
+                            size_t count) {
+        kernel_prefix *reduction_child = this->get_child();
+
+        char *child_src = src[0];
+        for (size_t i = 0; i != count; ++i) {
+          reduction_child->strided(dst, 0, &child_src, &this->src_stride, size);
+
+          dst += dst_stride;
+          child_src += src_stride[0];
+        }
+      }
+    };
+
     template <size_t NArg>
     struct reduction_kernel<ndt::var_dim_type, false, true, NArg>
         : base_reduction_kernel<reduction_kernel<ndt::var_dim_type, false, true, NArg>, NArg> {
@@ -5,35 +5,406 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 #include <dynd/bytes.hpp>
+#include <dynd/eval/eval_context.hpp>
 #include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/kernel_builder.hpp>
+#include <dynd/thread_pool.hpp>
 
 namespace dynd {
 namespace nd {
+  namespace detail {
+
+    /**
+     * Maps the values of an integer or floating point type to unsigned keys of
+     * the same size, whose order as unsigned integers is the order of the values.
+     * Every NaN maps to the largest key, so NaNs compare equal to one another,
+     * whatever their sign and payload, and are placed last.
+     */
+    template <typename T, typename Enable = void>
+    struct radix_key;
+
+    template <typename T>
+    struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value>> {
+      typedef T type;
+
+      static bool is_nan(T DYND_UNUSED(value)) { return false; }
+      static type from(T value) { return value; }
+      static T to(type key) { return key; }
+    };
+
+    template <typename T>
+    struct radix_key<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>> {
+      typedef std::make_unsigned_t<T> type;
+      static const type sign_bit = static_cast<type>(1) << (8 * sizeof(T) - 1);
+
+      static bool is_nan(T DYND_UNUSED(value)) { return false; }
+      // Flipping the sign bit puts the negative values first
+      static type from(T value) { return static_cast<type>(value) ^ sign_bit; }
+      static T to(type key) { return static_cast<T>(key ^ sign_bit); }
+    };
+
+    template <typename T>
+    struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+      typedef std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> type;
+      static const type sign_bit = static_cast<type>(1) << (8 * sizeof(T) - 1);
+
+      // Negative values have every bit flipped, so that larger magnitudes come first,
+      // and positive ones only the sign bit. Every NaN becomes the largest key.
+      static bool is_nan(T value) { return value != value; }
+      static type from(T value) {
+        if (is_nan(value)) {
+          return ~static_cast<type>(0);
+        }
+
+        type bits;
+        memcpy(&bits, &value, sizeof(T));
+        return (bits & sign_bit) ? ~bits : (bits ^ sign_bit);
+      }
+
+      static T to(type key) {
+        type bits = (key & sign_bit) ? (key ^ sign_bit) : ~key;
+        T value;
+        memcpy(&value, &bits, sizeof(T));
+        return value;
+      }
+    };
+
+    /**
+     * Sorts ``vals`` by their unsigned keys, found with ``get_key``, with a
+     * least significant digit radix sort, 11 bits at a time. The sort is
+     * stable, ``buffer`` of the same size is the scratch space, and a digit
+     * which is the same in every key is skipped.
+     */
+    template <typename KeyType, typename T, typename GetKey>
+    void radix_sort(std::vector<T> &vals, std::vector<T> &buffer, GetKey get_key) {
+      // Wider digits than a byte need fewer passes, while the counts still fit in the L1 cache
+      static const size_t digit_bits = 11;
+      static const size_t radix = static_cast<size_t>(1) << digit_bits;
+      static const KeyType digit_mask = static_cast<KeyType>(radix - 1);
+      static const size_t ndigits = (8 * sizeof(KeyType) + digit_bits - 1) / digit_bits;
+      size_t size = vals.size();
+
+      // The histograms of every digit are counted in a single pass
+      std::vector<size_t> counts(ndigits * radix);
+      for (const T &val : vals) {
+        KeyType key = get_key(val);
+        for (size_t j = 0; j < ndigits; ++j) {
+          ++counts[j * radix + ((key >> (digit_bits * j)) & digit_mask)];
+        }
+      }
+
+      for (size_t j = 0; j < ndigits; ++j) {
+        size_t *count = counts.data() + j * radix;
+        if (count[(get_key(vals[0]) >> (digit_bits * j)) & digit_mask] == size) {
+          continue;
+        }
+
+        size_t offset = 0;
+        for (size_t k = 0; k < radix; ++k) {
+          size_t c = count[k];
+          count[k] = offset;
+          offset += c;
+        }
+
+        for (const T &val : vals) {
+          buffer[count[(get_key(val) >> (digit_bits * j)) & digit_mask]++] = val;
+        }
+        vals.swap(buffer);
+      }
+    }
+
+    template <typename KeyType>
+    void radix_sort(std::vector<KeyType> &keys, std::vector<KeyType> &buffer) {
+      radix_sort<KeyType>(keys, buffer, [](KeyType key) { return key; });
+    }
+
+    /**
+     * Sorts ``vals`` stably with the comparisons of ``get_less(i)``. Over
+     * several chunks, every chunk is sorted on its own thread, then
+     * neighbouring runs are merged in rounds. The ``i``th task of a round only
+     * ever compares with ``get_less(i)``, so a comparison need not be shared
+     * between threads.
+     */
+    template <typename T, typename GetLess>
+    void stable_sort(std::vector<T> &vals, GetLess get_less, size_t nchunks) {
+      size_t size = vals.size();
+      if (nchunks <= 1 || size < 2 * nchunks) {
+        std::stable_sort(vals.begin(), vals.end(), get_less(0));
+        return;
+      }
+
+      std::vector<size_t> bounds(nchunks + 1);
+      for (size_t i = 0; i <= nchunks; ++i) {
+        bounds[i] = i * size / nchunks;
+      }
+      thread_pool::get().parallel_for(nchunks, [&](size_t i) {
+        std::stable_sort(vals.begin() + bounds[i], vals.begin() + bounds[i + 1], get_less(i));
+      });
+
+      std::vector<T> buffer(size);
+      for (size_t width = 1; width < nchunks; width *= 2) {
+        size_t nmerges = (nchunks + 2 * width - 1) / (2 * width);
+        thread_pool::get().parallel_for(nmerges, [&](size_t i) {
+          size_t begin = bounds[2 * i * width];
+          size_t middle = bounds[std::min((2 * i + 1) * width, nchunks)];
+          size_t end = bounds[std::min((2 * i + 2) * width, nchunks)];
+          std::merge(vals.begin() + begin, vals.begin() + middle, vals.begin() + middle, vals.begin() + end,
+                     buffer.begin() + begin, get_less(i));
+        });
+        vals.swap(buffer);
+      }
+    }
+
+    /**
+     * The number of threads a comparison sort of ``size`` elements runs over,
+     * from the evaluation context ``ectx``.
+     */
+    inline size_t sort_nchunks(intptr_t size, const eval::eval_context *ectx) {
+      return std::max<size_t>(std::min<size_t>(ectx->nthreads, size / std::max<intptr_t>(ectx->min_grain_size, 1)),
+                              1);
+    }
+
+    /**
+     * The ``less`` children of a comparison sort over ``nchunks`` threads. The
+     * first chunk compares with the child kernel that follows the sort kernel,
+     * every other one with its own copy of the child, instantiated from the
+     * same call graph node, as ``parallel_elwise_kernel`` does.
+     */
+    struct sort_children {
+      size_t nchunks;
+      // The children for every chunk but the first
+      kernel_builder **clones;
+
+      sort_children(size_t nchunks) : nchunks(nchunks), clones(new kernel_builder *[nchunks - 1]()) {}
 
+      ~sort_children() {
+        for (size_t i = 0; i < nchunks - 1; ++i) {
+          delete clones[i];
+        }
+        delete[] clones;
+      }
+
+      /**
+       * Instantiates the children of every chunk but the first from
+       * ``child_call``, the node the first one was instantiated from.
+       */
+      void instantiate(call_node *child_call) {
+        for (size_t i = 0; i < nchunks - 1; ++i) {
+          clones[i] = new kernel_builder(child_call);
+          (*clones[i])(kernel_request_single, nullptr, nullptr, 2, nullptr);
+        }
+      }
+
+      kernel_prefix *get(kernel_prefix *first, size_t i) const { return (i == 0) ? first : clones[i - 1]->get(); }
+    };
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * A kernel which sorts a strided dimension of elements in place, comparing
+   * them with the child kernel. The elements are sorted as pointers with a
+   * stable merge sort, which runs over ``nchunks`` threads, each with its own
+   * child, and are then moved to their places in a single pass.
+   */
   struct sort_kernel : base_strided_kernel<sort_kernel, 1> {
     const intptr_t src0_size;
     const intptr_t src0_stride;
     const intptr_t src0_element_data_size;
+    detail::sort_children children;
 
-    sort_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size)
-        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size)
-    {
-    }
+    sort_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size, size_t nchunks = 1)
+        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size),
+          children(nchunks) {}
 
     ~sort_kernel() { get_child()->destroy(); }
 
-    void single(char *DYND_UNUSED(dst), char *const *src)
-    {
-      kernel_prefix *child = get_child();
-      std::sort(strided_iterator(src[0], src0_element_data_size, src0_stride),
-                strided_iterator(src[0] + src0_size * src0_stride, src0_element_data_size, src0_stride),
-                [child](char *lhs, char *rhs) {
-                  bool1 dst;
-                  char *src[2] = {lhs, rhs};
-                  child->single(reinterpret_cast<char *>(&dst), src);
-                  return dst;
-                });
+    /**
+     * Sorts ``ptrs`` by the elements they point to, stably.
+     */
+    void sort(std::vector<char *> &ptrs) {
+      kernel_prefix *first = get_child();
+      detail::stable_sort(ptrs,
+                          [this, first](size_t i) {
+                            kernel_prefix *child = children.get(first, i);
+                            return [child](char *lhs, char *rhs) {
+                              bool1 dst;
+                              char *src[2] = {lhs, rhs};
+                              child->single(reinterpret_cast<char *>(&dst), src);
+                              return static_cast<bool>(dst);
+                            };
+                          },
+                          children.nchunks);
+    }
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      if (src0_size < 2) {
+        return;
+      }
+
+      std::vector<char *> ptrs(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        ptrs[i] = src[0] + i * src0_stride;
+      }
+      sort(ptrs);
+
+      // The elements are relocated as bytes, as a swap would
+      std::vector<char> buffer(src0_size * src0_element_data_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        memcpy(buffer.data() + i * src0_element_data_size, ptrs[i], src0_element_data_size);
+      }
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        memcpy(src[0] + i * src0_stride, buffer.data() + i * src0_element_data_size, src0_element_data_size);
+      }
+    }
+  };
+
+  /**
+   * A kernel which sorts a strided dimension of integers or floating point
+   * values in place with a radix sort, without comparing them. Floating point
+   * values are in the order of ``<``, with NaNs last, in their original order
+   * and with their sign and payload bits kept, as ``radix_argsort_kernel<T>``
+   * places them.
+   */
+  template <typename T>
+  struct radix_sort_kernel : base_strided_kernel<radix_sort_kernel<T>, 1> {
+    typedef typename detail::radix_key<T>::type key_type;
+
+    // Below this size, sorting the keys with comparisons is faster
+    static const intptr_t min_radix_size = 256;
+
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+
+    radix_sort_kernel(intptr_t src0_size, intptr_t src0_stride) : src0_size(src0_size), src0_stride(src0_stride) {}
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      if (src0_size < 2) {
+        return;
+      }
+
+      // A NaN key can not be turned back into its NaN, so NaNs are set aside
+      std::vector<key_type> keys;
+      std::vector<T> nans;
+      keys.reserve(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        T value = *reinterpret_cast<const T *>(src[0] + i * src0_stride);
+        if (detail::radix_key<T>::is_nan(value)) {
+          nans.push_back(value);
+        } else {
+          keys.push_back(detail::radix_key<T>::from(value));
+        }
+      }
+
+      intptr_t nkeys = keys.size();
+      if (nkeys < min_radix_size) {
+        std::sort(keys.begin(), keys.end());
+      } else {
+        std::vector<key_type> buffer(nkeys);
+        detail::radix_sort(keys, buffer);
+      }
+
+      for (intptr_t i = 0; i < nkeys; ++i) {
+        *reinterpret_cast<T *>(src[0] + i * src0_stride) = detail::radix_key<T>::to(keys[i]);
+      }
+      for (intptr_t i = nkeys; i < src0_size; ++i) {
+        *reinterpret_cast<T *>(src[0] + i * src0_stride) = nans[i - nkeys];
+      }
+    }
+  };
+
+  /**
+   * A kernel which writes the permutation of indices which sorts a strided
+   * dimension, comparing the elements with the child kernel. The elements are
+   * not moved. With ``stable``, equal elements keep their order, and the sort
+   * runs over ``nchunks`` threads, each with its own child.
+   */
+  struct argsort_kernel : base_strided_kernel<argsort_kernel, 1> {
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t dst_stride;
+    const bool stable;
+    detail::sort_children children;
+
+    argsort_kernel(intptr_t src0_size, intptr_t src0_stride, intptr_t dst_stride, bool stable, size_t nchunks = 1)
+        : src0_size(src0_size), src0_stride(src0_stride), dst_stride(dst_stride), stable(stable), children(nchunks) {}
+
+    ~argsort_kernel() { get_child()->destroy(); }
+
+    void single(char *dst, char *const *src) {
+      std::vector<intptr_t> indices(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        indices[i] = i;
+      }
+
+      kernel_prefix *first = get_child();
+      char *src0 = src[0];
+      intptr_t stride = src0_stride;
+      auto get_less = [this, first, src0, stride](size_t i) {
+        kernel_prefix *child = children.get(first, i);
+        return [child, src0, stride](intptr_t lhs, intptr_t rhs) {
+          bool1 res;
+          char *child_src[2] = {src0 + lhs * stride, src0 + rhs * stride};
+          child->single(reinterpret_cast<char *>(&res), child_src);
+          return static_cast<bool>(res);
+        };
+      };
+      if (stable) {
+        detail::stable_sort(indices, get_less, children.nchunks);
+      } else {
+        std::sort(indices.begin(), indices.end(), get_less(0));
+      }
+
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        *reinterpret_cast<intptr_t *>(dst + i * dst_stride) = indices[i];
+      }
+    }
+  };
+
+  /**
+   * A kernel which writes the permutation of indices which sorts a strided
+   * dimension of integers or floating point values, in the order of
+   * ``radix_sort_kernel<T>``. The sort is always stable.
+   */
+  template <typename T>
+  struct radix_argsort_kernel : base_strided_kernel<radix_argsort_kernel<T>, 1> {
+    typedef typename detail::radix_key<T>::type key_type;
+
+    struct entry {
+      key_type key;
+      intptr_t index;
+    };
+
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const intptr_t dst_stride;
+
+    radix_argsort_kernel(intptr_t src0_size, intptr_t src0_stride, intptr_t dst_stride)
+        : src0_size(src0_size), src0_stride(src0_stride), dst_stride(dst_stride) {}
+
+    void single(char *dst, char *const *src) {
+      std::vector<entry> entries(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        entries[i].key = detail::radix_key<T>::from(*reinterpret_cast<const T *>(src[0] + i * src0_stride));
+        entries[i].index = i;
+      }
+
+      if (src0_size < radix_sort_kernel<T>::min_radix_size) {
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const entry &lhs, const entry &rhs) { return lhs.key < rhs.key; });
+      } else {
+        std::vector<entry> buffer(src0_size);
+        detail::radix_sort<key_type>(entries, buffer, [](const entry &e) { return e.key; });
+      }
+
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        *reinterpret_cast<intptr_t *>(dst + i * dst_stride) = entries[i].index;
+      }
     }
   };
 
@@ -5,39 +5,275 @@
 
 #pragma once
 
+#include <cstring>
+#include <vector>
+
 #include <dynd/bytes.hpp>
-#include <dynd/kernels/base_kernel.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
 
 namespace dynd {
 namespace nd {
 
-  struct unique_kernel : base_kernel<unique_kernel> {
+  /**
+   * What a ``unique_kernel`` writes for the distinct values of a dimension,
+   * which are always in the order they first appear.
+   */
+  enum unique_mode {
+    // The distinct values, as ``var * T``
+    unique_values,
+    // The struct ``{values: var * T, counts: var * intptr}``
+    unique_value_counts,
+    // The struct ``{codes: N * intptr, uniques: var * T}``, where every code
+    // is the index of the element in ``uniques``
+    unique_factorize
+  };
+
+  namespace detail {
+
+    /**
+     * The finalizer of MurmurHash3, which spreads every bit of ``x`` over
+     * the whole hash.
+     */
+    inline uint64_t hash_mix(uint64_t x) {
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      x *= 0xc4ceb9fe1a85ec53ULL;
+      x ^= x >> 33;
+      return x;
+    }
+
+    /**
+     * Hashes ``size`` bytes, eight at a time.
+     */
+    inline uint64_t hash_bytes(const char *data, size_t size) {
+      uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+      for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        h = hash_mix(h ^ word);
+      }
+      if (size > 0) {
+        uint64_t word = 0;
+        memcpy(&word, data, size);
+        h = hash_mix(h ^ word);
+      }
+      return h;
+    }
+
+    /**
+     * Hashes and compares the values of a builtin integer or floating point
+     * type. Floating point values are equal as with ``==``, except that every
+     * NaN is equal to every other.
+     */
+    template <typename T, bool Float = std::is_floating_point<T>::value>
+    struct value_hasher {
+      size_t hash(const char *data) const {
+        return static_cast<size_t>(hash_mix(static_cast<uint64_t>(*reinterpret_cast<const T *>(data))));
+      }
+
+      bool equal(const char *lhs, const char *rhs) const {
+        return *reinterpret_cast<const T *>(lhs) == *reinterpret_cast<const T *>(rhs);
+      }
+    };
+
+    template <typename T>
+    struct value_hasher<T, true> {
+      typedef std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> bits_type;
+
+      size_t hash(const char *data) const {
+        T value = *reinterpret_cast<const T *>(data);
+        bits_type bits = 0;
+        // Both zeros hash as +0, and every NaN the same
+        if (value != value) {
+          bits = ~static_cast<bits_type>(0);
+        } else if (value != 0) {
+          memcpy(&bits, &value, sizeof(T));
+        }
+        return static_cast<size_t>(hash_mix(bits));
+      }
+
+      bool equal(const char *lhs, const char *rhs) const {
+        T lhs_value = *reinterpret_cast<const T *>(lhs), rhs_value = *reinterpret_cast<const T *>(rhs);
+        return lhs_value == rhs_value || (lhs_value != lhs_value && rhs_value != rhs_value);
+      }
+    };
+
+    /**
+     * Hashes and compares the bytes of values of a fixed size, like those of
+     * ``fixed_string`` and ``fixed_bytes``.
+     */
+    struct fixed_bytes_hasher {
+      size_t data_size;
+
+      fixed_bytes_hasher(size_t data_size) : data_size(data_size) {}
+
+      size_t hash(const char *data) const { return static_cast<size_t>(hash_bytes(data, data_size)); }
+
+      bool equal(const char *lhs, const char *rhs) const { return memcmp(lhs, rhs, data_size) == 0; }
+    };
+
+    /**
+     * Hashes and compares the contents of ``string`` or ``bytes`` values.
+     */
+    template <typename StringType>
+    struct string_hasher {
+      size_t hash(const char *data) const {
+        const StringType *s = reinterpret_cast<const StringType *>(data);
+        return static_cast<size_t>(hash_bytes(s->data(), s->size()));
+      }
+
+      bool equal(const char *lhs, const char *rhs) const {
+        const StringType *lhs_s = reinterpret_cast<const StringType *>(lhs);
+        const StringType *rhs_s = reinterpret_cast<const StringType *>(rhs);
+        return lhs_s->size() == rhs_s->size() && memcmp(lhs_s->data(), rhs_s->data(), lhs_s->size()) == 0;
+      }
+    };
+
+    /**
+     * An open addressing hash table which numbers the distinct values it is
+     * given, in the order they are first inserted. The values are not copied,
+     * so they must outlive the table.
+     */
+    template <typename HasherType>
+    class hash_index {
+      struct slot {
+        size_t hash;
+        intptr_t id;
+      };
+
+      HasherType m_hasher;
+      std::vector<slot> m_slots;
+      size_t m_mask;
+      std::vector<const char *> m_values;
+
+      void grow() {
+        std::vector<slot> slots(2 * m_slots.size(), slot{0, -1});
+        size_t mask = slots.size() - 1;
+        for (const slot &s : m_slots) {
+          if (s.id >= 0) {
+            size_t i = s.hash & mask;
+            while (slots[i].id >= 0) {
+              i = (i + 1) & mask;
+            }
+            slots[i] = s;
+          }
+        }
+        m_slots.swap(slots);
+        m_mask = mask;
+      }
+
+    public:
+      hash_index(const HasherType &hasher) : m_hasher(hasher), m_slots(1024, slot{0, -1}), m_mask(1023) {}
+
+      /**
+       * Returns the number of the value at ``data``, numbering it if it is new.
+       */
+      intptr_t insert(const char *data) {
+        size_t hash = m_hasher.hash(data);
+        size_t i = hash & m_mask;
+        while (m_slots[i].id >= 0) {
+          if (m_slots[i].hash == hash && m_hasher.equal(m_values[m_slots[i].id], data)) {
+            return m_slots[i].id;
+          }
+          i = (i + 1) & m_mask;
+        }
+
+        intptr_t id = static_cast<intptr_t>(m_values.size());
+        m_slots[i] = slot{hash, id};
+        m_values.push_back(data);
+        // The table is kept at most half full, so probes stay short
+        if (2 * m_values.size() > m_slots.size()) {
+          grow();
+        }
+
+        return id;
+      }
+
+      size_t size() const { return m_values.size(); }
+
+      const char *get_value(intptr_t id) const { return m_values[id]; }
+    };
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * A kernel which finds the distinct values of a strided dimension with a
+   * hash table, in a single pass. What it writes is given by ``mode``, the
+   * distinct values are copied with the child kernel.
+   */
+  template <typename HasherType>
+  struct unique_kernel : base_strided_kernel<unique_kernel<HasherType>, 1> {
+    const HasherType hasher;
+    const unique_mode mode;
     const intptr_t src0_size;
     const intptr_t src0_stride;
-    const intptr_t src0_element_data_size;
-
-    unique_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size)
-        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size) {}
-
-    ~unique_kernel() { get_child()->destroy(); }
-
-    void call(array *DYND_UNUSED(dst), const array *src) {
-      kernel_prefix *child = get_child();
-      size_t new_size =
-          (std::unique(strided_iterator(src[0].data(), src0_element_data_size, src0_stride),
-                       strided_iterator(src[0].data() + src0_size * src0_stride, src0_element_data_size, src0_stride),
-                       [child](char *lhs, char *rhs) {
-                         bool1 dst;
-                         char *src[2] = {lhs, rhs};
-                         child->single(reinterpret_cast<char *>(&dst), src);
-                         return dst;
-                       }) -
-           src[0].data()) /
-          src0_stride;
-
-//      src[0]->set_type(
-  //        ndt::make_fixed_dim(new_size, src[0]->get_type().extended<ndt::fixed_dim_type>()->get_element_type()));
-      reinterpret_cast<size_stride_t *>(src[0]->metadata())->dim_size = new_size;
+    // The arrmeta and data offset of each output within the destination
+    const char *uniques_arrmeta;
+    uintptr_t uniques_offset;
+    const char *counts_arrmeta;
+    uintptr_t counts_offset;
+    intptr_t codes_stride;
+    uintptr_t codes_offset;
+
+    unique_kernel(const HasherType &hasher, unique_mode mode, intptr_t src0_size, intptr_t src0_stride)
+        : hasher(hasher), mode(mode), src0_size(src0_size), src0_stride(src0_stride), uniques_arrmeta(NULL),
+          uniques_offset(0), counts_arrmeta(NULL), counts_offset(0), codes_stride(0), codes_offset(0) {}
+
+    ~unique_kernel() { this->get_child()->destroy(); }
+
+    /**
+     * Allocates a ``var`` dimension of ``size`` elements, returning its first.
+     */
+    static char *alloc_var_dim(char *data, const char *arrmeta, size_t size) {
+      ndt::var_dim_type::data_type *vdd = reinterpret_cast<ndt::var_dim_type::data_type *>(data);
+      vdd->begin = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta)->blockref->alloc(size);
+      vdd->size = size;
+      return vdd->begin;
+    }
+
+    void single(char *dst, char *const *src) {
+      detail::hash_index<HasherType> index(hasher);
+      const char *src0 = src[0];
+      if (mode == unique_factorize) {
+        char *codes = dst + codes_offset;
+        for (intptr_t i = 0; i < src0_size; ++i, src0 += src0_stride, codes += codes_stride) {
+          *reinterpret_cast<intptr_t *>(codes) = index.insert(src0);
+        }
+      } else if (mode == unique_value_counts) {
+        std::vector<intptr_t> counts;
+        for (intptr_t i = 0; i < src0_size; ++i, src0 += src0_stride) {
+          size_t id = static_cast<size_t>(index.insert(src0));
+          if (id == counts.size()) {
+            counts.push_back(0);
+          }
+          ++counts[id];
+        }
+
+        char *dst_counts = alloc_var_dim(dst + counts_offset, counts_arrmeta, counts.size());
+        intptr_t dst_counts_stride = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(counts_arrmeta)->stride;
+        for (intptr_t count : counts) {
+          *reinterpret_cast<intptr_t *>(dst_counts) = count;
+          dst_counts += dst_counts_stride;
+        }
+      } else {
+        for (intptr_t i = 0; i < src0_size; ++i, src0 += src0_stride) {
+          index.insert(src0);
+        }
+      }
+
+      // The distinct values are copied last, once their number is known
+      kernel_prefix *child = this->get_child();
+      kernel_single_t child_fn = child->get_function<kernel_single_t>();
+      char *dst_uniques = alloc_var_dim(dst + uniques_offset, uniques_arrmeta, index.size());
+      intptr_t dst_uniques_stride = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(uniques_arrmeta)->stride;
+      for (size_t id = 0; id < index.size(); ++id) {
+        char *child_src = const_cast<char *>(index.get_value(id));
+        child_fn(child, dst_uniques, &child_src);
+        dst_uniques += dst_uniques_stride;
+      }
     }
   };
 
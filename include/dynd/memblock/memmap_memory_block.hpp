@@ -5,8 +5,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -20,6 +24,7 @@
 #include <unistd.h>
 #endif
 
+#include <dynd/array.hpp>
 #include <dynd/memblock/base_memory_block.hpp>
 
 namespace dynd {
@@ -61,6 +66,58 @@ inline void clip_begin_end(intptr_t size, intptr_t &begin, intptr_t &end) {
 }
 
 namespace nd {
+  namespace detail {
+
+    inline intptr_t get_page_size() {
+#ifdef WIN32
+      SYSTEM_INFO sysInfo;
+      GetSystemInfo(&sysInfo);
+      return sysInfo.dwPageSize;
+#else
+      return sysconf(_SC_PAGE_SIZE);
+#endif
+    }
+
+    /**
+     * Reads a byte of every page between ``begin`` and ``end``, so they are
+     * all faulted in.
+     */
+    inline void touch_pages(const char *begin, const char *end, intptr_t page_size) {
+      uintptr_t page_mask = ~static_cast<uintptr_t>(page_size - 1);
+      const char *page = reinterpret_cast<const char *>(reinterpret_cast<uintptr_t>(begin) & page_mask);
+      for (; page < end; page += page_size) {
+        // A byte within the range, in case the page starts before it
+        *static_cast<const volatile char *>(std::max(page, begin));
+      }
+    }
+
+#ifndef WIN32
+    /**
+     * Gives the kernel the hints in ``options`` about how a map will be used.
+     */
+    inline void advise_memmap(char *map_pointer, intptr_t map_size, const memmap_options &options) {
+      switch (options.advice) {
+      case memmap_advice_sequential:
+        madvise(map_pointer, map_size, MADV_SEQUENTIAL);
+        break;
+      case memmap_advice_random:
+        madvise(map_pointer, map_size, MADV_RANDOM);
+        break;
+      case memmap_advice_willneed:
+        madvise(map_pointer, map_size, MADV_WILLNEED);
+        break;
+      default:
+        break;
+      }
+#ifdef MADV_HUGEPAGE
+      if (options.huge_pages) {
+        madvise(map_pointer, map_size, MADV_HUGEPAGE);
+      }
+#endif
+    }
+#endif
+
+  } // namespace dynd::nd::detail
 
   /**
    * Creates a memory block of a memory-mapped file.
@@ -79,6 +136,8 @@ namespace nd {
    *             (default end of the file). This value may be
    *             negative, in which case it is interpreted as an offset from the
    *             end of the file.
+   * \param options  How the file is mapped, and hints about how the map will
+   *                 be accessed.
    */
   class memmap_memory_block : public base_memory_block {
     // Parameters used to construct the memory block
@@ -98,7 +157,8 @@ namespace nd {
 
   public:
     memmap_memory_block(const std::string &filename, uint32_t DYND_UNUSED(access), char **out_pointer,
-                        intptr_t *out_size, intptr_t begin = 0, intptr_t end = std::numeric_limits<intptr_t>::max())
+                        intptr_t *out_size, intptr_t begin = 0, intptr_t end = std::numeric_limits<intptr_t>::max(),
+                        const memmap_options &options = memmap_options())
         : m_filename(filename), m_begin(begin), m_end(end) {
       bool readwrite = false; // ((access & nd::write_access_flag) == nd::write_access_flag);
 #ifdef WIN32
@@ -132,7 +192,8 @@ namespace nd {
       m_mapOffset = begin - mapbegin;
       intptr_t mapsize = end - mapbegin;
 
-      m_hMapFile = CreateFileMapping(m_hFile, NULL, readwrite ? PAGE_READWRITE : PAGE_READONLY,
+      DWORD protect = readwrite ? PAGE_READWRITE : (options.copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY);
+      m_hMapFile = CreateFileMapping(m_hFile, NULL, protect,
 #ifdef _WIN64
                                      (uint32_t)(((uint64_t)end) >> 32),
 #else
@@ -147,7 +208,8 @@ namespace nd {
       }
 
       // Create the mapped memory
-      m_mapPointer = (char *)MapViewOfFile(m_hMapFile, FILE_MAP_READ | (readwrite ? FILE_MAP_WRITE : 0),
+      DWORD desired_access = options.copy_on_write ? FILE_MAP_COPY : (FILE_MAP_READ | (readwrite ? FILE_MAP_WRITE : 0));
+      m_mapPointer = (char *)MapViewOfFile(m_hMapFile, desired_access,
 #ifdef _WIN64
                                            (uint32_t)(((uint64_t)mapbegin) >> 32),
 #else
@@ -161,6 +223,9 @@ namespace nd {
         ss << "failure mapping view of file \"" << m_filename << "\" for memory mapping";
         throw std::runtime_error(ss.str());
       }
+      if (options.populate) {
+        detail::touch_pages(m_mapPointer, m_mapPointer + mapsize, detail::get_page_size());
+      }
       *out_pointer = m_mapPointer + m_mapOffset;
       *out_size = end - begin;
 #else // Finished win32 implementation, now posix
@@ -196,12 +261,32 @@ namespace nd {
       m_mapOffset = begin - mapbegin;
       intptr_t mapsize = end - mapbegin;
 
-      m_mapPointer = (char *)mmap(NULL, mapsize, PROT_READ | (readwrite ? PROT_WRITE : 0), MAP_SHARED, m_fd, mapbegin);
-      if (m_mapPointer == (char *)MAP_FAILED) {
-        close(m_fd);
-        std::stringstream ss;
-        ss << "failed to mmap file \"" << m_filename << "\" for memory mapping";
-        throw std::runtime_error(ss.str());
+      // A private map can be written without opening the file for writing
+      int flags = options.copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+      bool populate = options.populate;
+#ifdef MAP_POPULATE
+      // Huge pages must be asked for before the pages are faulted in
+      if (populate && !options.huge_pages) {
+        flags |= MAP_POPULATE;
+        populate = false;
+      }
+#endif
+      if (mapsize == 0) {
+        // mmap does not accept an empty map
+        m_mapPointer = NULL;
+      } else {
+        m_mapPointer = (char *)mmap(NULL, mapsize, PROT_READ | ((readwrite || options.copy_on_write) ? PROT_WRITE : 0),
+                                    flags, m_fd, mapbegin);
+        if (m_mapPointer == (char *)MAP_FAILED) {
+          close(m_fd);
+          std::stringstream ss;
+          ss << "failed to mmap file \"" << m_filename << "\" for memory mapping";
+          throw std::runtime_error(ss.str());
+        }
+        detail::advise_memmap(m_mapPointer, mapsize, options);
+        if (populate) {
+          detail::touch_pages(m_mapPointer, m_mapPointer + mapsize, pageSize);
+        }
       }
 
       *out_pointer = m_mapPointer + m_mapOffset;
@@ -215,8 +300,10 @@ namespace nd {
       CloseHandle(m_hMapFile);
       CloseHandle(m_hFile);
 #else
-      intptr_t mapsize = m_end - m_begin + m_mapOffset;
-      munmap((void *)m_mapPointer, mapsize);
+      if (m_mapPointer != NULL) {
+        intptr_t mapsize = m_end - m_begin + m_mapOffset;
+        munmap((void *)m_mapPointer, mapsize);
+      }
       close(m_fd);
 #endif
     }
@@ -231,5 +318,87 @@ namespace nd {
     }
   };
 
+  /**
+   * Faults in the pages of memory, such as that of a memory-mapped array, on
+   * a background thread ahead of a sequential scan of it, so the scan finds
+   * them already mapped. The scan reports how far it has got with
+   * ``advance``, and the thread stays up to ``window`` bytes ahead of that.
+   * The thread stops when the helper is destroyed, which must happen before
+   * the memory is unmapped.
+   */
+  class memmap_readahead {
+    const char *m_begin, *m_end;
+    size_t m_window;
+
+    // Guards everything below
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    const char *m_position;
+    bool m_stop;
+
+    std::thread m_thread;
+
+    // How much is faulted in at a time, between checks of the position
+    static const size_t step_size = 1 << 21;
+
+    void run() {
+      intptr_t page_size = detail::get_page_size();
+      const char *done = m_begin;
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (;;) {
+        m_cv.wait(lock, [&] {
+          return m_stop || (done < m_end && (done < m_position || static_cast<size_t>(done - m_position) < m_window));
+        });
+        if (m_stop) {
+          return;
+        }
+        // Nothing behind the scan is faulted in
+        done = std::max(done, m_position);
+        const char *target = (static_cast<size_t>(m_end - m_position) > m_window) ? m_position + m_window : m_end;
+        lock.unlock();
+
+        const char *step_end = (static_cast<size_t>(target - done) > step_size) ? done + step_size : target;
+#ifndef WIN32
+        // Starts reading the whole step from the file at once
+        uintptr_t page_mask = ~static_cast<uintptr_t>(page_size - 1);
+        char *page = reinterpret_cast<char *>(reinterpret_cast<uintptr_t>(done) & page_mask);
+        madvise(page, step_end - page, MADV_WILLNEED);
+#endif
+        detail::touch_pages(done, step_end, page_size);
+        done = step_end;
+
+        lock.lock();
+      }
+    }
+
+  public:
+    memmap_readahead(const char *begin, const char *end, size_t window = 64 << 20)
+        : m_begin(begin), m_end(end), m_window(window), m_position(begin), m_stop(false),
+          m_thread(&memmap_readahead::run, this) {}
+
+    // non-copyable
+    memmap_readahead(const memmap_readahead &) = delete;
+
+    ~memmap_readahead() {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_cv.notify_one();
+      m_thread.join();
+    }
+
+    /**
+     * Tells the helper the scan has reached ``position``.
+     */
+    void advance(const char *position) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_position = position;
+      }
+      m_cv.notify_one();
+    }
+  };
+
 } // namespace dynd::nd
 } // namespace dynd
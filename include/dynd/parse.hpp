@@ -18,6 +18,16 @@
 #include <dynd/types/string_type.hpp>
 
 namespace dynd {
+
+/**
+ * Gets the range of the text to parse from ``text``, a string or a bytes array
+ * (interpreted as UTF-8), which is kept alive by ``out_tmp_ref``. A string in
+ * another encoding is converted to UTF-8 first. ``format`` names the input in
+ * the error for any other type.
+ */
+DYND_API void parse_as_buffer(const nd::array &text, nd::array &out_tmp_ref, const char *&begin, const char *&end,
+                              const char *format);
+
 namespace nd {
   namespace json {
 
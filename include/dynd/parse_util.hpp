@@ -688,6 +688,80 @@ DYNDT_API bool parse_4digit_int_no_ws(const char *&rbegin, const char *end, int
  */
 DYNDT_API bool parse_6digit_int_no_ws(const char *&rbegin, const char *end, int &out_val);
 
+namespace detail {
+
+  /**
+   * Loads eight characters as an integer whose lowest byte is the first one.
+   */
+  inline uint64_t load_eight_chars(const char *begin) {
+    uint64_t chunk;
+    memcpy(&chunk, begin, sizeof(chunk));
+#ifdef DYND_BIG_ENDIAN
+    chunk = __builtin_bswap64(chunk);
+#endif
+    return chunk;
+  }
+
+  /**
+   * Whether all eight characters loaded by ``load_eight_chars`` are decimal
+   * digits, tested all at once.
+   */
+  inline bool is_eight_digits(uint64_t chunk) {
+    return (((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+  }
+
+  /**
+   * Converts eight decimal digits loaded by ``load_eight_chars``, combining
+   * neighbouring digits, then pairs of those, then quads, with multiplies.
+   */
+  inline uint32_t parse_eight_digits(uint64_t chunk) {
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >>
+            32;
+    return static_cast<uint32_t>(chunk);
+  }
+
+  /**
+   * Reads the leading digits of ``[begin, end)`` eight at a time into
+   * ``value``, for as long as that can't overflow 64 bits. Returns the first
+   * character which wasn't read, the rest are left to a scalar loop.
+   */
+  inline const char *parse_leading_digits(const char *begin, const char *end, uint64_t &value) {
+    value = 0;
+    while (end - begin >= 8 && value < 100000000000ULL) {
+      uint64_t chunk = load_eight_chars(begin);
+      if (!is_eight_digits(chunk)) {
+        break;
+      }
+      value = value * 100000000 + parse_eight_digits(chunk);
+      begin += 8;
+    }
+    return begin;
+  }
+
+  /**
+   * Whether ``10 * value + digit`` overflows ``T``.
+   */
+  template <typename T>
+  bool is_mul10_add_overflow(T value, T digit) {
+    return value > (std::numeric_limits<T>::max() - digit) / 10u;
+  }
+
+} // namespace dynd::detail
+
+/**
+ * Parses a string containing only a decimal floating point number, as in
+ * "-12.5e3", correctly rounded. Most numbers are converted with the
+ * Eisel-Lemire algorithm, which finds the rounding from a 128 bit product
+ * with a table of powers of five. Returns false, writing nothing, for other
+ * syntax and for the rare numbers whose rounding that can't decide, which
+ * are left to strtod.
+ */
+DYNDT_API bool parse_decimal_float(const char *begin, const char *end, float &out);
+DYNDT_API bool parse_decimal_float(const char *begin, const char *end, double &out);
+
 /**
  * Parses a string containing an boolean (no leading or trailing space), returning
  * false if there are errors.
@@ -746,7 +820,9 @@ std::enable_if_t<is_boolean<T>::value, T> parse(const char *begin, const char *e
 template <typename T>
 std::enable_if_t<is_unsigned<T>::value && is_integral<T>::value && !is_boolean<T>::value, T>
 parse(const char *begin, const char *end, nocheck_t DYND_UNUSED(nocheck)) {
-  T result = 0;
+  uint64_t leading;
+  begin = detail::parse_leading_digits(begin, end, leading);
+  T result = static_cast<T>(leading);
   while (begin < end) {
     char c = *begin;
     if ('0' <= c && c <= '9') {
@@ -856,10 +932,15 @@ std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const
     }
   }
 
-  // TODO: use http://www.netlib.org/fp/dtoa.c
+  T value;
+  if (parse_decimal_float(begin, end, value)) {
+    return value;
+  }
+
+  // Anything else is left to strtod, which needs a NUL terminator
   char *end_ptr;
   std::string s(begin, end);
-  return strtod(s.c_str(), &end_ptr);
+  return strto<T>(s.c_str(), &end_ptr);
 }
 
 template <typename T>
@@ -924,21 +1005,34 @@ std::enable_if_t<is_boolean<T>::value, T> parse(const char *begin, const char *e
 template <typename T>
 std::enable_if_t<is_unsigned<T>::value && is_integral<T>::value && !is_boolean<T>::value, T> parse(const char *begin,
                                                                                                    const char *end) {
-  T result = 0, prev_result = 0;
   if (begin == end) {
     raise_string_cast_error(ndt::make_type<T>(), begin, end);
   }
+
+  const char *saved_begin = begin;
+  uint64_t leading;
+  begin = detail::parse_leading_digits(begin, end, leading);
+  if (is_overflow<T>(leading)) {
+    std::stringstream ss;
+    ss << "overflow converting string ";
+    ss.write(saved_begin, end - saved_begin);
+    ss << " to " << ndt::make_type<T>();
+    throw std::out_of_range(ss.str());
+  }
+
+  T result = static_cast<T>(leading);
   while (begin < end) {
     char c = *begin;
     if ('0' <= c && c <= '9') {
-      result = (result * 10u) + static_cast<T>(c - '0');
-      if (result < prev_result) {
+      T digit = static_cast<T>(c - '0');
+      if (detail::is_mul10_add_overflow(result, digit)) {
         std::stringstream ss;
         ss << "overflow converting string ";
-        ss.write(begin, end - begin);
+        ss.write(saved_begin, end - saved_begin);
         ss << " to " << ndt::make_type<T>();
         throw std::out_of_range(ss.str());
       }
+      result = (result * 10u) + digit;
     } else {
       if (c == '.') {
         // Accept ".", ".0" with trailing decimal zeros as well
@@ -971,19 +1065,17 @@ std::enable_if_t<is_unsigned<T>::value && is_integral<T>::value && !is_boolean<T
             exponent = (10 * exponent) + (*begin++ - '0');
           }
           if (begin == end) {
-            prev_result = result;
             // Apply the exponent in a naive way, but with
             // overflow checking
             for (int i = 0; i < exponent; ++i) {
-              result = result * 10u;
-              if (result < prev_result) {
+              if (detail::is_mul10_add_overflow(result, static_cast<T>(0))) {
                 std::stringstream ss;
                 ss << "overflow converting string ";
-                ss.write(begin, end - begin);
+                ss.write(saved_begin, end - saved_begin);
                 ss << " to " << ndt::make_type<T>();
                 throw std::out_of_range(ss.str());
               }
-              prev_result = result;
+              result = result * 10u;
             }
             return result;
           }
@@ -996,7 +1088,6 @@ std::enable_if_t<is_unsigned<T>::value && is_integral<T>::value && !is_boolean<T
       throw std::invalid_argument(ss.str());
     }
     ++begin;
-    prev_result = result;
   }
 
   return result;
@@ -1069,10 +1160,16 @@ std::enable_if_t<is_floating_point<T>::value, T> parse(const char *begin, const
     }
   }
 
-  // TODO: use http://www.netlib.org/fp/dtoa.c
+  T value;
+  if (parse_decimal_float(begin, end, value)) {
+    return value;
+  }
+
+  // Anything else is left to strtod, which needs a NUL terminator
   char *end_ptr;
-  T value = strto<T>(begin, &end_ptr);
-  if (end_ptr - begin != end - begin) {
+  std::string s(begin, end);
+  value = strto<T>(s.c_str(), &end_ptr);
+  if (end_ptr != s.c_str() + s.size()) {
     std::stringstream ss;
     ss << "parse error converting string ";
     ss.write(begin, end - begin);
@@ -18,5 +18,15 @@ namespace nd {
    */
   extern DYND_API callable binary_search;
 
+  /**
+   * Finds where each of a dimension of needles would go in a sorted
+   * dimension, to keep it sorted.
+   *
+   * \returns  For each needle, the first index whose value is not less than it,
+   *           or with the keyword ``side`` set to "right", the first index whose
+   *           value is greater than it.
+   */
+  extern DYND_API callable searchsorted;
+
 } // namespace dynd::nd
 } // namespace dynd
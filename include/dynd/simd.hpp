@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/config.hpp>
+#include <dynd/types/type_id.hpp>
+
+namespace dynd {
+namespace simd {
+
+  /**
+   * The vector instruction sets which the arithmetic loops are compiled for,
+   * ordered so that each one is a superset of the previous.
+   */
+  enum instruction_set { isa_none, isa_sse2, isa_avx2, isa_avx512 };
+
+  enum binary_op { op_add, op_subtract, op_multiply, op_divide };
+
+  /**
+   * A loop computing ``count`` elements of ``dst = src0 op src1`` where ``dst`` is
+   * contiguous, and each source stride is either the element size or zero.
+   */
+  typedef void (*binary_loop_t)(char *dst, char *const *src, const intptr_t *src_stride, size_t count);
+
+  /**
+   * Returns the best instruction set supported by the CPU and the operating system,
+   * as reported by CPUID.
+   */
+  DYND_API instruction_set detect_instruction_set();
+
+  /**
+   * Returns the instruction set used by kernels created from now on. This starts as
+   * the detected one.
+   */
+  DYND_API instruction_set get_instruction_set();
+
+  /**
+   * Sets the instruction set used by kernels created from now on, limited to the
+   * detected one. This is mostly useful for testing and benchmarking.
+   */
+  DYND_API void set_instruction_set(instruction_set isa);
+
+  /**
+   * Returns the vectorized loop for ``op`` on two arguments of type ``id`` which
+   * produce a result of the same type, or NULL if there is none for the current
+   * instruction set.
+   */
+  DYND_API binary_loop_t get_binary_loop(binary_op op, type_id_t id);
+
+  /**
+   * A loop returning the index of the first occurrence of the ``m`` bytes of
+   * ``needle`` in the ``n`` bytes of ``haystack``, or -1 if there is none. The
+   * needle has at least two bytes.
+   */
+  typedef intptr_t (*find_loop_t)(const char *haystack, size_t n, const char *needle, size_t m);
+
+  /**
+   * Returns the vectorized substring search for the current instruction set, or
+   * NULL if there is none.
+   */
+  DYND_API find_loop_t get_find_loop();
+
+  /**
+   * A loop classifying the 64 bytes at ``data`` for the JSON parser. It sets bit
+   * ``i`` of ``masks[0]`` if byte ``i`` is a double quote, of ``masks[1]`` if it
+   * is a backslash, of ``masks[2]`` if it is one of ``{}[]:,`` and of ``masks[3]``
+   * if it is whitespace.
+   */
+  typedef void (*json_classify_loop_t)(const char *data, uint64_t *masks);
+
+  /**
+   * Returns the vectorized JSON classification for the current instruction set,
+   * or NULL if there is none.
+   */
+  DYND_API json_classify_loop_t get_json_classify_loop();
+
+} // namespace dynd::simd
+} // namespace dynd
@@ -11,7 +11,33 @@ namespace dynd {
 namespace nd {
 
   extern DYND_API callable sort;
+
+  /**
+   * Returns the ``intptr`` indices which sort a dimension, without moving its
+   * elements, so ``nd::take(a, nd::argsort(a))`` is ``a`` sorted. With the
+   * keyword ``stable``, equal elements keep their order; integers and
+   * floating point values always do.
+   */
+  extern DYND_API callable argsort;
+
+  /**
+   * Returns the distinct values of a dimension, in the order they first
+   * appear, as ``var * T``. It hashes the values, so they need not be sorted.
+   */
   extern DYND_API callable unique;
 
+  /**
+   * Returns ``{values: var * T, counts: var * intptr}``, the distinct values
+   * of a dimension, in the order they first appear, and how often each does.
+   */
+  extern DYND_API callable value_counts;
+
+  /**
+   * Returns ``{codes: N * intptr, uniques: var * T}``, where the distinct
+   * values of a dimension are in ``uniques``, in the order they first appear,
+   * and ``codes`` has the index in ``uniques`` of every element.
+   */
+  extern DYND_API callable factorize;
+
 } // namespace dynd::nd
 } // namespace dynd
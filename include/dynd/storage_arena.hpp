@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * A bump allocator for the call graphs and kernels which only live for the
+ * duration of one call. Blocks are taken from the top of a chunk, the block on
+ * top can grow in place, and once every block has been given back the arena
+ * rewinds to the start of its memory, so the next call reuses it.
+ *
+ * Each thread has its own arena, see ``storage_arena::get``. A block must be
+ * given back on the thread which took it, before that thread exits, so storage
+ * which outlives a call, like that of cached kernels, comes from the heap.
+ */
+class DYND_API storage_arena {
+  struct chunk {
+    char *data;
+    size_t capacity;
+  };
+
+  // The chunk on top is the last one
+  std::vector<chunk> m_chunks;
+  size_t m_top;
+  // The number of blocks not given back yet, and the bytes they take
+  size_t m_nblocks;
+  size_t m_used;
+  size_t m_peak;
+
+  void rewind();
+
+public:
+  /**
+   * The size of the first chunk, and the least size of every later one.
+   */
+  static const size_t chunk_size = 16384;
+
+  storage_arena();
+
+  // non-copyable
+  storage_arena(const storage_arena &) = delete;
+
+  ~storage_arena();
+
+  /**
+   * Takes a block of ``size`` bytes, aligned to 16 bytes.
+   */
+  void *allocate(size_t size);
+
+  /**
+   * Grows the block at ``ptr`` from ``old_size`` to ``new_size`` bytes, returning
+   * false if it is not on top of the arena, or there is no room for it to grow.
+   */
+  bool grow(void *ptr, size_t old_size, size_t new_size);
+
+  /**
+   * Gives back the block at ``ptr``, which was taken with ``size`` bytes.
+   */
+  void deallocate(void *ptr, size_t size);
+
+  /**
+   * The number of bytes taken by the blocks not given back yet.
+   */
+  size_t used() const { return m_used; }
+
+  /**
+   * The most bytes taken at once since the arena was created, or the peak was reset.
+   */
+  size_t peak() const { return m_peak; }
+
+  void reset_peak() { m_peak = m_used; }
+
+  /**
+   * The bytes reserved by the arena.
+   */
+  size_t capacity() const;
+
+  /**
+   * The arena of the calling thread.
+   */
+  static storage_arena &get();
+};
+
+} // namespace dynd
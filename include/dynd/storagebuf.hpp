@@ -10,6 +10,7 @@
 #include <map>
 #include <new>
 
+#include <dynd/storage_arena.hpp>
 #include <dynd/visibility.hpp>
 
 namespace dynd {
@@ -21,6 +22,8 @@ protected:
   char *m_data;
   intptr_t m_capacity;
   intptr_t m_size;
+  // Where the data comes from once it outgrows the static data, or NULL for the heap
+  storage_arena *m_arena;
 
   // When the amount of data is small, this static data is used,
   // otherwise dynamic memory is allocated when it gets too big
@@ -29,7 +32,8 @@ protected:
   bool using_static_data() const { return m_data == &m_static_data[0]; }
 
 public:
-  storagebuf() : m_data(m_static_data), m_capacity(sizeof(m_static_data)), m_size(0) {
+  storagebuf(storage_arena *arena = NULL)
+      : m_data(m_static_data), m_capacity(sizeof(m_static_data)), m_size(0), m_arena(arena) {
     set(m_static_data, 0, sizeof(m_static_data));
   }
 
@@ -39,6 +43,8 @@ public:
     }
   }
 
+  storage_arena *get_arena() const { return m_arena; }
+
   size_t size() const { return m_size; }
 
   size_t capacity() const { return m_capacity; }
@@ -57,23 +63,38 @@ public:
       if (requested_capacity < grown_capacity) {
         requested_capacity = grown_capacity;
       }
-      // Do a realloc
+      // Do a realloc, the new capacity is cleared as it gets used
       char *new_data = reinterpret_cast<char *>(realloc(m_data, m_capacity, requested_capacity));
       if (new_data == NULL) {
         reinterpret_cast<DerivedType *>(this)->destroy();
         m_data = NULL;
         throw std::bad_alloc();
       }
-      // Zero out the newly allocated capacity
-      set(reinterpret_cast<char *>(new_data) + m_capacity, 0, requested_capacity - m_capacity);
       m_data = new_data;
       m_capacity = requested_capacity;
     }
   }
 
-  void *alloc(size_t size) { return std::malloc(size); }
+  void *alloc(size_t size) {
+    if (m_arena != NULL) {
+      return m_arena->allocate(size);
+    }
+
+    return std::malloc(size);
+  }
 
   void *realloc(void *ptr, size_t old_size, size_t new_size) {
+    if (m_arena != NULL && !using_static_data()) {
+      if (m_arena->grow(ptr, old_size, new_size)) {
+        return ptr;
+      }
+
+      void *new_data = m_arena->allocate(new_size);
+      copy(new_data, ptr, old_size);
+      m_arena->deallocate(ptr, old_size);
+      return new_data;
+    }
+
     if (using_static_data()) {
       // If we were previously using the static data, do a malloc
       void *new_data = alloc(new_size);
@@ -89,7 +110,11 @@ public:
 
   void free(void *ptr) {
     if (!using_static_data()) {
-      std::free(ptr);
+      if (m_arena != NULL) {
+        m_arena->deallocate(ptr, m_capacity);
+      } else {
+        std::free(ptr);
+      }
     }
   }
 
@@ -125,7 +150,7 @@ public:
 
     size_t offset = m_size;
     m_size += aligned_size(sizeof(KernelType));
-    reserve(m_size);
+    clear_from(offset);
 
     KernelType::init(this->get_at<KernelType>(offset), std::forward<ArgTypes>(args)...);
   }
@@ -137,14 +162,25 @@ public:
 
     size_t offset = m_size;
     m_size += aligned_size(sizeof(PrefixType)) + aligned_size(sizeof(KernelType));
-    reserve(m_size);
+    clear_from(offset);
 
     PrefixType::template init<KernelType>(this->get_at<PrefixType>(offset), std::forward<ArgTypes>(args)...);
   }
 
   void emplace_back(size_t size) {
+    size_t offset = m_size;
     m_size += aligned_size(size);
-    reserve(m_size);
+    clear_from(offset);
+  }
+
+  /**
+   * Reserves and clears the storage from ``offset`` to the end, and one prefix
+   * past it, which is where the next child goes. A parent whose child failed
+   * to instantiate then finds a null destructor there.
+   */
+  void clear_from(size_t offset) {
+    reserve(m_size + sizeof(PrefixType));
+    set(m_data + offset, 0, m_size + sizeof(PrefixType) - offset);
   }
 };
 
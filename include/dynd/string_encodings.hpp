@@ -98,6 +98,24 @@ get_next_unicode_codepoint_function(string_encoding_t encoding, assign_error_mod
 DYNDT_API append_unicode_codepoint_t
 get_append_unicode_codepoint_function(string_encoding_t encoding, assign_error_mode errmode);
 
+/**
+ * Typedef for converting a run of code points from one encoding to another in
+ * bulk, which is much faster than a next and an append function per code point.
+ *
+ * On entry, this function assumes that 'src', 'src_end', 'dst' and 'dst_end'
+ * are appropriately aligned. It converts code points until the source ends, or
+ * until the next one is NUL, is invalid, cannot be represented in the destination
+ * encoding or does not fit before 'dst_end'. Both 'src' and 'dst' are updated
+ * in-place to be after the converted data, so the code point it stopped at can
+ * be handled with the next and append functions for the error mode.
+ *
+ * This function does not raise exceptions.
+ */
+typedef void (*transcode_unicode_t)(const char *&src, const char *src_end, char *&dst, char *dst_end);
+
+DYNDT_API transcode_unicode_t get_transcode_unicode_function(string_encoding_t src_encoding,
+                                                             string_encoding_t dst_encoding);
+
 /**
  * Converts a string buffer provided as a range of bytes into a std::string as UTF8.
  */
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <dynd/simd.hpp>
+
 ////////////////////////////////////////////////////////////
 // String algorithms
 
@@ -108,6 +110,21 @@ namespace detail {
       return;
     }
 
+    /* with vector instructions, the first and last characters of the needle
+       are compared at many positions at once */
+    simd::find_loop_t find_loop = simd::get_find_loop();
+    if (find_loop != NULL) {
+      size_t start = 0;
+      while (start + m <= n) {
+        intptr_t i = find_loop(s + start, n - start, p, m);
+        if (i < 0 || handle_match(start + i)) {
+          return;
+        }
+        start += i + m;
+      }
+      return;
+    }
+
     intptr_t mlast = m - 1;
     intptr_t skip = mlast - 1;
 
@@ -146,7 +163,9 @@ namespace detail {
           if (handle_match(i)) {
             return;
           }
+          /* the next match can start right after this one */
           i = i + mlast;
+          continue;
         }
         /* miss: check if next character is part of pattern */
         if (i < w && !bloom.has_char(ss[i + 1])) {
@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * A pool of worker threads owned by the library, used by kernels which split their
+ * work into independent chunks. Workers are started lazily, the first time a parallel
+ * region asks for more threads than the pool currently has.
+ *
+ * Only one parallel region runs at a time. A parallel region started from inside
+ * another one runs sequentially on the calling thread, so nested parallel kernels
+ * never deadlock.
+ */
+class DYND_API thread_pool {
+  // Serializes parallel regions started from different threads
+  std::mutex m_region_mutex;
+
+  // Guards everything below
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::vector<std::thread> m_threads;
+  bool m_stop;
+
+  // The current parallel region
+  size_t m_generation;
+  const std::function<void(size_t)> *m_func;
+  size_t m_ntasks;
+  std::atomic<size_t> m_next;
+  size_t m_slots;
+  size_t m_pending;
+  std::exception_ptr m_error;
+
+  void run_tasks();
+
+  void work(size_t generation);
+
+public:
+  thread_pool();
+
+  // non-copyable
+  thread_pool(const thread_pool &) = delete;
+
+  ~thread_pool();
+
+  /**
+   * The number of worker threads started so far.
+   */
+  size_t size();
+
+  /**
+   * Calls ``func(i)`` for each ``i`` in ``[0, ntasks)``, using up to ``ntasks - 1`` workers
+   * in addition to the calling thread. Blocks until every call has returned, then rethrows
+   * the first exception raised by any of them.
+   */
+  void parallel_for(size_t ntasks, const std::function<void(size_t)> &func);
+
+  /**
+   * Returns the thread pool owned by the library.
+   */
+  static thread_pool &get();
+
+  /**
+   * Returns true if the calling thread is executing a task of a parallel region.
+   */
+  static bool in_parallel_region();
+};
+
+} // namespace dynd
@@ -180,7 +180,9 @@ public:
   void resize(size_t new_size) {
     reserve(new_size);
     if (is_sso()) {
-      m_size = static_cast<int64_t>(static_cast<uint64_t>(m_size) | (static_cast<uint64_t>(new_size) << 56));
+      // The size replaces the last byte, whose other bytes are data
+      m_size = static_cast<int64_t>((static_cast<uint64_t>(m_size) & ((static_cast<uint64_t>(1) << 56) - 1)) |
+                                    (static_cast<uint64_t>(new_size) << 56));
       // Always keep the unused SSO bytes as 0 for unique representation and NUL-padding when that is enabled
       memset(sso_data() + new_size, 0, 15u - new_size);
     } else {
@@ -886,37 +886,23 @@ nd::array nd::reshape(const nd::array &a, const nd::array &shape) {
                                       NULL);
 }
 
-nd::array nd::memmap(const std::string &DYND_UNUSED(filename), intptr_t DYND_UNUSED(begin), intptr_t DYND_UNUSED(end),
-                     uint32_t DYND_UNUSED(access)) {
-  throw std::runtime_error("nd::memmap is not yet implemented");
-
-  /*
-    // ToDo: This was based on the variable-sized bytes type, which changed.
-
-    if (access == 0) {
-      access = nd::default_access_flags;
-    }
+nd::array nd::memmap(const std::string &filename, intptr_t begin, intptr_t end, uint32_t access,
+                     const memmap_options &options) {
+  char *mm_ptr = NULL;
+  intptr_t mm_size = 0;
+  memory_block mm = make_memory_block<memmap_memory_block>(filename, access, &mm_ptr, &mm_size, begin, end, options);
+  if (mm_size == 0) {
+    stringstream ss;
+    ss << "nd::memmap of file \"" << filename << "\" cannot view an empty range, as there is no fixed_bytes[0] type";
+    throw runtime_error(ss.str());
+  }
 
-    char *mm_ptr = NULL;
-    intptr_t mm_size = 0;
-    // Create a memory mapped memblock of the file
-    intrusive_ptr<memory_block_data> mm = make_memmap_memory_block(filename, access, &mm_ptr, &mm_size, begin, end);
-    // Create a bytes array referring to the data.
-    ndt::type dt = ndt::make_type<ndt::bytes_type>(1);
-    char *data_ptr = 0;
-    nd::array result(make_array(dt.extended()->get_arrmeta_size(), dt.get_data_size(),
-                                             dt.get_data_alignment(), &data_ptr));
-    // Set the bytes extents
-    reinterpret_cast<bytes *>(data_ptr)->assign(mm_ptr, mm_size);
-    // Set the array arrmeta
-    array_preamble *ndo = result.get();
-    ndo->set_type(dt);
-    ndo->flags = access;
-    // Set the bytes arrmeta, telling the system
-    // about the memmapped memblock
-    ndo_meta->blockref = mm.release();
-    return result;
-  */
+  // The array views the mapped memory, which only a private map can write
+  uint64_t flags = read_access_flag;
+  if (options.copy_on_write) {
+    flags |= access & write_access_flag;
+  }
+  return make_array(ndt::make_type<ndt::fixed_bytes_type>(mm_size, 1), mm_ptr, mm, flags);
 }
 
 nd::array nd::combine_into_tuple(size_t field_count, const array *field_values) {
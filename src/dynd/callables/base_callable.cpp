@@ -5,27 +5,50 @@
 
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/callables/call_graph.hpp>
+#include <dynd/kernels/kernel_cache.hpp>
 
 using namespace std;
 using namespace dynd;
 
-nd::base_callable::~base_callable() {}
+nd::base_callable::~base_callable() { kernel_cache::get().erase(this); }
 
 nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp,
                                   const char *const *src_arrmeta, char *const *src_data, size_t nkwd, const array *kwds,
                                   const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  dst_tp = resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
-
-  // Allocate the destination array
-  array dst = alloc(&dst_tp);
-
-  // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
-  kb(kernel_request_single, nullptr, dst->metadata(), nsrc, src_arrmeta);
-
-  kernel_single_t fn = kb.get()->get_function<kernel_single_t>();
-  fn(kb.get(), dst.data(), src_data);
+  kernel_cache &cache = kernel_cache::get();
+  kernel_cache::key_type key;
+  bool cacheable =
+      cache.make_key(key, this, kernel_request_single, dst_tp, nullptr, nsrc, src_tp, src_arrmeta, nkwd, kwds, tp_vars);
+
+  unique_ptr<kernel_cache::entry_type> entry;
+  if (cacheable) {
+    entry = cache.take(key);
+  }
+
+  array dst;
+  if (entry) {
+    dst_tp = entry->dst_tp;
+    dst = alloc(&dst_tp);
+  } else {
+    // A kernel which is not cached only lives for this call, so its storage comes from the arena of the thread
+    entry.reset(new kernel_cache::entry_type(cacheable ? NULL : &storage_arena::get()));
+    dst_tp = resolve(nullptr, nullptr, entry->cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+    entry->dst_tp = dst_tp;
+
+    // Allocate the destination array
+    dst = alloc(&dst_tp);
+
+    // Generate the ckernel
+    entry->instantiate(kernel_request_single, dst->metadata(), nsrc, src_tp, src_arrmeta);
+  }
+
+  // Evaluate the ckernel
+  kernel_single_t fn = entry->kb->get()->get_function<kernel_single_t>();
+  fn(entry->kb->get(), dst.data(), src_data);
+
+  if (cacheable) {
+    cache.put(std::move(key), std::move(entry));
+  }
 
   return dst;
 }
@@ -33,18 +56,39 @@ nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::typ
 nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp,
                                   const char *const *src_arrmeta, const array *src_data, size_t nkwd, const array *kwds,
                                   const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  dst_tp = resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
-
-  // Allocate the destination array
-  array dst = empty(dst_tp);
-
-  // Generate and evaluate the kernel
-  kernel_builder kb(cg.get());
-  kb(kernel_request_call, nullptr, dst->metadata(), nsrc, src_arrmeta);
-
-  kernel_call_t fn = kb.get()->get_function<kernel_call_t>();
-  fn(kb.get(), &dst, src_data);
+  kernel_cache &cache = kernel_cache::get();
+  kernel_cache::key_type key;
+  bool cacheable =
+      cache.make_key(key, this, kernel_request_call, dst_tp, nullptr, nsrc, src_tp, src_arrmeta, nkwd, kwds, tp_vars);
+
+  unique_ptr<kernel_cache::entry_type> entry;
+  if (cacheable) {
+    entry = cache.take(key);
+  }
+
+  array dst;
+  if (entry) {
+    dst_tp = entry->dst_tp;
+    dst = empty(dst_tp);
+  } else {
+    entry.reset(new kernel_cache::entry_type(cacheable ? NULL : &storage_arena::get()));
+    dst_tp = resolve(nullptr, nullptr, entry->cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+    entry->dst_tp = dst_tp;
+
+    // Allocate the destination array
+    dst = empty(dst_tp);
+
+    // Generate the kernel
+    entry->instantiate(kernel_request_call, dst->metadata(), nsrc, src_tp, src_arrmeta);
+  }
+
+  // Evaluate the kernel
+  kernel_call_t fn = entry->kb->get()->get_function<kernel_call_t>();
+  fn(entry->kb->get(), &dst, src_data);
+
+  if (cacheable) {
+    cache.put(std::move(key), std::move(entry));
+  }
 
   return dst;
 }
@@ -52,27 +96,61 @@ nd::array nd::base_callable::call(ndt::type &dst_tp, size_t nsrc, const ndt::typ
 void nd::base_callable::call(const ndt::type &dst_tp, const char *dst_arrmeta, char *dst_data, size_t nsrc,
                              const ndt::type *src_tp, const char *const *src_arrmeta, char *const *src_data,
                              size_t nkwd, const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
-
-  // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
-  kb(kernel_request_single, nullptr, dst_arrmeta, nsrc, src_arrmeta);
-
-  kernel_single_t fn = kb.get()->get_function<kernel_single_t>();
-  fn(kb.get(), dst_data, src_data);
+  kernel_cache &cache = kernel_cache::get();
+  kernel_cache::key_type key;
+  bool cacheable = cache.make_key(key, this, kernel_request_single, dst_tp, dst_arrmeta, nsrc, src_tp, src_arrmeta,
+                                  nkwd, kwds, tp_vars);
+
+  unique_ptr<kernel_cache::entry_type> entry;
+  if (cacheable) {
+    entry = cache.take(key);
+  }
+
+  if (!entry) {
+    entry.reset(new kernel_cache::entry_type(cacheable ? NULL : &storage_arena::get()));
+    resolve(nullptr, nullptr, entry->cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+    entry->dst_tp = dst_tp;
+
+    // Generate the ckernel
+    entry->instantiate(kernel_request_single, dst_arrmeta, nsrc, src_tp, src_arrmeta);
+  }
+
+  // Evaluate the ckernel
+  kernel_single_t fn = entry->kb->get()->get_function<kernel_single_t>();
+  fn(entry->kb->get(), dst_data, src_data);
+
+  if (cacheable) {
+    cache.put(std::move(key), std::move(entry));
+  }
 }
 
 void nd::base_callable::call(const ndt::type &dst_tp, const char *dst_arrmeta, array *dst, size_t nsrc,
                              const ndt::type *src_tp, const char *const *src_arrmeta, const array *src, size_t nkwd,
                              const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
-  call_graph cg;
-  resolve(nullptr, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
-
-  // Generate and evaluate the ckernel
-  kernel_builder kb(cg.get());
-  kb(kernel_request_call, nullptr, dst_arrmeta, nsrc, src_arrmeta);
-
-  kernel_call_t fn = kb.get()->get_function<kernel_call_t>();
-  fn(kb.get(), dst, src);
+  kernel_cache &cache = kernel_cache::get();
+  kernel_cache::key_type key;
+  bool cacheable = cache.make_key(key, this, kernel_request_call, dst_tp, dst_arrmeta, nsrc, src_tp, src_arrmeta,
+                                  nkwd, kwds, tp_vars);
+
+  unique_ptr<kernel_cache::entry_type> entry;
+  if (cacheable) {
+    entry = cache.take(key);
+  }
+
+  if (!entry) {
+    entry.reset(new kernel_cache::entry_type(cacheable ? NULL : &storage_arena::get()));
+    resolve(nullptr, nullptr, entry->cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+    entry->dst_tp = dst_tp;
+
+    // Generate the ckernel
+    entry->instantiate(kernel_request_call, dst_arrmeta, nsrc, src_tp, src_arrmeta);
+  }
+
+  // Evaluate the ckernel
+  kernel_call_t fn = entry->kb->get()->get_function<kernel_call_t>();
+  fn(entry->kb->get(), dst, src);
+
+  if (cacheable) {
+    cache.put(std::move(key), std::move(entry));
+  }
 }
@@ -0,0 +1,522 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <dynd/csv_parser.hpp>
+#include <dynd/option.hpp>
+#include <dynd/parse.hpp>
+#include <dynd/thread_pool.hpp>
+#include <dynd/types/base_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// The smallest number of bytes of delimited text given to a thread
+static const intptr_t min_csv_chunk_size = 65536;
+
+namespace {
+
+/**
+ * Where the values of a column go. The value of row ``i`` is written at
+ * ``data + i * stride``.
+ */
+struct csv_column {
+  ndt::type tp;
+  const char *arrmeta;
+  char *data;
+  intptr_t stride;
+  const std::string *name;
+};
+
+} // anonymous namespace
+
+/**
+ * Returns the newline which ends the row starting at ``begin``, or the end.
+ * Newlines within quotes are part of the row. ``in_quote`` says whether
+ * ``begin`` is within quotes.
+ */
+static const char *find_row_end(const char *begin, const char *end, char quote, bool in_quote = false) {
+  for (;;) {
+    const char *line_end = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+    if (line_end == NULL) {
+      return end;
+    }
+    for (const char *it = begin; (it = reinterpret_cast<const char *>(memchr(it, quote, line_end - it))) != NULL;
+         ++it) {
+      in_quote = !in_quote;
+    }
+    if (!in_quote) {
+      return line_end;
+    }
+    begin = line_end + 1;
+  }
+}
+
+/**
+ * Finds the next row which is not blank, setting ``begin`` to its start and
+ * ``row_end`` to its end without the line terminator. Returns false if there
+ * are no more rows.
+ */
+static bool next_row(const char *&begin, const char *end, char quote, const char *&row_end) {
+  for (;;) {
+    if (begin == end) {
+      return false;
+    }
+    row_end = find_row_end(begin, end, quote);
+    const char *content_end = (row_end > begin && row_end[-1] == '\r') ? row_end - 1 : row_end;
+    if (content_end != begin) {
+      row_end = content_end;
+      return true;
+    }
+    begin = (row_end == end) ? end : row_end + 1;
+  }
+}
+
+/**
+ * Returns the start of the row after the one ending at ``row_end``.
+ */
+static const char *skip_row_end(const char *row_end, const char *end) {
+  if (row_end != end && *row_end == '\r') {
+    ++row_end;
+  }
+  return (row_end == end) ? end : row_end + 1;
+}
+
+/**
+ * Parses the field at ``begin``, within a row ending at ``row_end``. Sets the
+ * range of its text, without the quotes if it has any, and whether it has a
+ * quote written twice in it. Moves ``begin`` past the delimiter after it, and
+ * returns whether there was one, so another field follows.
+ */
+static bool parse_field(const char *&begin, const char *row_end, const nd::csv::read_options &options,
+                        const char *&out_begin, const char *&out_end, bool &out_escaped) {
+  out_escaped = false;
+  const char *it;
+  if (begin != row_end && *begin == options.quote) {
+    it = begin + 1;
+    for (;;) {
+      it = reinterpret_cast<const char *>(memchr(it, options.quote, row_end - it));
+      if (it == NULL) {
+        throw parse_error(begin, "missing the closing quote of a field");
+      }
+      if (it + 1 == row_end || it[1] != options.quote) {
+        break;
+      }
+      out_escaped = true;
+      it += 2;
+    }
+    out_begin = begin + 1;
+    out_end = it++;
+    if (it != row_end && *it != options.delimiter) {
+      throw parse_error(it, "expected a delimiter after the closing quote of a field");
+    }
+  } else {
+    it = reinterpret_cast<const char *>(memchr(begin, options.delimiter, row_end - begin));
+    if (it == NULL) {
+      it = row_end;
+    }
+    out_begin = begin;
+    out_end = it;
+  }
+
+  if (it == row_end) {
+    begin = row_end;
+    return false;
+  }
+  begin = it + 1;
+  return true;
+}
+
+/**
+ * Parses the field at ``begin`` as ``parse_field`` does, replacing every quote
+ * written twice within it with one in ``buffer``.
+ */
+static bool parse_unescaped_field(const char *&begin, const char *row_end, const nd::csv::read_options &options,
+                                  std::string &buffer, const char *&out_begin, const char *&out_end) {
+  bool escaped;
+  bool more = parse_field(begin, row_end, options, out_begin, out_end, escaped);
+  if (escaped) {
+    buffer.clear();
+    for (const char *it = out_begin; it != out_end; ++it) {
+      buffer.push_back(*it);
+      if (*it == options.quote) {
+        ++it;
+      }
+    }
+    out_begin = buffer.data();
+    out_end = buffer.data() + buffer.size();
+  }
+  return more;
+}
+
+/**
+ * Converts the text of a field to a value of type ``tp`` with the same
+ * parsers as the JSON parser. Whitespace around values which are not strings
+ * is ignored.
+ */
+static void parse_value(const ndt::type &tp, const char *arrmeta, char *out_data, const char *begin, const char *end,
+                        const eval::eval_context *ectx) {
+  const ndt::type &value_tp = (tp.get_id() == option_id) ? tp.extended<ndt::option_type>()->get_value_type() : tp;
+  if (value_tp.get_base_id() != string_kind_id) {
+    skip_whitespace(begin, end);
+    while (end != begin && DYND_ISSPACE(end[-1])) {
+      --end;
+    }
+  }
+
+  switch (tp.get_id()) {
+  case option_id:
+    nd::set_option_from_utf8_string(tp, arrmeta, out_data, begin, end, ectx);
+    return;
+  case bool_id:
+    if (ectx->errmode == assign_error_nocheck) {
+      *out_data = parse<bool>(begin, end, nocheck);
+    } else {
+      *out_data = parse<bool>(begin, end);
+    }
+    return;
+  default:
+    if (tp.is_builtin()) {
+      string_to_number(out_data, tp.get_id(), begin, end, ectx->errmode);
+    } else {
+      tp.extended()->set_from_utf8_string(arrmeta, out_data, begin, end, ectx);
+    }
+    return;
+  }
+}
+
+/**
+ * Parses the fields of the row between ``begin`` and ``row_end`` into element
+ * ``i`` of every column.
+ */
+static void parse_row(const std::vector<csv_column> &columns, intptr_t i, const char *begin, const char *row_end,
+                      const nd::csv::read_options &options, std::string &buffer, const eval::eval_context *ectx) {
+  size_t ncolumns = columns.size();
+  bool more = true;
+  for (size_t j = 0; j < ncolumns; ++j) {
+    if (!more) {
+      stringstream ss;
+      ss << "expected " << ncolumns << " fields in the row, found " << j;
+      throw parse_error(row_end, ss.str());
+    }
+    const char *field_begin = begin, *strbegin, *strend;
+    more = parse_unescaped_field(begin, row_end, options, buffer, strbegin, strend);
+
+    const csv_column &c = columns[j];
+    try {
+      parse_value(c.tp, c.arrmeta, c.data + i * c.stride, strbegin, strend, ectx);
+    } catch (const std::exception &e) {
+      throw parse_error(field_begin, "field \"" + *c.name + "\": " + e.what());
+    } catch (const dynd::dynd_exception &e) {
+      throw parse_error(field_begin, "field \"" + *c.name + "\": " + e.what());
+    }
+  }
+  if (more) {
+    stringstream ss;
+    ss << "expected " << ncolumns << " fields in the row, found more";
+    throw parse_error(begin, ss.str());
+  }
+}
+
+/**
+ * Returns the number of rows between ``begin`` and ``end`` which are not
+ * blank.
+ */
+static intptr_t count_csv_rows(const char *begin, const char *end, char quote) {
+  intptr_t count = 0;
+  const char *row_end;
+  while (next_row(begin, end, quote, row_end)) {
+    ++count;
+    begin = skip_row_end(row_end, end);
+  }
+  return count;
+}
+
+/**
+ * Parses every row between ``begin`` and ``end`` which is not blank into the
+ * columns, starting with element ``i``.
+ */
+static void parse_csv_rows(const std::vector<csv_column> &columns, intptr_t i, const char *begin, const char *end,
+                           const nd::csv::read_options &options, const eval::eval_context *ectx) {
+  std::string buffer;
+  const char *row_end;
+  while (next_row(begin, end, options.quote, row_end)) {
+    parse_row(columns, i++, begin, row_end, options, buffer, ectx);
+    begin = skip_row_end(row_end, end);
+  }
+}
+
+/**
+ * Throws an error raised while parsing delimited text again, with the line and
+ * column where it happened.
+ */
+static void throw_csv_parse_error(const char *begin, const parse_error &e) {
+  const char *position = e.get_position();
+  int line = static_cast<int>(std::count(begin, position, '\n')) + 1;
+  const char *line_begin = position;
+  while (line_begin != begin && line_begin[-1] != '\n') {
+    --line_begin;
+  }
+  stringstream ss;
+  ss << "Error parsing CSV at line " << line << ", column " << (position - line_begin + 1) << "\n";
+  ss << "Message: " << e.what();
+  throw invalid_argument(ss.str());
+}
+
+/**
+ * Skips the header row, if there is one, and returns where the data starts.
+ */
+static const char *skip_csv_header(const char *begin, const char *end, const nd::csv::read_options &options) {
+  const char *row_end;
+  if (options.header && next_row(begin, end, options.quote, row_end)) {
+    return skip_row_end(row_end, end);
+  }
+  return begin;
+}
+
+ndt::type ndt::csv::discover(const char *begin, const char *end, const nd::csv::read_options &options) {
+  // For every column, whether all its values so far could have each type
+  struct column_state {
+    std::string name;
+    bool is_bool, is_int, is_float, has_na;
+  };
+  std::vector<column_state> columns;
+  std::string buffer;
+
+  const char *buffer_begin = begin, *row_end, *strbegin, *strend;
+  try {
+    if (options.header && next_row(begin, end, options.quote, row_end)) {
+      for (bool more = true; more;) {
+        more = parse_unescaped_field(begin, row_end, options, buffer, strbegin, strend);
+        columns.push_back(column_state{std::string(strbegin, strend), true, true, true, false});
+      }
+      begin = skip_row_end(row_end, end);
+    }
+
+    for (intptr_t nrows = 0; nrows < options.sample_rows && next_row(begin, end, options.quote, row_end); ++nrows) {
+      bool more = true;
+      for (size_t j = 0; more; ++j) {
+        more = parse_unescaped_field(begin, row_end, options, buffer, strbegin, strend);
+        if (j == columns.size()) {
+          // Without a header, the first row gives the number of columns
+          if (nrows > 0) {
+            break;
+          }
+          columns.push_back(column_state{"f" + std::to_string(j), true, true, true, false});
+        }
+
+        column_state &c = columns[j];
+        skip_whitespace(strbegin, strend);
+        while (strend != strbegin && DYND_ISSPACE(strend[-1])) {
+          --strend;
+        }
+        if (parse_na(strbegin, strend)) {
+          c.has_na = true;
+          continue;
+        }
+        if (c.is_bool) {
+          c.is_bool = compare_range_to_literal(strbegin, strend, "true") ||
+                      compare_range_to_literal(strbegin, strend, "false") ||
+                      compare_range_to_literal(strbegin, strend, "True") ||
+                      compare_range_to_literal(strbegin, strend, "False");
+        }
+        // Once a value does not parse as a type, the column is not tried as it again
+        if (c.is_int) {
+          try {
+            int64_t value;
+            string_to_number(reinterpret_cast<char *>(&value), int64_id, strbegin, strend, assign_error_default);
+          } catch (...) {
+            c.is_int = false;
+          }
+        }
+        if (c.is_float && !c.is_int) {
+          try {
+            double value;
+            string_to_number(reinterpret_cast<char *>(&value), float64_id, strbegin, strend, assign_error_default);
+          } catch (...) {
+            c.is_float = false;
+          }
+        }
+      }
+      begin = skip_row_end(row_end, end);
+    }
+  } catch (const parse_error &e) {
+    throw_csv_parse_error(buffer_begin, e);
+  }
+
+  std::vector<std::pair<type, std::string>> fields;
+  for (const column_state &c : columns) {
+    type tp;
+    if (c.is_bool && c.is_int) {
+      // No values were seen besides missing ones
+      tp = make_type<ndt::string_type>();
+    } else if (c.is_bool) {
+      tp = make_type<bool1>();
+    } else if (c.is_int) {
+      tp = make_type<int64_t>();
+    } else if (c.is_float) {
+      tp = make_type<double>();
+    } else {
+      tp = make_type<ndt::string_type>();
+    }
+    if (c.has_na && tp.get_id() != string_id) {
+      tp = make_type<ndt::option_type>(tp);
+    }
+    fields.emplace_back(tp, c.name);
+  }
+
+  return make_type<ndt::struct_type>(fields);
+}
+
+nd::array nd::csv::read(const ndt::type &tp, const char *begin, const char *end, const read_options &options,
+                        const eval::eval_context *ectx) {
+  // A struct whose fields are all dimensions holds columns, anything else is the type of a row
+  bool by_column = false;
+  ndt::type row_tp = tp;
+  if (tp.get_base_id() == dim_kind_id) {
+    row_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+  } else if (tp.get_id() == struct_id) {
+    const std::vector<ndt::type> &field_types = tp.extended<ndt::struct_type>()->get_field_types();
+    by_column = !field_types.empty() && std::all_of(field_types.begin(), field_types.end(), [](const ndt::type &ft) {
+      return ft.get_base_id() == dim_kind_id;
+    });
+  }
+  if (row_tp.get_id() != struct_id) {
+    stringstream ss;
+    ss << "nd::csv::read: expected the type of a row, {...}, or of columns, {name: Fixed * T, ...}, not \"" << tp
+       << "\"";
+    throw type_error(ss.str());
+  }
+  const ndt::struct_type *sd = row_tp.extended<ndt::struct_type>();
+  intptr_t ncolumns = sd->get_field_count();
+  std::vector<ndt::type> column_types(ncolumns);
+  for (intptr_t j = 0; j < ncolumns; ++j) {
+    column_types[j] = by_column ? sd->get_field_type(j).extended<ndt::base_dim_type>()->get_element_type()
+                                : sd->get_field_type(j);
+  }
+
+  const char *data_begin = skip_csv_header(begin, end, options);
+
+  // Values which allocate from a memory block in the arrmeta are parsed on a
+  // single thread, as in nd::json::parse_lines
+  intptr_t nchunks = std::max<intptr_t>(std::min<intptr_t>(ectx->nthreads, (end - data_begin) / min_csv_chunk_size), 1);
+  for (const ndt::type &ct : column_types) {
+    if ((ct.get_flags() & type_flag_blockref) != 0) {
+      nchunks = 1;
+    }
+  }
+
+  // Every chunk starts at the beginning of a row. Whether the point where a
+  // chunk would be split is within quotes is found from the number of quotes
+  // before it, which are counted in parallel
+  std::vector<const char *> bounds(nchunks + 1);
+  bounds[0] = data_begin;
+  bounds[nchunks] = end;
+  if (nchunks > 1) {
+    for (intptr_t i = 1; i < nchunks; ++i) {
+      bounds[i] = data_begin + i * (end - data_begin) / nchunks;
+    }
+    std::vector<intptr_t> nquotes(nchunks);
+    thread_pool::get().parallel_for(
+        nchunks, [&](size_t i) { nquotes[i] = std::count(bounds[i], bounds[i + 1], options.quote); });
+    intptr_t quotes_before = 0;
+    for (intptr_t i = 1; i < nchunks; ++i) {
+      quotes_before += nquotes[i - 1];
+      const char *row_end = find_row_end(bounds[i], end, options.quote, quotes_before % 2 != 0);
+      bounds[i] = std::max(skip_row_end(row_end, end), bounds[i - 1]);
+    }
+    for (intptr_t i = nchunks - 1; i > 0; --i) {
+      bounds[i] = std::min(bounds[i], bounds[i + 1]);
+    }
+  }
+
+  // Once the rows of every chunk are counted, each is parsed straight into its
+  // own part of the result
+  std::vector<intptr_t> offsets(nchunks + 1);
+  thread_pool::get().parallel_for(
+      nchunks, [&](size_t i) { offsets[i + 1] = count_csv_rows(bounds[i], bounds[i + 1], options.quote); });
+  for (intptr_t i = 0; i < nchunks; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  intptr_t nrows = offsets[nchunks];
+
+  array result;
+  std::vector<csv_column> columns(ncolumns);
+  if (by_column) {
+    std::vector<ndt::type> result_field_types(ncolumns);
+    for (intptr_t j = 0; j < ncolumns; ++j) {
+      result_field_types[j] = ndt::make_fixed_dim(nrows, column_types[j]);
+    }
+    ndt::type result_tp = ndt::make_type<ndt::struct_type>(sd->get_field_names(), result_field_types);
+    result = empty(result_tp);
+    const ndt::struct_type *result_sd = result_tp.extended<ndt::struct_type>();
+    const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(result.get()->metadata());
+    for (intptr_t j = 0; j < ncolumns; ++j) {
+      const char *column_arrmeta = result.get()->metadata() + result_sd->get_arrmeta_offset(j);
+      columns[j].tp = column_types[j];
+      columns[j].arrmeta = column_arrmeta + sizeof(fixed_dim_type_arrmeta);
+      columns[j].data = result.data() + data_offsets[j];
+      columns[j].stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(column_arrmeta)->stride;
+    }
+  } else {
+    result = empty(ndt::make_fixed_dim(nrows, row_tp));
+    const char *row_arrmeta = result.get()->metadata() + sizeof(fixed_dim_type_arrmeta);
+    const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(row_arrmeta);
+    for (intptr_t j = 0; j < ncolumns; ++j) {
+      columns[j].tp = column_types[j];
+      columns[j].arrmeta = row_arrmeta + sd->get_arrmeta_offset(j);
+      columns[j].data = result.data() + data_offsets[j];
+      columns[j].stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(result.get()->metadata())->stride;
+    }
+  }
+  for (intptr_t j = 0; j < ncolumns; ++j) {
+    columns[j].name = &sd->get_field_name(j);
+  }
+
+  // The error on the earliest row is the one reported
+  std::vector<std::exception_ptr> errors(nchunks);
+  thread_pool::get().parallel_for(nchunks, [&](size_t i) {
+    try {
+      parse_csv_rows(columns, offsets[i], bounds[i], bounds[i + 1], options, ectx);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  });
+  for (const std::exception_ptr &error : errors) {
+    if (error) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const parse_error &e) {
+        throw_csv_parse_error(begin, e);
+      }
+    }
+  }
+
+  if (!result.get_type().is_builtin()) {
+    result.get_type().extended()->arrmeta_finalize_buffers(result.get()->metadata());
+  }
+  return result;
+}
+
+nd::array nd::csv::read(const ndt::type &tp, const array &buffer, const read_options &options,
+                        const eval::eval_context *ectx) {
+  const char *begin = NULL, *end = NULL;
+  array tmp_ref;
+  parse_as_buffer(buffer, tmp_ref, begin, end, "CSV");
+  return read(tp, begin, end, options, ectx);
+}
+
+nd::array nd::csv::read(const array &buffer, const read_options &options, const eval::eval_context *ectx) {
+  const char *begin = NULL, *end = NULL;
+  array tmp_ref;
+  parse_as_buffer(buffer, tmp_ref, begin, end, "CSV");
+  return read(ndt::csv::discover(begin, end, options), begin, end, options, ectx);
+}
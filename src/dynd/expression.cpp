@@ -0,0 +1,185 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+#include <mutex>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/expression.hpp>
+#include <dynd/functional.hpp>
+
+using namespace std;
+using namespace dynd;
+
+struct nd::expression::node {
+  // A value has no child
+  array value;
+  callable child;
+  std::vector<std::shared_ptr<const node>> args;
+};
+
+namespace {
+
+typedef std::shared_ptr<const nd::expression::node> node_ptr;
+
+/**
+ * The plan of an expression, with every distinct value and operation numbered
+ * as in ``nd::functional::fuse``.
+ */
+struct plan {
+  std::vector<nd::array> values;
+  std::vector<nd::functional::fuse_stage> stages;
+
+  std::map<const void *, intptr_t> visited;
+  std::map<const void *, intptr_t> value_index;
+  std::map<std::pair<const void *, std::vector<intptr_t>>, intptr_t> stage_index;
+
+  intptr_t add(const node_ptr &n) {
+    auto it = visited.find(n.get());
+    if (it != visited.end()) {
+      return it->second;
+    }
+
+    intptr_t i;
+    if (n->child.is_null()) {
+      auto value_it = value_index.find(n->value.get());
+      if (value_it == value_index.end()) {
+        value_it = value_index.emplace(n->value.get(), values.size()).first;
+        values.push_back(n->value);
+      }
+      i = value_it->second;
+    } else {
+      std::vector<intptr_t> args;
+      for (const node_ptr &arg : n->args) {
+        args.push_back(add(arg));
+      }
+
+      auto key = std::make_pair(static_cast<const void *>(n->child.get()), args);
+      auto stage_it = stage_index.find(key);
+      if (stage_it == stage_index.end()) {
+        stage_it = stage_index.emplace(std::move(key), -static_cast<intptr_t>(stages.size()) - 1).first;
+        stages.push_back({n->child, std::move(args)});
+      }
+      i = stage_it->second;
+    }
+
+    visited[n.get()] = i;
+    return i;
+  }
+
+  /**
+   * Returns the fused callable for the stages, renumbering their arguments now
+   * that the number of values is known.
+   */
+  nd::callable make_callable() {
+    intptr_t nsrc = values.size();
+    for (nd::functional::fuse_stage &stage : stages) {
+      for (intptr_t &j : stage.args) {
+        if (j < 0) {
+          j = nsrc - j - 1;
+        }
+      }
+    }
+
+    // Evaluating the same kind of expression again reuses the callable, and so its cached kernels
+    static std::mutex mutex;
+    static std::map<std::vector<intptr_t>, nd::callable> fused;
+    std::vector<intptr_t> key{nsrc};
+    for (const nd::functional::fuse_stage &stage : stages) {
+      key.push_back(reinterpret_cast<intptr_t>(stage.child.get()));
+      key.push_back(stage.args.size());
+      key.insert(key.end(), stage.args.begin(), stage.args.end());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = fused.find(key);
+    if (it == fused.end()) {
+      if (fused.size() >= 64) {
+        fused.clear();
+      }
+      it = fused.emplace(std::move(key), nd::functional::fuse(nsrc, stages)).first;
+    }
+    return it->second;
+  }
+};
+
+} // unnamed namespace
+
+nd::expression::expression(const array &a) {
+  std::shared_ptr<node> n = std::make_shared<node>();
+  n->value = a;
+  m_node = n;
+}
+
+nd::expression::expression(const callable &child, const std::vector<expression> &args) {
+  if (child.is_null()) {
+    throw invalid_argument("cannot make an expression from a null callable");
+  }
+
+  std::shared_ptr<node> n = std::make_shared<node>();
+  n->child = child;
+  for (const expression &arg : args) {
+    n->args.push_back(arg.m_node);
+  }
+  m_node = n;
+}
+
+bool nd::expression::is_value() const { return m_node->child.is_null(); }
+
+nd::array nd::expression::eval() const {
+  if (is_value()) {
+    return m_node->value;
+  }
+
+  plan p;
+  p.add(m_node);
+  return p.make_callable().call(p.values.size(), p.values.data(), 0, nullptr);
+}
+
+void nd::expression::eval(const array &dst) const {
+  if (is_value()) {
+    dst.assign(m_node->value);
+    return;
+  }
+
+  plan p;
+  p.add(m_node);
+  std::pair<const char *, array> kwd("dst", dst);
+  p.make_callable().call(p.values.size(), p.values.data(), 1, &kwd);
+}
+
+nd::expression nd::operator+(const expression &a0) { return expression(nd::plus, {a0}); }
+
+nd::expression nd::operator-(const expression &a0) { return expression(nd::minus, {a0}); }
+
+nd::expression nd::operator+(const expression &op0, const expression &op1) { return expression(nd::add, {op0, op1}); }
+
+nd::expression nd::operator-(const expression &op0, const expression &op1) {
+  return expression(nd::subtract, {op0, op1});
+}
+
+nd::expression nd::operator*(const expression &op0, const expression &op1) {
+  return expression(nd::multiply, {op0, op1});
+}
+
+nd::expression nd::operator/(const expression &op0, const expression &op1) {
+  return expression(nd::divide, {op0, op1});
+}
+
+nd::expression nd::operator+(const expression &op0, const array &op1) { return op0 + expression(op1); }
+
+nd::expression nd::operator-(const expression &op0, const array &op1) { return op0 - expression(op1); }
+
+nd::expression nd::operator*(const expression &op0, const array &op1) { return op0 * expression(op1); }
+
+nd::expression nd::operator/(const expression &op0, const array &op1) { return op0 / expression(op1); }
+
+nd::expression nd::operator+(const array &op0, const expression &op1) { return expression(op0) + op1; }
+
+nd::expression nd::operator-(const array &op0, const expression &op1) { return expression(op0) - op1; }
+
+nd::expression nd::operator*(const array &op0, const expression &op1) { return expression(op0) * op1; }
+
+nd::expression nd::operator/(const array &op0, const expression &op1) { return expression(op0) / op1; }
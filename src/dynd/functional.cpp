@@ -8,6 +8,7 @@
 #include <dynd/callables/compound_callable.hpp>
 #include <dynd/callables/constant_callable.hpp>
 #include <dynd/callables/elwise_entry_callable.hpp>
+#include <dynd/callables/fuse_callable.hpp>
 #include <dynd/callables/neighborhood_callable.hpp>
 #include <dynd/callables/outer_callable.hpp>
 #include <dynd/callables/outer_entry_callable.hpp>
@@ -64,6 +65,42 @@ nd::callable nd::functional::compose(const nd::callable &first, const nd::callab
       ndt::make_type<ndt::callable_type>(second->get_ret_type(), first->get_arg_types()), first, second, buf_tp);
 }
 
+nd::callable nd::functional::fuse(size_t nsrc, const std::vector<fuse_stage> &stages) {
+  if (stages.empty()) {
+    throw invalid_argument("Cannot fuse an empty list of stages");
+  }
+
+  vector<callable> children;
+  vector<vector<intptr_t>> args;
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const fuse_stage &stage = stages[i];
+    if (stage.child->get_narg() != stage.args.size()) {
+      stringstream ss;
+      ss << "Cannot fuse stage " << i << ", because " << stage.child << " takes " << stage.child->get_narg()
+         << " arguments but was given " << stage.args.size();
+      throw invalid_argument(ss.str());
+    }
+    for (intptr_t j : stage.args) {
+      if (j < 0 || j >= static_cast<intptr_t>(nsrc + i)) {
+        stringstream ss;
+        ss << "Cannot fuse stage " << i << ", because argument index " << j
+           << " is neither an argument nor the result of an earlier stage";
+        throw invalid_argument(ss.str());
+      }
+    }
+
+    children.push_back(stage.child);
+    args.push_back(stage.args);
+  }
+
+  // The stages are applied to scalars, with the dimensions broadcast by elwise as for the arithmetic callables
+  callable child = make_callable<fuse_callable>(
+      ndt::make_type<ndt::callable_type>(ndt::type("Any"), vector<ndt::type>(nsrc, ndt::type("Scalar"))), children,
+      args);
+  return make_callable<elwise_entry_callable>(
+      ndt::make_type<ndt::callable_type>(ndt::type("Any"), vector<ndt::type>(nsrc, ndt::type("Any"))), child, false);
+}
+
 nd::callable nd::functional::constant(const array &val) { return make_callable<constant_callable>(val); }
 
 nd::callable nd::functional::left_compound(const callable &child) {
@@ -172,7 +209,7 @@ nd::callable nd::functional::neighborhood(const callable &neighborhood_op, const
       neighborhood_op, boundary_child);
 }
 
-nd::callable nd::functional::reduction(const callable &identity, const callable &child) {
+nd::callable nd::functional::reduction(const callable &identity, const callable &child, callable_property properties) {
   if (identity.is_null()) {
     throw invalid_argument("'identity' cannot be null");
   }
@@ -193,7 +230,7 @@ nd::callable nd::functional::reduction(const callable &identity, const callable
   return make_callable<reduction_dispatch_callable>(
       ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::ellipsis_dim_type>("Dims", child->get_ret_type()),
                                          arg_tp.size(), arg_tp.data(), kwds),
-      identity, child);
+      identity, child, properties);
 }
 
 nd::callable nd::functional::where(const callable &child) { return elwise(make_callable<where_callable>(child), true); }
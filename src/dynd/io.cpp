@@ -3,12 +3,638 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
+#include <deque>
+#include <fstream>
+
+#include <dynd/arrmeta_holder.hpp>
 #include <dynd/callables/serialize_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/io.hpp>
+#include <dynd/memblock/memmap_memory_block.hpp>
+#include <dynd/types/bytes_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/tuple_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
 
 using namespace std;
 using namespace dynd;
 
 DYND_API nd::callable nd::serialize = nd::functional::reduction(
     [] { return bytes(); }, nd::make_callable<nd::serialize_callable<ndt::scalar_kind_type>>());
+
+namespace {
+
+// The first bytes of a file written by nd::save
+const char binary_magic[8] = {'\x89', 'D', 'Y', 'N', 'D', '\r', '\n', '\x1a'};
+const uint32_t binary_version = 1;
+// Written in the byte order of the writer, so a reader can tell whether it matches
+const uint32_t binary_byte_order = 0x01020304;
+
+enum binary_flags {
+  // The data holds offsets within the file in place of pointers
+  binary_flag_relocate = 0x01
+};
+
+/**
+ * The start of a file written by nd::save. All the offsets are from the
+ * start of the file.
+ */
+struct binary_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t pointer_size;
+  uint32_t flags;
+  uint64_t datashape_offset;
+  uint64_t datashape_size;
+  uint64_t arrmeta_offset;
+  uint64_t arrmeta_size;
+  uint64_t data_offset;
+  uint64_t file_size;
+};
+
+// The alignment of the datashape, the arrmeta and the data
+const uint64_t binary_section_alignment = 64;
+
+/**
+ * The layout of dynd::string and dynd::bytes (see sso_bytestring). A short
+ * one is stored inline, with its size in the top byte. A longer one stores
+ * the bitwise not of its size, and points to a buffer of its capacity
+ * followed by its bytes.
+ */
+struct bytestring_layout {
+  int64_t pointer;
+  int64_t size;
+};
+
+static_assert(sizeof(bytestring_layout) == sizeof(dynd::string) && sizeof(bytestring_layout) == sizeof(bytes),
+              "the layout of dynd::string and dynd::bytes has changed");
+
+// A string is followed by a NUL, which bytes are not
+size_t bytestring_nul_padding(type_id_t id) { return id == string_id ? 1 : 0; }
+
+size_t bytestring_inline_capacity(type_id_t id) { return 15 - bytestring_nul_padding(id); }
+
+uint64_t align_up(uint64_t offset, uint64_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+/**
+ * Whether the data of a type holds no pointers, so it can be written and
+ * mapped back as it is.
+ */
+bool is_plain(const ndt::type &tp) {
+  return (tp.get_flags() & (type_flag_blockref | type_flag_destructor)) == 0 && !tp.is_expression() &&
+         !tp.is_symbolic();
+}
+
+void get_fields(const ndt::type &tp, intptr_t &field_count, const ndt::type *&field_types,
+                const uintptr_t *&arrmeta_offsets) {
+  if (tp.get_id() == struct_id) {
+    const ndt::struct_type *st = tp.extended<ndt::struct_type>();
+    field_count = st->get_field_count();
+    field_types = st->get_field_types_raw();
+    arrmeta_offsets = st->get_arrmeta_offsets_raw();
+  } else {
+    const ndt::tuple_type *tt = tp.extended<ndt::tuple_type>();
+    field_count = tt->get_field_count();
+    field_types = tt->get_field_types_raw();
+    arrmeta_offsets = tt->get_arrmeta_offsets_raw();
+  }
+}
+
+/**
+ * Raises an error unless arrays of the type can be written by nd::save.
+ */
+void check_binary_type(const ndt::type &tp) {
+  if (is_plain(tp)) {
+    return;
+  }
+
+  switch (tp.get_id()) {
+  case fixed_dim_id:
+  case var_dim_id:
+    check_binary_type(tp.extended<ndt::base_dim_type>()->get_element_type());
+    return;
+  case struct_id:
+  case tuple_id: {
+    intptr_t field_count;
+    const ndt::type *field_types;
+    const uintptr_t *arrmeta_offsets;
+    get_fields(tp, field_count, field_types, arrmeta_offsets);
+    for (intptr_t i = 0; i < field_count; ++i) {
+      check_binary_type(field_types[i]);
+    }
+    return;
+  }
+  case option_id:
+    check_binary_type(tp.extended<ndt::option_type>()->get_value_type());
+    return;
+  case string_id:
+  case bytes_id:
+    return;
+  default: {
+    stringstream ss;
+    ss << "cannot write an array of type " << tp << " to a binary file";
+    throw type_error(ss.str());
+  }
+  }
+}
+
+/**
+ * Writes the data of an array to a stream. The data is written in the
+ * layout of the default arrmeta, with each var dim and long string or bytes
+ * pointing to a block of its own. The blocks are given their offsets as
+ * they are found, and written in that order.
+ */
+class binary_writer {
+  std::ostream &m_out;
+  // The end of the space given to blocks so far, and of what has been written
+  uint64_t m_allocated, m_written;
+  bool m_relocate;
+
+  struct pending_block {
+    uint64_t offset;
+    // The elements of a var dim, or the buffer of a long string or bytes
+    bool elements;
+    ndt::type tp;
+    const char *src_arrmeta, *src_data;
+    intptr_t src_stride;
+    const char *dst_arrmeta;
+    intptr_t dst_stride;
+    intptr_t count;
+  };
+  std::deque<pending_block> m_pending;
+
+  /**
+   * Copies one value into a block being built, in the default layout.
+   */
+  void copy(const ndt::type &tp, const char *src_arrmeta, const char *src_data, const char *dst_arrmeta,
+            char *dst_data) {
+    if (is_plain(tp) && memcmp(src_arrmeta, dst_arrmeta, tp.get_arrmeta_size()) == 0) {
+      memcpy(dst_data, src_data, tp.get_default_data_size());
+      return;
+    }
+
+    switch (tp.get_id()) {
+    case fixed_dim_id: {
+      const fixed_dim_type_arrmeta *src_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta);
+      const fixed_dim_type_arrmeta *dst_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(dst_arrmeta);
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      for (intptr_t i = 0; i < dst_md->dim_size; ++i) {
+        copy(element_tp, src_arrmeta + sizeof(fixed_dim_type_arrmeta), src_data + i * src_md->stride,
+             dst_arrmeta + sizeof(fixed_dim_type_arrmeta), dst_data + i * dst_md->stride);
+      }
+      break;
+    }
+    case var_dim_id: {
+      const ndt::var_dim_type::metadata_type *src_md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(src_arrmeta);
+      const ndt::var_dim_type::metadata_type *dst_md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(dst_arrmeta);
+      const ndt::var_dim_type::data_type *src_d = reinterpret_cast<const ndt::var_dim_type::data_type *>(src_data);
+      ndt::var_dim_type::data_type *dst_d = reinterpret_cast<ndt::var_dim_type::data_type *>(dst_data);
+      dst_d->size = src_d->size;
+      if (src_d->size == 0) {
+        dst_d->begin = NULL;
+        break;
+      }
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      pending_block block;
+      block.offset = allocate(src_d->size * dst_md->stride, element_tp.get_data_alignment());
+      block.elements = true;
+      block.tp = element_tp;
+      block.src_arrmeta = src_arrmeta + sizeof(ndt::var_dim_type::metadata_type);
+      block.src_data = src_d->begin + src_md->offset;
+      block.src_stride = src_md->stride;
+      block.dst_arrmeta = dst_arrmeta + sizeof(ndt::var_dim_type::metadata_type);
+      block.dst_stride = dst_md->stride;
+      block.count = src_d->size;
+      m_pending.push_back(block);
+      dst_d->begin = reinterpret_cast<char *>(static_cast<uintptr_t>(block.offset));
+      m_relocate = true;
+      break;
+    }
+    case struct_id:
+    case tuple_id: {
+      intptr_t field_count;
+      const ndt::type *field_types;
+      const uintptr_t *arrmeta_offsets;
+      get_fields(tp, field_count, field_types, arrmeta_offsets);
+      const uintptr_t *src_offsets = reinterpret_cast<const uintptr_t *>(src_arrmeta);
+      const uintptr_t *dst_offsets = reinterpret_cast<const uintptr_t *>(dst_arrmeta);
+      for (intptr_t i = 0; i < field_count; ++i) {
+        copy(field_types[i], src_arrmeta + arrmeta_offsets[i], src_data + src_offsets[i],
+             dst_arrmeta + arrmeta_offsets[i], dst_data + dst_offsets[i]);
+      }
+      break;
+    }
+    case option_id:
+      copy(tp.extended<ndt::option_type>()->get_value_type(), src_arrmeta, src_data, dst_arrmeta, dst_data);
+      break;
+    case string_id:
+    case bytes_id: {
+      const char *begin;
+      size_t size;
+      if (tp.get_id() == string_id) {
+        const dynd::string *s = reinterpret_cast<const dynd::string *>(src_data);
+        begin = s->data();
+        size = s->size();
+      } else {
+        const bytes *b = reinterpret_cast<const bytes *>(src_data);
+        begin = b->data();
+        size = b->size();
+      }
+      if (size <= bytestring_inline_capacity(tp.get_id())) {
+        // Stored inline, which does not depend on where it is
+        if (tp.get_id() == string_id) {
+          new (dst_data) dynd::string(begin, size);
+        } else {
+          new (dst_data) bytes(begin, size);
+        }
+        break;
+      }
+      pending_block block;
+      block.offset = allocate(sizeof(size_t) + size + bytestring_nul_padding(tp.get_id()), alignof(size_t));
+      block.elements = false;
+      block.tp = tp;
+      block.src_data = begin;
+      block.count = size;
+      m_pending.push_back(block);
+      bytestring_layout *dst_s = reinterpret_cast<bytestring_layout *>(dst_data);
+      dst_s->pointer = block.offset;
+      dst_s->size = ~static_cast<int64_t>(size);
+      m_relocate = true;
+      break;
+    }
+    default: {
+      stringstream ss;
+      ss << "cannot write data of type " << tp << " with non-default arrmeta to a binary file";
+      throw type_error(ss.str());
+    }
+    }
+  }
+
+  void write_elements(const pending_block &block) {
+    const ndt::type &tp = block.tp;
+    size_t element_size = tp.get_default_data_size();
+    if (is_plain(tp) && memcmp(block.src_arrmeta, block.dst_arrmeta, tp.get_arrmeta_size()) == 0) {
+      // Written straight from the array, without a copy
+      if (block.src_stride == block.dst_stride || block.count == 1) {
+        write(block.offset, block.src_data, block.count * element_size);
+      } else {
+        for (intptr_t i = 0; i < block.count; ++i) {
+          write(block.offset + i * block.dst_stride, block.src_data + i * block.src_stride, element_size);
+        }
+      }
+      return;
+    }
+
+    std::vector<char> buffer(block.count * block.dst_stride);
+    for (intptr_t i = 0; i < block.count; ++i) {
+      copy(tp, block.src_arrmeta, block.src_data + i * block.src_stride, block.dst_arrmeta,
+           buffer.data() + i * block.dst_stride);
+    }
+    write(block.offset, buffer.data(), buffer.size());
+  }
+
+  void write_buffer(const pending_block &block) {
+    // The capacity, then the bytes, then the NUL of a string
+    size_t capacity = block.count;
+    write(block.offset, reinterpret_cast<const char *>(&capacity), sizeof(size_t));
+    write(m_written, block.src_data, block.count);
+    if (bytestring_nul_padding(block.tp.get_id()) != 0) {
+      write(m_written, "", 1);
+    }
+  }
+
+public:
+  binary_writer(std::ostream &out) : m_out(out), m_allocated(0), m_written(0), m_relocate(false) {}
+
+  uint64_t get_size() const { return m_written; }
+
+  /** Whether any offsets have been written in place of pointers */
+  bool needs_relocation() const { return m_relocate; }
+
+  uint64_t allocate(uint64_t size, uint64_t alignment) {
+    uint64_t offset = align_up(m_allocated, alignment);
+    m_allocated = offset + size;
+    return offset;
+  }
+
+  /**
+   * Writes to the stream at ``offset``, which is at or past what has been
+   * written so far, padding the gap with zeros.
+   */
+  void write(uint64_t offset, const char *data, size_t size) {
+    static const char zeros[64] = {};
+    while (m_written < offset) {
+      size_t padding = static_cast<size_t>(std::min<uint64_t>(offset - m_written, sizeof(zeros)));
+      m_out.write(zeros, padding);
+      m_written += padding;
+    }
+    m_out.write(data, size);
+    m_written += size;
+  }
+
+  /**
+   * Writes the value of an array, at an offset it was allocated, along with
+   * all the blocks it points to.
+   */
+  void write_value(uint64_t offset, const ndt::type &tp, const char *src_arrmeta, const char *src_data,
+                   const char *dst_arrmeta) {
+    pending_block block;
+    block.offset = offset;
+    block.elements = true;
+    block.tp = tp;
+    block.src_arrmeta = src_arrmeta;
+    block.src_data = src_data;
+    block.src_stride = 0;
+    block.dst_arrmeta = dst_arrmeta;
+    block.dst_stride = tp.get_default_data_size();
+    block.count = 1;
+    m_pending.push_back(block);
+
+    while (!m_pending.empty()) {
+      if (m_pending.front().elements) {
+        write_elements(m_pending.front());
+      } else {
+        write_buffer(m_pending.front());
+      }
+      m_pending.pop_front();
+    }
+  }
+};
+
+/**
+ * Turns the offsets in the data of a mapped file back into pointers,
+ * checking that each lies within the file.
+ */
+class binary_reader {
+  const std::string &m_filename;
+  char *m_base;
+  uint64_t m_size;
+  // Whether the map is private, so the offsets can be replaced
+  bool m_relocatable;
+
+public:
+  binary_reader(const std::string &filename, char *base, uint64_t size, bool relocatable)
+      : m_filename(filename), m_base(base), m_size(size), m_relocatable(relocatable) {}
+
+  void throw_corrupt(const char *reason) const {
+    stringstream ss;
+    ss << "binary array file \"" << m_filename << "\" is corrupt, " << reason;
+    throw runtime_error(ss.str());
+  }
+
+  void check_range(uint64_t offset, uint64_t size, uint64_t alignment) const {
+    if (offset > m_size || size > m_size - offset || offset % alignment != 0) {
+      throw_corrupt("it has an offset out of range");
+    }
+  }
+
+  char *relocate_pointer(const void *stored, uint64_t size, uint64_t alignment) const {
+    if (!m_relocatable) {
+      throw_corrupt("it holds offsets but its header does not say so");
+    }
+    uint64_t offset = reinterpret_cast<uintptr_t>(stored);
+    check_range(offset, size, alignment);
+    return m_base + offset;
+  }
+
+  void relocate(const ndt::type &tp, const char *arrmeta, char *data) const {
+    if (is_plain(tp)) {
+      return;
+    }
+
+    switch (tp.get_id()) {
+    case fixed_dim_id: {
+      const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      for (intptr_t i = 0; i < md->dim_size; ++i) {
+        relocate(element_tp, arrmeta + sizeof(fixed_dim_type_arrmeta), data + i * md->stride);
+      }
+      break;
+    }
+    case var_dim_id: {
+      const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+      ndt::var_dim_type::data_type *d = reinterpret_cast<ndt::var_dim_type::data_type *>(data);
+      if (d->size == 0) {
+        if (d->begin != NULL) {
+          throw_corrupt("it has an empty var dim with elements");
+        }
+        break;
+      }
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      if (md->stride > 0 && d->size > m_size / md->stride) {
+        throw_corrupt("it has a var dim larger than the file");
+      }
+      d->begin = relocate_pointer(d->begin, d->size * md->stride, element_tp.get_data_alignment());
+      if (!is_plain(element_tp)) {
+        for (size_t i = 0; i < d->size; ++i) {
+          relocate(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type), d->begin + i * md->stride);
+        }
+      }
+      break;
+    }
+    case struct_id:
+    case tuple_id: {
+      intptr_t field_count;
+      const ndt::type *field_types;
+      const uintptr_t *arrmeta_offsets;
+      get_fields(tp, field_count, field_types, arrmeta_offsets);
+      const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+      for (intptr_t i = 0; i < field_count; ++i) {
+        relocate(field_types[i], arrmeta + arrmeta_offsets[i], data + data_offsets[i]);
+      }
+      break;
+    }
+    case option_id:
+      relocate(tp.extended<ndt::option_type>()->get_value_type(), arrmeta, data);
+      break;
+    case string_id:
+    case bytes_id: {
+      bytestring_layout *s = reinterpret_cast<bytestring_layout *>(data);
+      if (s->size >= 0) {
+        if ((static_cast<uint64_t>(s->size) >> 56) > bytestring_inline_capacity(tp.get_id())) {
+          throw_corrupt("it has a string longer than it can hold");
+        }
+        break;
+      }
+      uint64_t size = ~static_cast<uint64_t>(s->size);
+      if (size > m_size) {
+        throw_corrupt("it has a string larger than the file");
+      }
+      s->pointer = reinterpret_cast<intptr_t>(relocate_pointer(
+          reinterpret_cast<const void *>(s->pointer), sizeof(size_t) + size + bytestring_nul_padding(tp.get_id()),
+          alignof(size_t)));
+      break;
+    }
+    default:
+      break;
+    }
+  }
+};
+
+/**
+ * Points the var dims in arrmeta at the memory block holding their elements.
+ */
+void set_blockrefs(const ndt::type &tp, char *arrmeta, const nd::memory_block &blockref) {
+  switch (tp.get_id()) {
+  case fixed_dim_id:
+    set_blockrefs(tp.extended<ndt::base_dim_type>()->get_element_type(), arrmeta + sizeof(fixed_dim_type_arrmeta),
+                  blockref);
+    break;
+  case var_dim_id:
+    reinterpret_cast<ndt::var_dim_type::metadata_type *>(arrmeta)->blockref = blockref;
+    set_blockrefs(tp.extended<ndt::base_dim_type>()->get_element_type(),
+                  arrmeta + sizeof(ndt::var_dim_type::metadata_type), blockref);
+    break;
+  case struct_id:
+  case tuple_id: {
+    intptr_t field_count;
+    const ndt::type *field_types;
+    const uintptr_t *arrmeta_offsets;
+    get_fields(tp, field_count, field_types, arrmeta_offsets);
+    for (intptr_t i = 0; i < field_count; ++i) {
+      set_blockrefs(field_types[i], arrmeta + arrmeta_offsets[i], blockref);
+    }
+    break;
+  }
+  case option_id:
+    set_blockrefs(tp.extended<ndt::option_type>()->get_value_type(), arrmeta, blockref);
+    break;
+  default:
+    break;
+  }
+}
+
+} // anonymous namespace
+
+void nd::save(const std::string &filename, const array &a) {
+  if (a.is_null()) {
+    throw invalid_argument("cannot write a null array to a binary file");
+  }
+  array value = a.get_type().is_expression() ? a.eval() : a;
+  const ndt::type &tp = value.get_type();
+  check_binary_type(tp);
+
+  stringstream datashape;
+  datashape << tp;
+  std::string datashape_str = datashape.str();
+  // The arrmeta of the data as it is written
+  arrmeta_holder arrmeta(tp);
+  arrmeta.arrmeta_default_construct(false);
+
+  ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out) {
+    stringstream ss;
+    ss << "failed to open file \"" << filename << "\" for writing";
+    throw runtime_error(ss.str());
+  }
+
+  binary_header header;
+  memset(&header, 0, sizeof(binary_header));
+  binary_writer writer(out);
+  writer.allocate(sizeof(binary_header), 1);
+  header.datashape_offset = writer.allocate(datashape_str.size(), binary_section_alignment);
+  header.datashape_size = datashape_str.size();
+  header.arrmeta_offset = writer.allocate(tp.get_arrmeta_size(), binary_section_alignment);
+  header.arrmeta_size = tp.get_arrmeta_size();
+  header.data_offset = writer.allocate(tp.get_default_data_size(), binary_section_alignment);
+
+  // The header is written last, once the flags and size are known
+  writer.write(0, reinterpret_cast<const char *>(&header), sizeof(binary_header));
+  writer.write(header.datashape_offset, datashape_str.data(), datashape_str.size());
+  writer.write(header.arrmeta_offset, arrmeta.get(), tp.get_arrmeta_size());
+  writer.write_value(header.data_offset, tp, value.get()->metadata(), value.cdata(), arrmeta.get());
+
+  memcpy(header.magic, binary_magic, sizeof(binary_magic));
+  header.version = binary_version;
+  header.byte_order = binary_byte_order;
+  header.pointer_size = sizeof(void *);
+  header.flags = writer.needs_relocation() ? binary_flag_relocate : 0;
+  header.file_size = writer.get_size();
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(binary_header));
+
+  out.close();
+  if (!out) {
+    stringstream ss;
+    ss << "failed to write file \"" << filename << "\"";
+    throw runtime_error(ss.str());
+  }
+}
+
+nd::array nd::load(const std::string &filename, const memmap_options &options) {
+  binary_header header;
+  {
+    ifstream in(filename.c_str(), ios::in | ios::binary);
+    if (!in) {
+      stringstream ss;
+      ss << "failed to open file \"" << filename << "\" for reading";
+      throw runtime_error(ss.str());
+    }
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(binary_header)) ||
+        memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0) {
+      stringstream ss;
+      ss << "file \"" << filename << "\" is not a binary array file";
+      throw runtime_error(ss.str());
+    }
+  }
+  if (header.version != binary_version) {
+    stringstream ss;
+    ss << "binary array file \"" << filename << "\" has version " << header.version << ", which is not supported";
+    throw runtime_error(ss.str());
+  }
+  if (header.byte_order != binary_byte_order || header.pointer_size != sizeof(void *)) {
+    stringstream ss;
+    ss << "binary array file \"" << filename << "\" was written with a different byte order or pointer size";
+    throw runtime_error(ss.str());
+  }
+
+  // The offsets are turned into pointers in a private copy of the pages holding them
+  bool relocatable = (header.flags & binary_flag_relocate) != 0;
+  memmap_options map_options = options;
+  map_options.copy_on_write = options.copy_on_write || relocatable;
+  char *base = NULL;
+  intptr_t size = 0;
+  memory_block mm = make_memory_block<memmap_memory_block>(filename, read_access_flag, &base, &size, 0,
+                                                           std::numeric_limits<intptr_t>::max(), map_options);
+  binary_reader reader(filename, base, size, relocatable);
+  if (header.file_size != static_cast<uint64_t>(size)) {
+    reader.throw_corrupt("its size does not match its header");
+  }
+
+  reader.check_range(header.datashape_offset, header.datashape_size, 1);
+  ndt::type tp(std::string(base + header.datashape_offset, header.datashape_size));
+  check_binary_type(tp);
+
+  // Only the default layout is written, so the arrmeta is checked against it
+  arrmeta_holder arrmeta(tp);
+  arrmeta.arrmeta_default_construct(false);
+  reader.check_range(header.arrmeta_offset, header.arrmeta_size, 1);
+  if (header.arrmeta_size != tp.get_arrmeta_size() ||
+      memcmp(base + header.arrmeta_offset, arrmeta.get(), tp.get_arrmeta_size()) != 0) {
+    reader.throw_corrupt("its arrmeta does not match its datashape");
+  }
+
+  reader.check_range(header.data_offset, tp.get_default_data_size(), tp.get_data_alignment());
+  char *data = base + header.data_offset;
+  reader.relocate(tp, arrmeta.get(), data);
+
+  // Data holding pointers into the map cannot be written through, since assigning
+  // to it would free or reallocate them
+  uint64_t flags = read_access_flag;
+  if (options.copy_on_write && is_plain(tp)) {
+    flags |= write_access_flag;
+  }
+  array result = make_array(tp, data, mm, flags);
+  if (!tp.is_builtin()) {
+    tp.extended()->arrmeta_default_construct(result.get()->metadata(), false);
+    set_blockrefs(tp, result.get()->metadata(), mm);
+  }
+  return result;
+}
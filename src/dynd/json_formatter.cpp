@@ -5,6 +5,7 @@
 
 #include <dynd/json_formatter.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/format_util.hpp>
 #include <dynd/option.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/struct_type.hpp>
@@ -62,6 +63,27 @@ struct output_data {
     memcpy(out_end, begin, end - begin);
     out_end += (end - begin);
   }
+
+  // Write numbers straight into the buffer
+  inline void write_int64(int64_t value) {
+    ensure_capacity(max_format_int64_size);
+    out_end = format_int64(out_end, value);
+  }
+
+  inline void write_uint64(uint64_t value) {
+    ensure_capacity(max_format_int64_size);
+    out_end = format_uint64(out_end, value);
+  }
+
+  inline void write_float32(float value) {
+    ensure_capacity(max_format_float32_size);
+    out_end = format_float32(out_end, value);
+  }
+
+  inline void write_float64(double value) {
+    ensure_capacity(max_format_float64_size);
+    out_end = format_float64(out_end, value);
+  }
 };
 
 static void format_json(output_data &out, const ndt::type &dt, const char *arrmeta, const char *data);
@@ -82,9 +104,146 @@ static void format_json_bool(output_data &out, const ndt::type &dt, const char *
 }
 
 static void format_json_number(output_data &out, const ndt::type &dt, const char *arrmeta, const char *data) {
-  stringstream ss;
-  dt.print_data(ss, arrmeta, data);
-  out.write(ss.str());
+  switch (dt.get_id()) {
+  case int8_id:
+    out.write_int64(*reinterpret_cast<const int8_t *>(data));
+    break;
+  case int16_id:
+    out.write_int64(*reinterpret_cast<const int16_t *>(data));
+    break;
+  case int32_id:
+    out.write_int64(*reinterpret_cast<const int32_t *>(data));
+    break;
+  case int64_id:
+    out.write_int64(*reinterpret_cast<const int64_t *>(data));
+    break;
+  case uint8_id:
+    out.write_uint64(*reinterpret_cast<const uint8_t *>(data));
+    break;
+  case uint16_id:
+    out.write_uint64(*reinterpret_cast<const uint16_t *>(data));
+    break;
+  case uint32_id:
+    out.write_uint64(*reinterpret_cast<const uint32_t *>(data));
+    break;
+  case uint64_id:
+    out.write_uint64(*reinterpret_cast<const uint64_t *>(data));
+    break;
+  case float16_id:
+    out.write_float32(static_cast<float>(*reinterpret_cast<const float16 *>(data)));
+    break;
+  case float32_id:
+    out.write_float32(*reinterpret_cast<const float *>(data));
+    break;
+  case float64_id:
+    out.write_float64(*reinterpret_cast<const double *>(data));
+    break;
+  default: {
+    stringstream ss;
+    dt.print_data(ss, arrmeta, data);
+    out.write(ss.str());
+    break;
+  }
+  }
+}
+
+/**
+ * The most characters a scalar of type ``dt`` is formatted as, or 0 if that
+ * depends on its value.
+ */
+static size_t max_json_scalar_size(const ndt::type &dt) {
+  switch (dt.get_id()) {
+  case bool_id:
+    return 5;
+  case int8_id:
+  case uint8_id:
+    return 4;
+  case int16_id:
+  case uint16_id:
+    return 6;
+  case int32_id:
+  case uint32_id:
+    return 11;
+  case int64_id:
+  case uint64_id:
+    return max_format_int64_size;
+  case float16_id:
+  case float32_id:
+    return max_format_float32_size;
+  case float64_id:
+    return max_format_float64_size;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Estimates how many characters the JSON of a value takes, so that the output
+ * is allocated once. Numbers count as their longest form, strings as their
+ * bytes, and only what is too irregular for that is a guess. The elements of
+ * a dimension whose size doesn't depend on their value aren't visited.
+ */
+static size_t estimate_json_size(const ndt::type &dt, const char *arrmeta, const char *data) {
+  size_t scalar_size = max_json_scalar_size(dt);
+  if (scalar_size != 0) {
+    return scalar_size;
+  }
+
+  switch (dt.get_id()) {
+  case fixed_string_id:
+  case string_id: {
+    const char *begin = NULL, *end = NULL;
+    dt.extended<ndt::base_string_type>()->get_string_range(&begin, &end, arrmeta, data);
+    return end - begin + 2;
+  }
+  case struct_id: {
+    const ndt::struct_type *bsd = dt.extended<ndt::struct_type>();
+    intptr_t field_count = bsd->get_field_count();
+    const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+    const std::vector<uintptr_t> &arrmeta_offsets = bsd->get_arrmeta_offsets();
+    size_t size = field_count + 1;
+    for (intptr_t i = 0; i < field_count; ++i) {
+      size += bsd->get_field_name(i).size() + 3 +
+              estimate_json_size(bsd->get_field_type(i), arrmeta + arrmeta_offsets[i], data + data_offsets[i]);
+    }
+    return size;
+  }
+  case option_id:
+    if (nd::old_is_avail(dt, arrmeta, data)) {
+      return estimate_json_size(dt.extended<ndt::option_type>()->get_value_type(), arrmeta, data);
+    }
+    return 4;
+  case fixed_dim_id:
+  case var_dim_id: {
+    ndt::type element_tp = dt.extended<ndt::base_dim_type>()->get_element_type();
+    intptr_t size, stride;
+    if (dt.get_id() == fixed_dim_id) {
+      const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+      size = md->dim_size;
+      stride = md->stride;
+      arrmeta += sizeof(fixed_dim_type_arrmeta);
+    } else {
+      const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+      const ndt::var_dim_type::data_type *d = reinterpret_cast<const ndt::var_dim_type::data_type *>(data);
+      size = d->size;
+      stride = md->stride;
+      data = d->begin + md->offset;
+      arrmeta += sizeof(ndt::var_dim_type::metadata_type);
+    }
+
+    size_t element_size = max_json_scalar_size(element_tp);
+    if (element_size != 0) {
+      return 2 + size * (element_size + 1);
+    }
+    size_t total = 2 + size;
+    for (intptr_t i = 0; i < size; ++i) {
+      total += estimate_json_size(element_tp, arrmeta, data + i * stride);
+    }
+    return total;
+  }
+  default:
+    return 64;
+  }
 }
 
 static void print_escaped_unicode_codepoint(output_data &out, uint32_t cp, append_unicode_codepoint_t append_fn) {
@@ -318,24 +477,29 @@ nd::array dynd::format_json(const nd::array &n, bool struct_as_list) {
   // Create a UTF-8 string
   nd::array result = nd::empty(ndt::make_type<ndt::string_type>());
 
-  // Initialize the output with some memory
+  nd::array tmp = n.get_type().is_expression() ? n.eval() : n;
+  const ndt::type &tp = tmp.get_type();
+  const char *arrmeta = tmp.get()->metadata();
+
+  // Initialize the output with the estimated size
   output_data out;
-  out.out_string.resize(1024);
+  out.out_string.resize(estimate_json_size(tp, arrmeta, tmp.cdata()));
   out.out_begin = out.out_string.begin();
   out.out_capacity_end = out.out_string.end();
   out.out_end = out.out_begin;
   out.struct_as_list = struct_as_list;
 
-  if (!n.get_type().is_expression()) {
-    ::format_json(out, n.get_type(), n.get()->metadata(), n.cdata());
-  } else {
-    nd::array tmp = n.eval();
-    ::format_json(out, tmp.get_type(), tmp.get()->metadata(), tmp.cdata());
-  }
+  ::format_json(out, tp, arrmeta, tmp.cdata());
 
-  // Shrink the memory to fit, and set the pointers in the output
+  // The buffer becomes the result, unless so much of it is unused that it's worth shrinking
   string *d = reinterpret_cast<string *>(result.data());
-  d->assign(out.out_string.data(), out.out_end - out.out_begin);
+  size_t size = out.out_end - out.out_begin;
+  if (out.out_string.size() - size <= size) {
+    out.out_string.resize(size);
+    *d = std::move(out.out_string);
+  } else {
+    d->assign(out.out_begin, size);
+  }
 
   // Finalize processing and mark the result as immutable
   result.get_type().extended()->arrmeta_finalize_buffers(result.get()->metadata());
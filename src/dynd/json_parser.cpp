@@ -3,11 +3,18 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include <dynd/callable.hpp>
 #include <dynd/json_parser.hpp>
 #include <dynd/kernels/parse_kernel.hpp>
 #include <dynd/parse.hpp>
-#include <dynd/types/base_bytes_type.hpp>
+#include <dynd/simd.hpp>
+#include <dynd/thread_pool.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
@@ -18,67 +25,234 @@ using namespace dynd;
 
 nd::array nd::json::parse2(const ndt::type &tp, const std::string &str) { return parse_json(tp, str.data()); }
 
-static void json_as_buffer(const nd::array &json, nd::array &out_tmp_ref, const char *&begin, const char *&end) {
-  // Check the type of 'json', and get pointers to the begin/end of a UTF-8
-  // buffer
-  ndt::type json_type = json.get_type().value_type();
-  switch (json_type.get_base_id()) {
-  case string_kind_id: {
-    const ndt::base_string_type *sdt = json_type.extended<ndt::base_string_type>();
-    switch (sdt->get_encoding()) {
-    case string_encoding_ascii:
-    case string_encoding_utf_8:
-      out_tmp_ref = json.eval();
-      // The data is already UTF-8, so use the buffer directly
-      sdt->get_string_range(&begin, &end, out_tmp_ref.get()->metadata(), out_tmp_ref.cdata());
+namespace {
+
+// Sets bit i of each mask if byte i of the 64 at data is in the class, as
+// simd::json_classify_loop_t does
+void json_classify(const char *data, uint64_t *masks) {
+  masks[0] = masks[1] = masks[2] = masks[3] = 0;
+  for (int i = 0; i < 64; ++i) {
+    uint64_t bit = static_cast<uint64_t>(1) << i;
+    switch (data[i]) {
+    case '"':
+      masks[0] |= bit;
+      break;
+    case '\\':
+      masks[1] |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      masks[2] |= bit;
+      break;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\f':
+    case '\r':
+      masks[3] |= bit;
       break;
-    default: {
-      // The data needs to be converted to UTF-8 before parsing
-      ndt::type utf8_tp = ndt::make_type<ndt::string_type>();
-      out_tmp_ref = json.ucast(utf8_tp).eval();
-      sdt = static_cast<const ndt::base_string_type *>(utf8_tp.extended());
-      sdt->get_string_range(&begin, &end, out_tmp_ref.get()->metadata(), out_tmp_ref.cdata());
+    default:
       break;
     }
+  }
+}
+
+// Returns the bits of the characters which are escaped by a backslash, given
+// the backslashes. A run of backslashes escapes the character after it only if
+// its length is odd, which is found by adding the runs starting on odd bits and
+// looking at where the carries end up.
+inline uint64_t find_escaped(uint64_t backslash, uint64_t &prev_escaped) {
+  const uint64_t even_bits = 0x5555555555555555ULL;
+
+  backslash &= ~prev_escaped;
+  uint64_t follows_escape = backslash << 1 | prev_escaped;
+  uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  // The carry out of the addition is whether the last run goes on in the next block
+  uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  prev_escaped = sequences_starting_on_even_bits < backslash;
+  uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Returns the index of the lowest set bit of a nonzero ``bits``
+inline int count_trailing_zeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(bits);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  int count = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Returns the bits of every character from each quote up to before the next
+// one, which are those within strings together with their opening quotes
+inline uint64_t prefix_xor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+} // anonymous namespace
+
+const size_t json::structural_index::window_size;
+
+json::structural_index::structural_index(const char *begin, const char *end)
+    : m_end(end), m_window_begin(begin), m_window_end(begin), m_noffsets(0), m_cursor(0),
+      m_prev_in_string(0), m_prev_escaped(0), m_prev_scalar(0) {}
+
+void json::structural_index::index_next_window() {
+  simd::json_classify_loop_t classify = simd::get_json_classify_loop();
+  if (classify == NULL) {
+    classify = &json_classify;
+  }
+
+  m_window_begin = m_window_end;
+  m_window_end = m_window_begin + std::min(static_cast<size_t>(m_end - m_window_begin), window_size);
+  // At most every character is indexed
+  if (m_offsets.size() < static_cast<size_t>(m_window_end - m_window_begin)) {
+    m_offsets.resize(m_window_end - m_window_begin);
+  }
+  uint32_t *offsets = m_offsets.data();
+  m_noffsets = 0;
+  m_cursor = 0;
+
+  for (const char *block = m_window_begin; block < m_window_end; block += 64) {
+    uint64_t masks[4];
+    size_t size = m_window_end - block;
+    if (size >= 64) {
+      classify(block, masks);
+    } else {
+      // The last block is padded with spaces
+      char padded[64];
+      memcpy(padded, block, size);
+      memset(padded + size, ' ', 64 - size);
+      classify(padded, masks);
+    }
+
+    uint64_t quote = masks[0] & ~find_escaped(masks[1], m_prev_escaped);
+    uint64_t in_string = prefix_xor(quote) ^ m_prev_in_string;
+    m_prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+    // Anything else outside a string is part of a number or a literal, which is
+    // indexed where it starts
+    uint64_t structural = masks[2] & ~in_string;
+    uint64_t scalar = ~(masks[2] | masks[3] | quote) & ~in_string;
+    uint64_t scalar_start = scalar & ~(scalar << 1 | m_prev_scalar);
+    m_prev_scalar = scalar >> 63;
+
+    uint64_t bits = structural | quote | scalar_start;
+    uint32_t offset = static_cast<uint32_t>(block - m_window_begin);
+    while (bits != 0) {
+      offsets[m_noffsets++] = offset + count_trailing_zeros(bits);
+      bits &= bits - 1;
     }
-    break;
   }
-  case bytes_kind_id: {
-    out_tmp_ref = json.eval();
-    const ndt::base_bytes_type *bdt = json_type.extended<ndt::base_bytes_type>();
-    bdt->get_bytes_range(&begin, &end, out_tmp_ref.get()->metadata(), out_tmp_ref.cdata());
-    break;
+}
+
+const char *json::structural_index::next(const char *it) {
+  for (;;) {
+    while (it >= m_window_end && m_window_end < m_end) {
+      index_next_window();
+    }
+
+    // The parser mostly moves forward, so the cursor is moved from where it was
+    uint32_t offset = static_cast<uint32_t>(it - m_window_begin);
+    while (m_cursor > 0 && m_offsets[m_cursor - 1] >= offset) {
+      --m_cursor;
+    }
+    while (m_cursor < m_noffsets && m_offsets[m_cursor] < offset) {
+      ++m_cursor;
+    }
+
+    if (m_cursor < m_noffsets) {
+      return m_window_begin + m_offsets[m_cursor];
+    }
+    if (m_window_end == m_end) {
+      return m_end;
+    }
+    it = m_window_end;
   }
-  default: {
-    stringstream ss;
-    ss << "Input for JSON parsing must be either bytes (interpreted as UTF-8) "
-          "or a string, not \""
-       << json_type << "\"";
-    throw runtime_error(ss.str());
-    break;
+}
+
+const char *json::structural_index::find_string_end(const char *it) {
+  if (it < m_window_begin) {
+    return NULL;
+  }
+
+  // Nothing within a string is indexed, so its closing quote is the next position
+  const char *strend = next(it + 1);
+  return (strend != m_end && *strend == '"') ? strend : NULL;
+}
+
+template <size_t N>
+static bool parse_json_token(json::structural_index &index, const char *&rbegin, const char *end,
+                             const char (&token)[N]) {
+  const char *begin = index.skip_whitespace(rbegin);
+  if (static_cast<size_t>(end - begin) >= N - 1 && memcmp(begin, token, N - 1) == 0) {
+    rbegin = begin + N - 1;
+    return true;
+  }
+
+  return false;
+}
+
+static bool parse_json_string(json::structural_index &index, const char *&rbegin, const char *end,
+                              const char *&out_strbegin, const char *&out_strend, bool &out_escaped) {
+  const char *begin = rbegin;
+  if (begin == end || *begin != '"') {
+    return false;
   }
+
+  const char *strend = index.find_string_end(begin);
+  if (strend == NULL || memchr(begin + 1, '\\', strend - begin - 1) != NULL) {
+    // The escapes are validated, and a missing closing quote reported, as without the index
+    return parse_doublequote_string_no_ws(rbegin, end, out_strbegin, out_strend, out_escaped);
   }
+
+  out_strbegin = begin + 1;
+  out_strend = strend;
+  out_escaped = false;
+  rbegin = strend + 1;
+  return true;
 }
 
 void dynd::parse_json(nd::array &out, const nd::array &json, const eval::eval_context *ectx) {
   const char *json_begin = NULL, *json_end = NULL;
   nd::array tmp_ref;
-  json_as_buffer(json, tmp_ref, json_begin, json_end);
+  parse_as_buffer(json, tmp_ref, json_begin, json_end, "JSON");
   parse_json(out, json_begin, json_end, ectx);
 }
 
 nd::array dynd::parse_json(const ndt::type &tp, const nd::array &json, const eval::eval_context *ectx) {
   const char *json_begin = NULL, *json_end = NULL;
   nd::array tmp_ref;
-  json_as_buffer(json, tmp_ref, json_begin, json_end);
+  parse_as_buffer(json, tmp_ref, json_begin, json_end, "JSON");
   return parse_json(tp, json_begin, json_end, ectx);
 }
 
 static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&json_begin,
-                       const char *json_end, const eval::eval_context *ectx);
+                       const char *json_end, json::structural_index &index, const eval::eval_context *ectx);
 
-static void skip_json_value(const char *&begin, const char *end) {
-  skip_whitespace(begin, end);
+static void skip_json_value(const char *&begin, const char *end, json::structural_index &index) {
+  begin = index.skip_whitespace(begin);
   if (begin == end) {
     throw parse_error(begin, "malformed JSON, expecting an element");
   }
@@ -87,23 +261,23 @@ static void skip_json_value(const char *&begin, const char *end) {
   // Object
   case '{':
     ++begin;
-    if (!parse_token(begin, end, "}")) {
+    if (!parse_json_token(index, begin, end, "}")) {
       for (;;) {
         const char *strbegin, *strend;
         bool escaped;
-        skip_whitespace(begin, end);
-        if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+        begin = index.skip_whitespace(begin);
+        if (!parse_json_string(index, begin, end, strbegin, strend, escaped)) {
           throw parse_error(begin, "expected string for name in object dict");
         }
-        if (!parse_token(begin, end, ":")) {
+        if (!parse_json_token(index, begin, end, ":")) {
           throw parse_error(begin, "expected ':' separating name from value in object dict");
         }
-        skip_json_value(begin, end);
-        if (!parse_token(begin, end, ",")) {
+        skip_json_value(begin, end, index);
+        if (!parse_json_token(index, begin, end, ",")) {
           break;
         }
       }
-      if (!parse_token(begin, end, "}")) {
+      if (!parse_json_token(index, begin, end, "}")) {
         throw parse_error(begin, "expected object separator ',' or terminator '}'");
       }
     }
@@ -111,14 +285,14 @@ static void skip_json_value(const char *&begin, const char *end) {
   // Array
   case '[':
     ++begin;
-    if (!parse_token(begin, end, "]")) {
+    if (!parse_json_token(index, begin, end, "]")) {
       for (;;) {
-        skip_json_value(begin, end);
-        if (!parse_token(begin, end, ",")) {
+        skip_json_value(begin, end, index);
+        if (!parse_json_token(index, begin, end, ",")) {
           break;
         }
       }
-      if (!parse_token(begin, end, "]")) {
+      if (!parse_json_token(index, begin, end, "]")) {
         throw parse_error(begin, "expected array separator ',' or terminator ']'");
       }
     }
@@ -126,23 +300,23 @@ static void skip_json_value(const char *&begin, const char *end) {
   case '"': {
     const char *strbegin, *strend;
     bool escaped;
-    if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+    if (!parse_json_string(index, begin, end, strbegin, strend, escaped)) {
       throw parse_error(begin, "invalid string");
     }
     break;
   }
   case 't':
-    if (!parse_token(begin, end, "true")) {
+    if (!parse_json_token(index, begin, end, "true")) {
       throw parse_error(begin, "invalid json value");
     }
     break;
   case 'f':
-    if (!parse_token(begin, end, "false")) {
+    if (!parse_json_token(index, begin, end, "false")) {
       throw parse_error(begin, "invalid json value");
     }
     break;
   case 'n':
-    if (!parse_token(begin, end, "null")) {
+    if (!parse_json_token(index, begin, end, "null")) {
       throw parse_error(begin, "invalid json value");
     }
     break;
@@ -159,7 +333,7 @@ static void skip_json_value(const char *&begin, const char *end) {
 }
 
 static void parse_strided_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                   const char *end, const eval::eval_context *ectx) {
+                                   const char *end, json::structural_index &index, const eval::eval_context *ectx) {
   intptr_t dim_size, stride;
   ndt::type el_tp;
   const char *el_arrmeta;
@@ -167,22 +341,22 @@ static void parse_strided_dim_json(const ndt::type &tp, const char *arrmeta, cha
     throw json_parse_error(begin, "expected a strided dimension", tp);
   }
 
-  if (!parse_token(begin, end, "[")) {
+  if (!parse_json_token(index, begin, end, "[")) {
     throw json_parse_error(begin, "expected list starting with '['", tp);
   }
   for (intptr_t i = 0; i < dim_size; ++i) {
-    parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, ectx);
-    if (i < dim_size - 1 && !parse_token(begin, end, ",")) {
+    parse_json(el_tp, el_arrmeta, out_data + i * stride, begin, end, index, ectx);
+    if (i < dim_size - 1 && !parse_json_token(index, begin, end, ",")) {
       throw json_parse_error(begin, "array is too short, expected ',' list item separator", tp);
     }
   }
-  if (!parse_token(begin, end, "]")) {
+  if (!parse_json_token(index, begin, end, "]")) {
     throw json_parse_error(begin, "array is too long, expected list terminator ']'", tp);
   }
 }
 
 static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                               const char *end, const eval::eval_context *ectx) {
+                               const char *end, json::structural_index &index, const eval::eval_context *ectx) {
   const ndt::var_dim_type *vad = tp.extended<ndt::var_dim_type>();
   const ndt::var_dim_type::metadata_type *md = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
   intptr_t stride = md->stride;
@@ -193,11 +367,11 @@ static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *o
   intptr_t size = 0, allocated_size = 8;
   out->begin = md->blockref->alloc(allocated_size);
 
-  if (!parse_token(begin, end, "[")) {
+  if (!parse_json_token(index, begin, end, "[")) {
     throw json_parse_error(begin, "expected array starting with '['", tp);
   }
   // If it's not an empty list, start the loop parsing the elements
-  if (!parse_token(begin, end, "]")) {
+  if (!parse_json_token(index, begin, end, "]")) {
     for (;;) {
       // Increase the allocated array size if necessary
       if (size == allocated_size) {
@@ -207,12 +381,12 @@ static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *o
       ++size;
       out->size = size;
       parse_json(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type), out->begin + (size - 1) * stride,
-                 begin, end, ectx);
-      if (!parse_token(begin, end, ",")) {
+                 begin, end, index, ectx);
+      if (!parse_json_token(index, begin, end, ",")) {
         break;
       }
     }
-    if (!parse_token(begin, end, "]")) {
+    if (!parse_json_token(index, begin, end, "]")) {
       throw json_parse_error(begin, "expected array separator ',' or terminator ']'", tp);
     }
   }
@@ -223,9 +397,10 @@ static void parse_var_dim_json(const ndt::type &tp, const char *arrmeta, char *o
 }
 
 static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                          const char *end, const eval::eval_context *ectx) {
+                                          const char *end, json::structural_index &index,
+                                          const eval::eval_context *ectx) {
   const char *saved_begin = begin;
-  if (!parse_token(begin, end, "{")) {
+  if (!parse_json_token(index, begin, end, "{")) {
     return false;
   }
 
@@ -239,15 +414,15 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
   memset(populated_fields.get(), 0, sizeof(bool) * field_count);
 
   // If it's not an empty object, start the loop parsing the elements
-  if (!parse_token(begin, end, "}")) {
+  if (!parse_json_token(index, begin, end, "}")) {
     for (;;) {
       const char *strbegin, *strend;
       bool escaped;
-      skip_whitespace(begin, end);
-      if (!parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+      begin = index.skip_whitespace(begin);
+      if (!parse_json_string(index, begin, end, strbegin, strend, escaped)) {
         throw json_parse_error(begin, "expected string for name in object dict", tp);
       }
-      if (!parse_token(begin, end, ":")) {
+      if (!parse_json_token(index, begin, end, ":")) {
         throw json_parse_error(begin, "expected ':' separating name from value in object dict", tp);
       }
       intptr_t i;
@@ -261,16 +436,17 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
       if (i == -1) {
         // TODO: Add an error policy to this parser of whether to throw an error
         //       or not. For now, just throw away fields not in the destination.
-        skip_json_value(begin, end);
+        skip_json_value(begin, end, index);
       } else {
-        parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, ectx);
+        parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, index,
+                   ectx);
         populated_fields[i] = true;
       }
-      if (!parse_token(begin, end, ",")) {
+      if (!parse_json_token(index, begin, end, ",")) {
         break;
       }
     }
-    if (!parse_token(begin, end, "}")) {
+    if (!parse_json_token(index, begin, end, "}")) {
       throw json_parse_error(begin, "expected object dict separator ',' or terminator '}'", tp);
     }
   }
@@ -296,8 +472,8 @@ static bool parse_struct_json_from_object(const ndt::type &tp, const char *arrme
 
 template <class Type>
 static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                                       const char *end, const eval::eval_context *ectx) {
-  if (!parse_token(begin, end, "[")) {
+                                       const char *end, json::structural_index &index, const eval::eval_context *ectx) {
+  if (!parse_json_token(index, begin, end, "[")) {
     return false;
   }
 
@@ -308,14 +484,15 @@ static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta,
 
   // Loop through all the fields
   for (intptr_t i = 0; i != field_count; ++i) {
-    skip_whitespace(begin, end);
-    parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, ectx);
-    if (i != field_count - 1 && !parse_token(begin, end, ",")) {
+    begin = index.skip_whitespace(begin);
+    parse_json(fsd->get_field_type(i), arrmeta + arrmeta_offsets[i], out_data + data_offsets[i], begin, end, index,
+               ectx);
+    if (i != field_count - 1 && !parse_json_token(index, begin, end, ",")) {
       throw json_parse_error(begin, "expected list item separator ','", tp);
     }
   }
 
-  if (!parse_token(begin, end, "]")) {
+  if (!parse_json_token(index, begin, end, "]")) {
     throw json_parse_error(begin, "expected end of list ']'", tp);
   }
 
@@ -323,33 +500,34 @@ static bool parse_tuple_json_from_list(const ndt::type &tp, const char *arrmeta,
 }
 
 static void parse_struct_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                              const char *end, const eval::eval_context *ectx) {
-  if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, ectx)) {
-  } else if (parse_tuple_json_from_list<ndt::struct_type>(tp, arrmeta, out_data, begin, end, ectx)) {
+                              const char *end, json::structural_index &index, const eval::eval_context *ectx) {
+  if (parse_struct_json_from_object(tp, arrmeta, out_data, begin, end, index, ectx)) {
+  } else if (parse_tuple_json_from_list<ndt::struct_type>(tp, arrmeta, out_data, begin, end, index, ectx)) {
   } else {
     throw json_parse_error(begin, "expected object dict starting with '{' or list with '['", tp);
   }
 }
 
 static void parse_tuple_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                             const char *end, const eval::eval_context *ectx) {
-  if (parse_tuple_json_from_list<ndt::tuple_type>(tp, arrmeta, out_data, begin, end, ectx)) {
+                             const char *end, json::structural_index &index, const eval::eval_context *ectx) {
+  if (parse_tuple_json_from_list<ndt::tuple_type>(tp, arrmeta, out_data, begin, end, index, ectx)) {
   } else {
     throw json_parse_error(begin, "expected object dict starting with '{' or list with '['", tp);
   }
 }
 
 static void parse_bool_json(const ndt::type &tp, const char *DYND_UNUSED(arrmeta), char *out_data, const char *&rbegin,
-                            const char *end, bool option, const eval::eval_context *ectx) {
+                            const char *end, json::structural_index &index, bool option,
+                            const eval::eval_context *ectx) {
   const char *begin = rbegin;
   char value = 3;
   const char *nbegin, *nend;
   bool escaped;
-  if (parse_token(begin, end, "true")) {
+  if (parse_json_token(index, begin, end, "true")) {
     value = 1;
-  } else if (parse_token(begin, end, "false")) {
+  } else if (parse_json_token(index, begin, end, "false")) {
     value = 0;
-  } else if (parse_token(begin, end, "null")) {
+  } else if (parse_json_token(index, begin, end, "null")) {
     if (option || ectx->errmode != assign_error_nocheck) {
       value = 2;
     } else {
@@ -363,7 +541,7 @@ static void parse_bool_json(const ndt::type &tp, const char *DYND_UNUSED(arrmeta
         value = 1;
       }
     }
-  } else if (parse_doublequote_string_no_ws(begin, end, nbegin, nend, escaped)) {
+  } else if (parse_json_string(index, begin, end, nbegin, nend, escaped)) {
     if (!escaped) {
       if (ectx->errmode == assign_error_nocheck) {
         value = parse<bool>(nbegin, nend, nocheck);
@@ -401,12 +579,12 @@ static void parse_bool_json(const ndt::type &tp, const char *DYND_UNUSED(arrmeta
 }
 
 static void parse_string_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&rbegin,
-                              const char *end, const eval::eval_context *ectx) {
+                              const char *end, json::structural_index &index, const eval::eval_context *ectx) {
   const char *begin = rbegin;
-  skip_whitespace(begin, end);
+  begin = index.skip_whitespace(begin);
   const char *strbegin, *strend;
   bool escaped;
-  if (parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+  if (parse_json_string(index, begin, end, strbegin, strend, escaped)) {
     const ndt::base_string_type *bsd = tp.extended<ndt::base_string_type>();
     try {
       if (!escaped) {
@@ -430,12 +608,13 @@ static void parse_string_json(const ndt::type &tp, const char *arrmeta, char *ou
 }
 
 static void parse_type(const ndt::type &tp, const char *DYND_UNUSED(arrmeta), char *out_data, const char *&rbegin,
-                       const char *end, bool option, const eval::eval_context *DYND_UNUSED(ectx)) {
+                       const char *end, json::structural_index &index, bool option,
+                       const eval::eval_context *DYND_UNUSED(ectx)) {
   const char *begin = rbegin;
-  skip_whitespace(begin, end);
+  begin = index.skip_whitespace(begin);
   const char *strbegin, *strend;
   bool escaped;
-  if (option && parse_token(begin, end, "null")) {
+  if (option && parse_json_token(index, begin, end, "null")) {
     switch (tp.get_id()) {
     case type_id:
       *reinterpret_cast<ndt::type *>(out_data) = ndt::type();
@@ -446,7 +625,7 @@ static void parse_type(const ndt::type &tp, const char *DYND_UNUSED(arrmeta), ch
     stringstream ss;
     ss << "Unrecognized type type \"" << tp << "\"";
     throw runtime_error(ss.str());
-  } else if (parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+  } else if (parse_json_string(index, begin, end, strbegin, strend, escaped)) {
     std::string val;
     if (escaped) {
       unescape_string(strbegin, strend, val);
@@ -469,13 +648,13 @@ static void parse_type(const ndt::type &tp, const char *DYND_UNUSED(arrmeta), ch
 }
 
 static void parse_dim_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                           const char *end, const eval::eval_context *ectx) {
+                           const char *end, json::structural_index &index, const eval::eval_context *ectx) {
   switch (tp.get_id()) {
   case fixed_dim_id:
-    parse_strided_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_strided_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     break;
   case var_dim_id:
-    parse_var_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_var_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     break;
   default: {
     stringstream ss;
@@ -486,18 +665,18 @@ static void parse_dim_json(const ndt::type &tp, const char *arrmeta, char *out_d
 }
 
 static void parse_option_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin,
-                              const char *end, const eval::eval_context *ectx) {
-  skip_whitespace(begin, end);
+                              const char *end, json::structural_index &index, const eval::eval_context *ectx) {
+  begin = index.skip_whitespace(begin);
   const char *saved_begin = begin;
   if (tp.is_scalar()) {
-    if (parse_token(begin, end, "null")) {
+    if (parse_json_token(index, begin, end, "null")) {
       nd::old_assign_na(tp, arrmeta, out_data);
       return;
     } else {
       const ndt::type &value_tp = tp.extended<ndt::option_type>()->get_value_type();
       const char *strbegin, *strend;
       bool escaped;
-      if (parse_doublequote_string_no_ws(begin, end, strbegin, strend, escaped)) {
+      if (parse_json_string(index, begin, end, strbegin, strend, escaped)) {
         try {
           if (!escaped) {
             nd::set_option_from_utf8_string(tp, arrmeta, out_data, strbegin, strend, ectx);
@@ -513,9 +692,9 @@ static void parse_option_json(const ndt::type &tp, const char *arrmeta, char *ou
           throw json_parse_error(saved_begin, e.what(), tp);
         }
       } else if (value_tp.get_id() == bool_id) {
-        if (parse_token(begin, end, "true")) {
+        if (parse_json_token(index, begin, end, "true")) {
           *out_data = 1;
-        } else if (parse_token(begin, end, "false")) {
+        } else if (parse_json_token(index, begin, end, "false")) {
           *out_data = 0;
         } else if (json::parse_number(begin, end, strbegin, strend)) {
           if (compare_range_to_literal(strbegin, strend, "1")) {
@@ -549,21 +728,21 @@ static void parse_option_json(const ndt::type &tp, const char *arrmeta, char *ou
 }
 
 static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data, const char *&begin, const char *end,
-                       const eval::eval_context *ectx) {
-  skip_whitespace(begin, end);
+                       json::structural_index &index, const eval::eval_context *ectx) {
+  begin = index.skip_whitespace(begin);
   switch (tp.get_id()) {
   case fixed_dim_id:
   case var_dim_id:
-    parse_dim_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_dim_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case struct_id:
-    parse_struct_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_struct_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case tuple_id:
-    parse_tuple_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_tuple_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case bool_id:
-    parse_bool_json(tp, arrmeta, out_data, begin, end, false, ectx);
+    parse_bool_json(tp, arrmeta, out_data, begin, end, index, false, ectx);
     return;
   case int8_id:
   case int16_id:
@@ -585,13 +764,13 @@ static void parse_json(const ndt::type &tp, const char *arrmeta, char *out_data,
     return;
   case fixed_string_id:
   case string_id:
-    parse_string_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_string_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   case type_id:
-    parse_type(tp, arrmeta, out_data, begin, end, false, ectx);
+    parse_type(tp, arrmeta, out_data, begin, end, index, false, ectx);
     return;
   case option_id:
-    parse_option_json(tp, arrmeta, out_data, begin, end, ectx);
+    parse_option_json(tp, arrmeta, out_data, begin, end, index, ectx);
     return;
   default:
     break;
@@ -612,7 +791,7 @@ static void get_error_line_column(const char *begin, const char *end, const char
   out_line_prev = "";
   out_line_cur = "";
   out_line = 1;
-  while (begin < end) {
+  while (begin <= end) {
     const char *line_end = (const char *)memchr(begin, '\n', end - begin);
     out_line_prev.swap(out_line_cur);
     // If no \n was found
@@ -669,8 +848,9 @@ void print_json_parse_error_marker(std::ostream &o, const std::string &line_prev
 void dynd::validate_json(const char *json_begin, const char *json_end) {
   try {
     const char *begin = json_begin, *end = json_end;
-    ::skip_json_value(begin, end);
-    skip_whitespace(begin, end);
+    json::structural_index index(begin, end);
+    ::skip_json_value(begin, end, index);
+    begin = index.skip_whitespace(begin);
     if (begin != end) {
       throw parse_error(begin, "unexpected trailing JSON text");
     }
@@ -686,34 +866,41 @@ void dynd::validate_json(const char *json_begin, const char *json_end) {
   }
 }
 
+/**
+ * Throws the error raised while parsing the JSON between ``json_begin`` and
+ * ``json_end`` again, with the line and column where it happened. The text may
+ * start part of the way into a larger input, at ``first_line`` and
+ * ``first_column``.
+ */
+static void throw_json_parse_error(const char *json_begin, const char *json_end, const parse_error &e,
+                                   int first_line = 1, int first_column = 1) {
+  stringstream ss;
+  std::string line_prev, line_cur;
+  int line, column;
+  get_error_line_column(json_begin, json_end, e.get_position(), line_prev, line_cur, line, column);
+  ss << "Error parsing JSON at line " << (first_line + line - 1) << ", column "
+     << ((line == 1) ? first_column + column - 1 : column) << "\n";
+  const json_parse_error *json_e = dynamic_cast<const json_parse_error *>(&e);
+  if (json_e != NULL) {
+    ss << "DyND Type: " << json_e->get_type() << "\n";
+  }
+  ss << "Message: " << e.what() << "\n";
+  print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
+  throw invalid_argument(ss.str());
+}
+
 void dynd::parse_json(nd::array &out, const char *json_begin, const char *json_end, const eval::eval_context *ectx) {
   try {
     const char *begin = json_begin, *end = json_end;
     ndt::type tp = out.get_type();
-    ::parse_json(tp, out.get()->metadata(), out.data(), begin, end, ectx);
-    skip_whitespace(begin, end);
+    json::structural_index index(begin, end);
+    ::parse_json(tp, out.get()->metadata(), out.data(), begin, end, index, ectx);
+    begin = index.skip_whitespace(begin);
     if (begin != end) {
       throw json_parse_error(begin, "unexpected trailing JSON text", tp);
     }
-  } catch (const json_parse_error &e) {
-    stringstream ss;
-    std::string line_prev, line_cur;
-    int line, column;
-    get_error_line_column(json_begin, json_end, e.get_position(), line_prev, line_cur, line, column);
-    ss << "Error parsing JSON at line " << line << ", column " << column << "\n";
-    ss << "DyND Type: " << e.get_type() << "\n";
-    ss << "Message: " << e.what() << "\n";
-    print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
-    throw invalid_argument(ss.str());
   } catch (const parse_error &e) {
-    stringstream ss;
-    std::string line_prev, line_cur;
-    int line, column;
-    get_error_line_column(json_begin, json_end, e.get_position(), line_prev, line_cur, line, column);
-    ss << "Error parsing JSON at line " << line << ", column " << column << "\n";
-    ss << "Message: " << e.what() << "\n";
-    print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
-    throw invalid_argument(ss.str());
+    throw_json_parse_error(json_begin, json_end, e);
   }
 }
 
@@ -728,6 +915,275 @@ nd::array dynd::parse_json(const ndt::type &tp, const char *json_begin, const ch
   return result;
 }
 
+// The smallest number of bytes of newline-delimited JSON given to a thread
+static const intptr_t min_lines_chunk_size = 65536;
+
+static const char *find_line_end(const char *begin, const char *end) {
+  const char *line_end = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+  return (line_end == NULL) ? end : line_end;
+}
+
+/**
+ * Returns the number of lines between ``begin`` and ``end`` which are not
+ * blank.
+ */
+static intptr_t count_json_lines(const char *begin, const char *end) {
+  intptr_t count = 0;
+  for (;;) {
+    skip_whitespace(begin, end);
+    if (begin == end) {
+      return count;
+    }
+    ++count;
+    begin = find_line_end(begin, end);
+  }
+}
+
+/**
+ * Parses the value on every line between ``begin`` and ``end`` which is not
+ * blank into consecutive elements of type ``tp``, starting at ``out_data``.
+ */
+static void parse_json_lines(const ndt::type &tp, const char *arrmeta, char *out_data, intptr_t stride,
+                             const char *begin, const char *end, const eval::eval_context *ectx) {
+  json::structural_index index(begin, end);
+  for (;;) {
+    begin = index.skip_whitespace(begin);
+    if (begin == end) {
+      return;
+    }
+    const char *line_end = find_line_end(begin, end);
+    ::parse_json(tp, arrmeta, out_data, begin, end, index, ectx);
+    if (begin > line_end) {
+      throw json_parse_error(line_end, "expected a single JSON value on every line", tp);
+    }
+    skip_whitespace(begin, line_end);
+    if (begin != line_end) {
+      throw json_parse_error(begin, "unexpected trailing JSON text", tp);
+    }
+    out_data += stride;
+  }
+}
+
+nd::array nd::json::parse_lines(const ndt::type &tp, const char *json_begin, const char *json_end,
+                                const eval::eval_context *ectx) {
+  const ndt::type &element_tp = (tp.get_id() == var_dim_id) ? tp.extended<ndt::var_dim_type>()->get_element_type() : tp;
+
+  // The variable-sized dimensions within an element all allocate from the same
+  // memory block, so elements which have them are parsed on a single thread
+  intptr_t nchunks = 1;
+  if ((element_tp.get_flags() & type_flag_blockref) == 0) {
+    nchunks = std::max<intptr_t>(std::min<intptr_t>(ectx->nthreads, (json_end - json_begin) / min_lines_chunk_size), 1);
+  }
+
+  // The chunks are split after a newline, so every line is within one of them
+  std::vector<const char *> bounds(nchunks + 1);
+  bounds[0] = json_begin;
+  for (intptr_t i = 1; i < nchunks; ++i) {
+    const char *it = json_begin + i * (json_end - json_begin) / nchunks;
+    it = find_line_end(std::max(it - 1, bounds[i - 1]), json_end);
+    bounds[i] = (it == json_end) ? json_end : it + 1;
+  }
+  bounds[nchunks] = json_end;
+
+  // Once the lines of every chunk are counted, each is parsed straight into its
+  // own part of the result
+  std::vector<intptr_t> offsets(nchunks + 1);
+  thread_pool::get().parallel_for(nchunks,
+                                  [&](size_t i) { offsets[i + 1] = count_json_lines(bounds[i], bounds[i + 1]); });
+  for (intptr_t i = 0; i < nchunks; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+
+  array result = empty(ndt::make_type<ndt::var_dim_type>(element_tp));
+  const ndt::var_dim_type::metadata_type *md =
+      reinterpret_cast<const ndt::var_dim_type::metadata_type *>(result.get()->metadata());
+  ndt::var_dim_type::data_type *out = reinterpret_cast<ndt::var_dim_type::data_type *>(result.data());
+  out->begin = md->blockref->alloc(offsets[nchunks]);
+  out->size = offsets[nchunks];
+
+  // The error on the earliest line is the one reported
+  std::vector<std::exception_ptr> errors(nchunks);
+  thread_pool::get().parallel_for(nchunks, [&](size_t i) {
+    try {
+      parse_json_lines(element_tp, result.get()->metadata() + sizeof(ndt::var_dim_type::metadata_type),
+                       out->begin + offsets[i] * md->stride, md->stride, bounds[i], bounds[i + 1], ectx);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  });
+  for (const std::exception_ptr &error : errors) {
+    if (error) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const parse_error &e) {
+        throw_json_parse_error(json_begin, json_end, e);
+      }
+    }
+  }
+
+  result.get_type().extended()->arrmeta_finalize_buffers(result.get()->metadata());
+  return result;
+}
+
+nd::array nd::json::parse_lines(const ndt::type &tp, const array &json, const eval::eval_context *ectx) {
+  const char *json_begin = NULL, *json_end = NULL;
+  array tmp_ref;
+  parse_as_buffer(json, tmp_ref, json_begin, json_end, "JSON");
+  return parse_lines(tp, json_begin, json_end, ectx);
+}
+
+const size_t nd::json::stream_parser::chunk_size;
+
+nd::json::stream_parser::stream_parser(const ndt::type &tp, const std::function<size_t(char *, size_t)> &read,
+                                       intptr_t batch_size, const eval::eval_context *ectx)
+    : m_tp(tp), m_read(read), m_batch_size(batch_size), m_ectx(ectx), m_begin(0), m_scanned(0), m_eof(false),
+      m_line(1), m_column(1), m_state(before_array), m_depth(0), m_in_string(false), m_escaped(false) {
+  if (batch_size <= 0) {
+    throw invalid_argument("json::stream_parser: the batch size must be positive");
+  }
+}
+
+nd::json::stream_parser::stream_parser(const ndt::type &tp, std::istream &in, intptr_t batch_size,
+                                       const eval::eval_context *ectx)
+    : stream_parser(tp,
+                    [&in](char *data, size_t size) {
+                      in.read(data, size);
+                      return static_cast<size_t>(in.gcount());
+                    },
+                    batch_size, ectx) {}
+
+bool nd::json::stream_parser::read_chunk() {
+  size_t size = m_buffer.size();
+  m_buffer.resize(size + chunk_size);
+  size_t nread = m_read(m_buffer.data() + size, chunk_size);
+  m_buffer.resize(size + nread);
+  m_eof = nread == 0;
+  return !m_eof;
+}
+
+void nd::json::stream_parser::scan() {
+  const char *buffer = m_buffer.data();
+  size_t size = m_buffer.size();
+  for (; m_scanned < size && static_cast<intptr_t>(m_element_ends.size()) < m_batch_size; ++m_scanned) {
+    char c = buffer[m_scanned];
+    switch (m_state) {
+    case before_array:
+      if (c == '[') {
+        m_state = array_begin;
+        m_begin = m_scanned + 1;
+      } else if (!DYND_ISSPACE(c)) {
+        throw parse_error(buffer + m_scanned, "expected a JSON array");
+      }
+      break;
+    case array_begin:
+      if (c == ']') {
+        m_state = after_array;
+        break;
+      } else if (DYND_ISSPACE(c)) {
+        break;
+      }
+      m_state = in_element;
+    // Fall through
+    case in_element:
+      // Only the nesting and the strings are tracked, the parser checks the rest
+      if (m_in_string) {
+        if (m_escaped) {
+          m_escaped = false;
+        } else if (c == '\\') {
+          m_escaped = true;
+        } else if (c == '"') {
+          m_in_string = false;
+        }
+      } else if (c == '"') {
+        m_in_string = true;
+      } else if (c == '[' || c == '{') {
+        ++m_depth;
+      } else if (c == ']' || c == '}') {
+        if (m_depth == 0) {
+          if (c == '}') {
+            throw parse_error(buffer + m_scanned, "unexpected '}'");
+          }
+          m_element_ends.push_back(m_scanned);
+          m_state = after_array;
+        } else {
+          --m_depth;
+        }
+      } else if (c == ',' && m_depth == 0) {
+        m_element_ends.push_back(m_scanned);
+      }
+      break;
+    case after_array:
+      if (!DYND_ISSPACE(c)) {
+        throw parse_error(buffer + m_scanned, "unexpected trailing JSON text");
+      }
+      break;
+    }
+  }
+}
+
+void nd::json::stream_parser::consume(size_t size) {
+  for (const char *it = m_buffer.data(), *end = it + size; it < end; ++it) {
+    if (*it == '\n') {
+      ++m_line;
+      m_column = 1;
+    } else {
+      ++m_column;
+    }
+  }
+  m_buffer.erase(m_buffer.begin(), m_buffer.begin() + size);
+}
+
+bool nd::json::stream_parser::next(array &out) {
+  try {
+    m_element_ends.clear();
+    while (static_cast<intptr_t>(m_element_ends.size()) < m_batch_size) {
+      if (m_scanned == m_buffer.size() && (m_eof || !read_chunk())) {
+        break;
+      }
+      scan();
+    }
+
+    if (m_eof && m_state != after_array) {
+      const char *end = m_buffer.data() + m_buffer.size();
+      throw parse_error(end, (m_state == before_array) ? "expected a JSON array" : "unexpected end of JSON input");
+    }
+    if (m_element_ends.empty()) {
+      return false;
+    }
+
+    array result = empty(ndt::make_type<ndt::var_dim_type>(m_tp));
+    const ndt::var_dim_type::metadata_type *md =
+        reinterpret_cast<const ndt::var_dim_type::metadata_type *>(result.get()->metadata());
+    ndt::var_dim_type::data_type *result_data = reinterpret_cast<ndt::var_dim_type::data_type *>(result.data());
+    result_data->begin = md->blockref->alloc(m_element_ends.size());
+    result_data->size = m_element_ends.size();
+
+    const char *begin = m_buffer.data() + m_begin, *end = m_buffer.data() + m_element_ends.back();
+    dynd::json::structural_index index(begin, end);
+    for (size_t i = 0; i < m_element_ends.size(); ++i) {
+      const char *element_end = m_buffer.data() + m_element_ends[i];
+      ::parse_json(m_tp, result.get()->metadata() + sizeof(ndt::var_dim_type::metadata_type),
+                   result_data->begin + i * md->stride, begin, end, index, m_ectx);
+      begin = index.skip_whitespace(begin);
+      if (begin != element_end) {
+        throw json_parse_error(begin, "expected array separator ',' or terminator ']'", m_tp);
+      }
+      ++begin;
+    }
+    result.get_type().extended()->arrmeta_finalize_buffers(result.get()->metadata());
+
+    // The text parsed is dropped, along with the comma or bracket after it
+    consume(m_element_ends.back() + 1);
+    m_scanned -= m_element_ends.back() + 1;
+    m_begin = 0;
+    out = result;
+    return true;
+  } catch (const parse_error &e) {
+    throw_json_parse_error(m_buffer.data(), m_buffer.data() + m_buffer.size(), e, m_line, m_column);
+    return false;
+  }
+}
+
 /*
 static ndt::type discover_type(const char *&begin, const char *end)
 {
@@ -0,0 +1,261 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+
+#include <dynd/array.hpp>
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/kernel_cache.hpp>
+#include <dynd/simd.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+const uint32_t uncacheable_flags = type_flag_blockref | type_flag_destructor;
+
+template <typename T>
+void append(std::string &bytes, const T &value) {
+  bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Appends the value of a keyword argument, if it is made of builtin types
+bool append_value(std::string &bytes, const ndt::type &tp, const char *arrmeta, const char *data) {
+  if (tp.is_builtin()) {
+    bytes.append(data, tp.get_data_size());
+    return true;
+  }
+
+  if (tp.get_id() == fixed_dim_id) {
+    const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+    const ndt::type &el_tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    for (intptr_t i = 0; i < ss->dim_size; ++i) {
+      if (!append_value(bytes, el_tp, arrmeta + sizeof(size_stride_t), data + i * ss->stride)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+unique_ptr<char[]> copy_arrmeta(const ndt::type &tp, const char *arrmeta) {
+  size_t size = tp.get_arrmeta_size();
+  unique_ptr<char[]> copy(new char[size > 0 ? size : 1]);
+  if (size > 0) {
+    memcpy(copy.get(), arrmeta, size);
+  }
+  return copy;
+}
+
+} // anonymous namespace
+
+void nd::kernel_cache::entry_type::instantiate(kernel_request_t kernreq, const char *dst_arrmeta, size_t nsrc,
+                                               const ndt::type *src_tp, const char *const *src_arrmeta) {
+  uint32_t flags = dst_tp.get_flags();
+  for (size_t i = 0; i < nsrc; ++i) {
+    flags |= src_tp[i].get_flags();
+  }
+
+  kb.reset(new kernel_builder(cg.get(), arena));
+  if (arena != NULL || (flags & uncacheable_flags) != 0) {
+    // This kernel is not going to be cached, so it can use the arrmeta of the call
+    (*kb)(kernreq, nullptr, dst_arrmeta, nsrc, src_arrmeta);
+  } else {
+    // The arrmeta of types without references or destructors is plain data
+    this->dst_arrmeta = copy_arrmeta(dst_tp, dst_arrmeta);
+    for (size_t i = 0; i < nsrc; ++i) {
+      this->src_arrmeta.push_back(copy_arrmeta(src_tp[i], src_arrmeta[i]));
+      src_arrmeta_ptrs.push_back(this->src_arrmeta.back().get());
+    }
+
+    (*kb)(kernreq, nullptr, this->dst_arrmeta.get(), nsrc, src_arrmeta_ptrs.data());
+  }
+
+  kernel_cache::get().add_storage(cg.size(), kb->size());
+}
+
+nd::kernel_cache::kernel_cache(size_t capacity) : m_capacity(capacity), m_hits(0), m_misses(0), m_storage() {}
+
+size_t nd::kernel_cache::capacity() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+void nd::kernel_cache::set_capacity(size_t capacity) {
+  list_type evicted;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_capacity = capacity;
+    while (m_entries.size() > m_capacity) {
+      m_index.erase(&m_entries.back().first);
+      evicted.splice(evicted.begin(), m_entries, prev(m_entries.end()));
+    }
+  }
+  // The evicted kernels are destroyed outside of the lock
+}
+
+size_t nd::kernel_cache::size() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+size_t nd::kernel_cache::hits() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_hits;
+}
+
+size_t nd::kernel_cache::misses() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_misses;
+}
+
+void nd::kernel_cache::clear() {
+  list_type evicted;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_index.clear();
+    evicted.swap(m_entries);
+    m_hits = 0;
+    m_misses = 0;
+    m_storage = storage_stats();
+  }
+}
+
+nd::kernel_cache::storage_stats nd::kernel_cache::get_storage_stats() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_storage;
+}
+
+void nd::kernel_cache::add_storage(size_t call_graph_bytes, size_t kernel_bytes) {
+  lock_guard<mutex> lock(m_mutex);
+  ++m_storage.ninstantiated;
+  m_storage.call_graph_bytes += call_graph_bytes;
+  m_storage.kernel_bytes += kernel_bytes;
+  m_storage.last_call_graph_bytes = call_graph_bytes;
+  m_storage.last_kernel_bytes = kernel_bytes;
+}
+
+bool nd::kernel_cache::make_key(key_type &key, const base_callable *callable, kernel_request_t kernreq,
+                                const ndt::type &dst_tp, const char *dst_arrmeta, size_t nsrc,
+                                const ndt::type *src_tp, const char *const *src_arrmeta, size_t nkwd,
+                                const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
+  if (capacity() == 0 || !tp_vars.empty() || callable->is_kwd_variadic()) {
+    return false;
+  }
+
+  key.callable = callable;
+  key.kernreq = kernreq;
+  key.types.clear();
+  key.bytes.clear();
+
+  key.types.push_back(dst_tp);
+  if (dst_arrmeta != NULL) {
+    if ((dst_tp.get_flags() & uncacheable_flags) != 0) {
+      return false;
+    }
+    key.bytes.append(dst_arrmeta, dst_tp.get_arrmeta_size());
+  }
+
+  for (size_t i = 0; i < nsrc; ++i) {
+    if ((src_tp[i].get_flags() & uncacheable_flags) != 0) {
+      return false;
+    }
+    key.types.push_back(src_tp[i]);
+    key.bytes.append(src_arrmeta[i], src_tp[i].get_arrmeta_size());
+  }
+
+  // The count passed in may include special keywords such as "dst", which are not stored
+  nkwd = min(nkwd, static_cast<size_t>(callable->get_nkwd()));
+  for (size_t i = 0; i < nkwd; ++i) {
+    if (kwds[i].is_null()) {
+      key.types.push_back(ndt::type());
+      continue;
+    }
+
+    const ndt::type &tp = kwds[i].get_type();
+    key.types.push_back(tp);
+    if (!append_value(key.bytes, tp, kwds[i]->metadata(), kwds[i].cdata())) {
+      return false;
+    }
+  }
+
+  // Settings which change how kernels are resolved
+  append(key.bytes, eval::default_eval_context.errmode);
+  append(key.bytes, eval::default_eval_context.nthreads);
+  append(key.bytes, eval::default_eval_context.min_grain_size);
+  append(key.bytes, simd::get_instruction_set());
+
+  size_t hash = std::hash<std::string>()(key.bytes);
+  hash ^= std::hash<const void *>()(callable) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= kernreq + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  for (const ndt::type &tp : key.types) {
+    hash ^= (static_cast<size_t>(tp.get_id()) * 31 + tp.get_ndim()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  key.hash = hash;
+
+  return true;
+}
+
+unique_ptr<nd::kernel_cache::entry_type> nd::kernel_cache::take(const key_type &key) {
+  lock_guard<mutex> lock(m_mutex);
+  auto it = m_index.find(&key);
+  if (it == m_index.end()) {
+    ++m_misses;
+    return nullptr;
+  }
+
+  ++m_hits;
+  unique_ptr<entry_type> entry = std::move(it->second->second);
+  m_entries.erase(it->second);
+  m_index.erase(it);
+  return entry;
+}
+
+void nd::kernel_cache::put(key_type &&key, unique_ptr<entry_type> entry) {
+  if ((entry->dst_tp.get_flags() & uncacheable_flags) != 0) {
+    return;
+  }
+
+  list_type evicted;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_capacity == 0 || m_index.find(&key) != m_index.end()) {
+      // Another call put the same kernel back first
+      return;
+    }
+
+    m_entries.emplace_front(std::move(key), std::move(entry));
+    m_index[&m_entries.front().first] = m_entries.begin();
+    while (m_entries.size() > m_capacity) {
+      m_index.erase(&m_entries.back().first);
+      evicted.splice(evicted.begin(), m_entries, prev(m_entries.end()));
+    }
+  }
+}
+
+void nd::kernel_cache::erase(const base_callable *callable) {
+  list_type evicted;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+      auto next_it = next(it);
+      if (it->first.callable == callable) {
+        m_index.erase(&it->first);
+        evicted.splice(evicted.begin(), m_entries, it);
+      }
+      it = next_it;
+    }
+  }
+}
+
+nd::kernel_cache &nd::kernel_cache::get() {
+  // Never destroyed, so that callables destroyed at exit can still erase their kernels
+  static kernel_cache *cache = new kernel_cache();
+  return *cache;
+}
@@ -4,6 +4,7 @@
 //
 
 #include <climits>
+#include <sstream>
 #include <string>
 
 #include <dynd/callables/multidispatch_callable.hpp>
@@ -13,6 +14,7 @@
 #include <dynd/parse.hpp>
 #include <dynd/string_encodings.hpp>
 #include <dynd/types/any_kind_type.hpp>
+#include <dynd/types/base_bytes_type.hpp>
 #include <dynd/types/option_type.hpp>
 
 using namespace std;
@@ -50,3 +52,36 @@ nd::callable make_dynamic_parse() {
 } // unnamed namespace
 
 DYND_API nd::callable nd::json::dynamic_parse = make_dynamic_parse();
+
+void dynd::parse_as_buffer(const nd::array &text, nd::array &out_tmp_ref, const char *&begin, const char *&end,
+                           const char *format) {
+  ndt::type text_tp = text.get_type().value_type();
+  switch (text_tp.get_base_id()) {
+  case string_kind_id: {
+    const ndt::base_string_type *sdt = text_tp.extended<ndt::base_string_type>();
+    if (sdt->get_encoding() == string_encoding_ascii || sdt->get_encoding() == string_encoding_utf_8) {
+      // The data is already UTF-8, so use the buffer directly
+      out_tmp_ref = text.eval();
+    } else {
+      // The data needs to be converted to UTF-8 before parsing
+      text_tp = ndt::make_type<ndt::string_type>();
+      out_tmp_ref = text.ucast(text_tp).eval();
+      sdt = text_tp.extended<ndt::base_string_type>();
+    }
+    sdt->get_string_range(&begin, &end, out_tmp_ref.get()->metadata(), out_tmp_ref.cdata());
+    break;
+  }
+  case fixed_bytes_kind_id:
+  case bytes_kind_id:
+    out_tmp_ref = text.eval();
+    text_tp.extended<ndt::base_bytes_type>()->get_bytes_range(&begin, &end, out_tmp_ref.get()->metadata(),
+                                                               out_tmp_ref.cdata());
+    break;
+  default: {
+    stringstream ss;
+    ss << "Input for " << format << " parsing must be either bytes (interpreted as UTF-8) or a string, not \""
+       << text_tp << "\"";
+    throw runtime_error(ss.str());
+  }
+  }
+}
@@ -0,0 +1,416 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+#include <dynd/simd.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::simd;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DYND_SIMD_X86
+#endif
+
+namespace {
+
+#ifdef DYND_SIMD_X86
+
+// The loops below are written with the GCC vector extensions, and compiled once per
+// instruction set with the target attribute, so the library itself does not need
+// to be built for a particular CPU.
+
+template <binary_op Op, typename LaneType, size_t VectorSize, size_t NLane, bool Scalar0, bool Scalar1>
+inline __attribute__((always_inline)) void binary_loop_body(char *dst, char *const *src, size_t count) {
+  typedef LaneType vector_type __attribute__((vector_size(VectorSize)));
+  const size_t vector_nlane = VectorSize / sizeof(LaneType);
+
+  LaneType *d = reinterpret_cast<LaneType *>(dst);
+  const LaneType *s0 = reinterpret_cast<const LaneType *>(src[0]);
+  const LaneType *s1 = reinterpret_cast<const LaneType *>(src[1]);
+
+  // A broadcast element fills a vector with its lanes repeated
+  vector_type a, b;
+  for (size_t k = 0; k < vector_nlane; ++k) {
+    a[k] = Scalar0 ? s0[k % NLane] : LaneType();
+    b[k] = Scalar1 ? s1[k % NLane] : LaneType();
+  }
+
+  // Each element of a complex type is NLane lanes
+  size_t n = count * NLane;
+  size_t i = 0;
+  for (; i + vector_nlane <= n; i += vector_nlane) {
+    if (!Scalar0) {
+      memcpy(&a, s0 + i, VectorSize);
+    }
+    if (!Scalar1) {
+      memcpy(&b, s1 + i, VectorSize);
+    }
+
+    vector_type r;
+    switch (Op) {
+    case op_add:
+      r = a + b;
+      break;
+    case op_subtract:
+      r = a - b;
+      break;
+    case op_multiply:
+      r = a * b;
+      break;
+    case op_divide:
+      r = a / b;
+      break;
+    }
+    memcpy(d + i, &r, VectorSize);
+  }
+
+  for (; i < n; ++i) {
+    LaneType x = Scalar0 ? s0[i % NLane] : s0[i];
+    LaneType y = Scalar1 ? s1[i % NLane] : s1[i];
+    switch (Op) {
+    case op_add:
+      d[i] = x + y;
+      break;
+    case op_subtract:
+      d[i] = x - y;
+      break;
+    case op_multiply:
+      d[i] = x * y;
+      break;
+    case op_divide:
+      d[i] = x / y;
+      break;
+    }
+  }
+}
+
+#define DYND_DEF_BINARY_LOOP(NAME, TARGET, VECTOR_SIZE)                                                                \
+  template <binary_op Op, typename LaneType, size_t NLane>                                                             \
+  __attribute__((target(TARGET))) void NAME(char *dst, char *const *src, const intptr_t *src_stride, size_t count) {   \
+    if (src_stride[0] == 0) {                                                                                          \
+      if (src_stride[1] == 0) {                                                                                        \
+        binary_loop_body<Op, LaneType, VECTOR_SIZE, NLane, true, true>(dst, src, count);                               \
+      } else {                                                                                                         \
+        binary_loop_body<Op, LaneType, VECTOR_SIZE, NLane, true, false>(dst, src, count);                              \
+      }                                                                                                                \
+    } else if (src_stride[1] == 0) {                                                                                   \
+      binary_loop_body<Op, LaneType, VECTOR_SIZE, NLane, false, true>(dst, src, count);                                \
+    } else {                                                                                                           \
+      binary_loop_body<Op, LaneType, VECTOR_SIZE, NLane, false, false>(dst, src, count);                               \
+    }                                                                                                                  \
+  }
+
+DYND_DEF_BINARY_LOOP(sse2_binary_loop, "sse2", 16)
+DYND_DEF_BINARY_LOOP(avx2_binary_loop, "avx2", 32)
+DYND_DEF_BINARY_LOOP(avx512_binary_loop, "avx512f", 64)
+
+#undef DYND_DEF_BINARY_LOOP
+
+template <binary_op Op, typename LaneType, size_t NLane = 1>
+binary_loop_t make_binary_loop(instruction_set isa) {
+  switch (isa) {
+  case isa_sse2:
+    return &sse2_binary_loop<Op, LaneType, NLane>;
+  case isa_avx2:
+    return &avx2_binary_loop<Op, LaneType, NLane>;
+  case isa_avx512:
+    return &avx512_binary_loop<Op, LaneType, NLane>;
+  default:
+    return NULL;
+  }
+}
+
+// Integer division has no vector instruction, and needs the zero check of the
+// scalar kernel, so only the other operators are vectorized for integers
+template <typename LaneType>
+binary_loop_t get_integer_binary_loop(binary_op op, instruction_set isa) {
+  switch (op) {
+  case op_add:
+    return make_binary_loop<op_add, LaneType>(isa);
+  case op_subtract:
+    return make_binary_loop<op_subtract, LaneType>(isa);
+  case op_multiply:
+    return make_binary_loop<op_multiply, LaneType>(isa);
+  default:
+    return NULL;
+  }
+}
+
+template <typename LaneType>
+binary_loop_t get_real_binary_loop(binary_op op, instruction_set isa) {
+  switch (op) {
+  case op_add:
+    return make_binary_loop<op_add, LaneType>(isa);
+  case op_subtract:
+    return make_binary_loop<op_subtract, LaneType>(isa);
+  case op_multiply:
+    return make_binary_loop<op_multiply, LaneType>(isa);
+  case op_divide:
+    return make_binary_loop<op_divide, LaneType>(isa);
+  default:
+    return NULL;
+  }
+}
+
+// Only addition and subtraction of complex numbers act on each lane separately
+template <typename LaneType>
+binary_loop_t get_complex_binary_loop(binary_op op, instruction_set isa) {
+  switch (op) {
+  case op_add:
+    return make_binary_loop<op_add, LaneType, 2>(isa);
+  case op_subtract:
+    return make_binary_loop<op_subtract, LaneType, 2>(isa);
+  default:
+    return NULL;
+  }
+}
+
+// The substring search compares the first and the last byte of the needle at
+// every position of a vector of the haystack at once, and only compares the
+// rest of the needle where both match. The positions left over at the end are
+// covered by one more vector, which overlaps the previous one.
+
+inline intptr_t find_tail(const char *haystack, size_t n, const char *needle, size_t m) {
+  for (size_t i = 0; i + m <= n; ++i) {
+    if (haystack[i] == needle[0] && haystack[i + m - 1] == needle[m - 1] &&
+        memcmp(haystack + i + 1, needle + 1, m - 2) == 0) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+inline intptr_t find_in_mask(const char *haystack, const char *needle, size_t m, size_t i, unsigned mask) {
+  while (mask != 0) {
+    size_t k = __builtin_ctz(mask);
+    if (memcmp(haystack + i + k + 1, needle + 1, m - 2) == 0) {
+      return i + k;
+    }
+    mask &= mask - 1;
+  }
+
+  return -1;
+}
+
+__attribute__((target("sse2"))) inline unsigned sse2_find_mask(const char *haystack, __m128i first, __m128i last,
+                                                                size_t m) {
+  __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack));
+  __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + m - 1));
+  return static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+}
+
+__attribute__((target("sse2"))) intptr_t sse2_find_loop(const char *haystack, size_t n, const char *needle,
+                                                         size_t m) {
+  if (n < m - 1 + 16) {
+    return find_tail(haystack, n, needle, m);
+  }
+
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[m - 1]);
+
+  size_t i = 0;
+  for (; i + m - 1 + 16 <= n; i += 16) {
+    intptr_t j = find_in_mask(haystack, needle, m, i, sse2_find_mask(haystack + i, first, last, m));
+    if (j >= 0) {
+      return j;
+    }
+  }
+
+  size_t end = n - (m - 1) - 16;
+  if (i + m <= n) {
+    return find_in_mask(haystack, needle, m, end, sse2_find_mask(haystack + end, first, last, m) & (~0u << (i - end)));
+  }
+
+  return -1;
+}
+
+__attribute__((target("avx2"))) inline unsigned avx2_find_mask(const char *haystack, __m256i first, __m256i last,
+                                                                size_t m) {
+  __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack));
+  __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + m - 1));
+  return static_cast<unsigned>(_mm256_movemask_epi8(
+      _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))));
+}
+
+__attribute__((target("avx2"))) intptr_t avx2_find_loop(const char *haystack, size_t n, const char *needle,
+                                                         size_t m) {
+  // A shorter haystack still fits an SSE2 vector
+  if (n < m - 1 + 32) {
+    return sse2_find_loop(haystack, n, needle, m);
+  }
+
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+
+  size_t i = 0;
+  for (; i + m - 1 + 32 <= n; i += 32) {
+    intptr_t j = find_in_mask(haystack, needle, m, i, avx2_find_mask(haystack + i, first, last, m));
+    if (j >= 0) {
+      return j;
+    }
+  }
+
+  size_t end = n - (m - 1) - 32;
+  if (i + m <= n) {
+    return find_in_mask(haystack, needle, m, end, avx2_find_mask(haystack + end, first, last, m) & (~0u << (i - end)));
+  }
+
+  return -1;
+}
+
+// The JSON classification compares every byte against the characters the parser
+// looks for. The brackets and braces differ only in bit 5, so setting it finds
+// both ``[`` and ``{`` with one comparison, and both ``]`` and ``}`` with another.
+// The whitespace other than spaces is the range 9 to 13.
+
+__attribute__((target("sse2"))) inline void sse2_json_classify(const char *data, uint64_t *masks, int shift) {
+  __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+  __m128i structural = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+      _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(':')), _mm_cmpeq_epi8(c, _mm_set1_epi8(','))));
+  __m128i control = _mm_sub_epi8(c, _mm_set1_epi8(9));
+  __m128i whitespace = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control));
+  __m128i quote = _mm_cmpeq_epi8(c, _mm_set1_epi8('"'));
+  __m128i backslash = _mm_cmpeq_epi8(c, _mm_set1_epi8('\\'));
+  masks[0] |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(quote))) << shift;
+  masks[1] |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(backslash))) << shift;
+  masks[2] |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(structural))) << shift;
+  masks[3] |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(whitespace))) << shift;
+}
+
+__attribute__((target("sse2"))) void sse2_json_classify_loop(const char *data, uint64_t *masks) {
+  masks[0] = masks[1] = masks[2] = masks[3] = 0;
+  for (int i = 0; i < 64; i += 16) {
+    sse2_json_classify(data + i, masks, i);
+  }
+}
+
+__attribute__((target("avx2"))) inline void avx2_json_classify(const char *data, uint64_t *masks, int shift) {
+  __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  __m256i structural = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(c, _mm256_set1_epi8(','))));
+  __m256i control = _mm256_sub_epi8(c, _mm256_set1_epi8(9));
+  __m256i whitespace = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')),
+                                       _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control));
+  __m256i quote = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('"'));
+  __m256i backslash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('\\'));
+  masks[0] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(quote))) << shift;
+  masks[1] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(backslash))) << shift;
+  masks[2] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(structural))) << shift;
+  masks[3] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(whitespace))) << shift;
+}
+
+__attribute__((target("avx2"))) void avx2_json_classify_loop(const char *data, uint64_t *masks) {
+  masks[0] = masks[1] = masks[2] = masks[3] = 0;
+  avx2_json_classify(data, masks, 0);
+  avx2_json_classify(data + 32, masks, 32);
+}
+
+#endif // DYND_SIMD_X86
+
+atomic<int> &current_instruction_set() {
+  static atomic<int> isa(simd::detect_instruction_set());
+  return isa;
+}
+
+} // anonymous namespace
+
+simd::instruction_set simd::detect_instruction_set() {
+#ifdef DYND_SIMD_X86
+  // These also check that the operating system saves the wider registers
+  if (__builtin_cpu_supports("avx512f")) {
+    return isa_avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return isa_avx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return isa_sse2;
+  }
+#endif
+
+  return isa_none;
+}
+
+simd::instruction_set simd::get_instruction_set() {
+  return static_cast<instruction_set>(current_instruction_set().load());
+}
+
+void simd::set_instruction_set(instruction_set isa) {
+  current_instruction_set() = min(isa, detect_instruction_set());
+}
+
+simd::binary_loop_t simd::get_binary_loop(binary_op DYND_IGNORE_UNUSED(op), type_id_t DYND_IGNORE_UNUSED(id)) {
+#ifdef DYND_SIMD_X86
+  instruction_set isa = get_instruction_set();
+  switch (id) {
+  case int32_id:
+    return get_integer_binary_loop<int32_t>(op, isa);
+  case int64_id:
+    return get_integer_binary_loop<int64_t>(op, isa);
+  case uint32_id:
+    return get_integer_binary_loop<uint32_t>(op, isa);
+  case uint64_id:
+    return get_integer_binary_loop<uint64_t>(op, isa);
+  case float32_id:
+    return get_real_binary_loop<float>(op, isa);
+  case float64_id:
+    return get_real_binary_loop<double>(op, isa);
+  case complex_float32_id:
+    return get_complex_binary_loop<float>(op, isa);
+  case complex_float64_id:
+    return get_complex_binary_loop<double>(op, isa);
+  default:
+    return NULL;
+  }
+#else
+  return NULL;
+#endif
+}
+
+simd::find_loop_t simd::get_find_loop() {
+#ifdef DYND_SIMD_X86
+  switch (get_instruction_set()) {
+  case isa_sse2:
+    return &sse2_find_loop;
+  case isa_avx2:
+  case isa_avx512:
+    return &avx2_find_loop;
+  default:
+    return NULL;
+  }
+#else
+  return NULL;
+#endif
+}
+
+simd::json_classify_loop_t simd::get_json_classify_loop() {
+#ifdef DYND_SIMD_X86
+  switch (get_instruction_set()) {
+  case isa_sse2:
+    return &sse2_json_classify_loop;
+  case isa_avx2:
+  case isa_avx512:
+    return &avx2_json_classify_loop;
+  default:
+    return NULL;
+  }
+#else
+  return NULL;
+#endif
+}
@@ -3,6 +3,7 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <dynd/callables/argsort_callable.hpp>
 #include <dynd/callables/sort_callable.hpp>
 #include <dynd/callables/unique_callable.hpp>
 #include <dynd/sort.hpp>
@@ -12,4 +13,10 @@ using namespace dynd;
 
 DYND_API nd::callable nd::sort = nd::make_callable<nd::sort_callable>();
 
-DYND_API nd::callable nd::unique = nd::make_callable<nd::unique_callable>();
+DYND_API nd::callable nd::argsort = nd::make_callable<nd::argsort_callable>();
+
+DYND_API nd::callable nd::unique = nd::make_callable<nd::unique_callable>(nd::unique_values);
+
+DYND_API nd::callable nd::value_counts = nd::make_callable<nd::unique_callable>(nd::unique_value_counts);
+
+DYND_API nd::callable nd::factorize = nd::make_callable<nd::unique_callable>(nd::unique_factorize);
@@ -0,0 +1,119 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <new>
+
+#include <dynd/storage_arena.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+size_t aligned_size(size_t size) { return (size + static_cast<size_t>(15)) & ~static_cast<size_t>(15); }
+
+} // anonymous namespace
+
+const size_t storage_arena::chunk_size;
+
+storage_arena::storage_arena() : m_top(0), m_nblocks(0), m_used(0), m_peak(0) {}
+
+storage_arena::~storage_arena() {
+  for (const chunk &c : m_chunks) {
+    free(c.data);
+  }
+}
+
+void *storage_arena::allocate(size_t size) {
+  size = aligned_size(size);
+  if (m_chunks.empty() || m_chunks.back().capacity - m_top < size) {
+    size_t capacity = m_chunks.empty() ? chunk_size : 2 * m_chunks.back().capacity;
+    while (capacity < size) {
+      capacity *= 2;
+    }
+
+    char *data = reinterpret_cast<char *>(malloc(capacity));
+    if (data == NULL) {
+      throw bad_alloc();
+    }
+    m_chunks.push_back({data, capacity});
+    m_top = 0;
+  }
+
+  void *ptr = m_chunks.back().data + m_top;
+  m_top += size;
+  ++m_nblocks;
+  m_used += size;
+  if (m_used > m_peak) {
+    m_peak = m_used;
+  }
+
+  return ptr;
+}
+
+bool storage_arena::grow(void *ptr, size_t old_size, size_t new_size) {
+  old_size = aligned_size(old_size);
+  new_size = aligned_size(new_size);
+  if (m_chunks.empty() || reinterpret_cast<char *>(ptr) < m_chunks.back().data ||
+      reinterpret_cast<char *>(ptr) + old_size != m_chunks.back().data + m_top ||
+      m_chunks.back().capacity - m_top < new_size - old_size) {
+    return false;
+  }
+
+  m_top += new_size - old_size;
+  m_used += new_size - old_size;
+  if (m_used > m_peak) {
+    m_peak = m_used;
+  }
+
+  return true;
+}
+
+void storage_arena::deallocate(void *ptr, size_t size) {
+  size = aligned_size(size);
+  // A block on top is popped, any other one is only reclaimed when the arena rewinds
+  char *top = m_chunks.back().data + m_top;
+  if (reinterpret_cast<char *>(ptr) >= m_chunks.back().data && reinterpret_cast<char *>(ptr) + size == top) {
+    m_top -= size;
+  }
+  m_used -= size;
+
+  if (--m_nblocks == 0) {
+    rewind();
+  }
+}
+
+void storage_arena::rewind() {
+  // The memory of a call which needed several chunks is merged, so the next one fits in the first
+  if (m_chunks.size() > 1) {
+    size_t capacity = 0;
+    for (const chunk &c : m_chunks) {
+      capacity += c.capacity;
+      free(c.data);
+    }
+    m_chunks.clear();
+
+    char *data = reinterpret_cast<char *>(malloc(capacity));
+    if (data != NULL) {
+      m_chunks.push_back({data, capacity});
+    }
+  }
+
+  m_top = 0;
+}
+
+size_t storage_arena::capacity() const {
+  size_t capacity = 0;
+  for (const chunk &c : m_chunks) {
+    capacity += c.capacity;
+  }
+  return capacity;
+}
+
+storage_arena &storage_arena::get() {
+  static thread_local storage_arena arena;
+  return arena;
+}
@@ -3,8 +3,13 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
 #include <sstream>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <dynd/string_encodings.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/char_type.hpp>
@@ -238,7 +243,7 @@ uint32_t noerror_next_utf16(const char *&it_raw, const char *end_raw) {
   it_raw += 2;
   // Take care of surrogate pairs first
   if (utf8::internal::is_lead_surrogate(cp)) {
-    if (it_raw <= end_raw + 2) {
+    if (it_raw + 2 <= end_raw) {
       uint32_t trail_surrogate = *reinterpret_cast<const uint16_t *>(it_raw);
       it_raw += 2;
       if (utf8::internal::is_trail_surrogate(trail_surrogate)) {
@@ -323,6 +328,273 @@ void noerror_append_utf32(uint32_t cp, char *&it_raw, char *DYND_UNUSED(end_raw)
   *it = cp;
   ++it;
 }
+
+// The codecs convert a single code point inline, for the bulk transcoders. Where
+// the next_* or append_* function of the encoding would raise an error, substitute
+// a code point or truncate, they return false without advancing, so that function
+// can be called instead.
+
+struct ascii_codec {
+  static const size_t unit_size = 1;
+
+  static bool decode(const char *&it, const char *DYND_UNUSED(end), uint32_t &cp) {
+    cp = *reinterpret_cast<const uint8_t *>(it);
+    if (cp & 0x80) {
+      return false;
+    }
+    ++it;
+    return true;
+  }
+
+  static bool encode(uint32_t cp, char *&it, char *end) {
+    if ((cp & ~0x7f) != 0 || it == end) {
+      return false;
+    }
+    *it++ = static_cast<char>(cp);
+    return true;
+  }
+};
+
+struct ucs2_codec {
+  static const size_t unit_size = 2;
+
+  static bool decode(const char *&it, const char *DYND_UNUSED(end), uint32_t &cp) {
+    cp = *reinterpret_cast<const uint16_t *>(it);
+    if (utf8::internal::is_surrogate(cp)) {
+      return false;
+    }
+    it += 2;
+    return true;
+  }
+
+  static bool encode(uint32_t cp, char *&it, char *end) {
+    if ((cp & ~0xffff) != 0 || end - it < 2) {
+      return false;
+    }
+    *reinterpret_cast<uint16_t *>(it) = static_cast<uint16_t>(cp);
+    it += 2;
+    return true;
+  }
+};
+
+struct utf8_codec {
+  static const size_t unit_size = 1;
+
+  static bool decode(const char *&it, const char *end, uint32_t &cp) {
+    return utf8::internal::validate_next(it, end, cp) == utf8::internal::UTF8_OK;
+  }
+
+  static bool encode(uint32_t cp, char *&it, char *end) {
+    if (cp < 0x80) {
+      if (it == end) {
+        return false;
+      }
+      *it++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      if (end - it < 2) {
+        return false;
+      }
+      *it++ = static_cast<char>((cp >> 6) | 0xc0);
+      *it++ = static_cast<char>((cp & 0x3f) | 0x80);
+    } else if (cp < 0x10000) {
+      if (end - it < 3) {
+        return false;
+      }
+      *it++ = static_cast<char>((cp >> 12) | 0xe0);
+      *it++ = static_cast<char>(((cp >> 6) & 0x3f) | 0x80);
+      *it++ = static_cast<char>((cp & 0x3f) | 0x80);
+    } else {
+      if (end - it < 4) {
+        return false;
+      }
+      *it++ = static_cast<char>((cp >> 18) | 0xf0);
+      *it++ = static_cast<char>(((cp >> 12) & 0x3f) | 0x80);
+      *it++ = static_cast<char>(((cp >> 6) & 0x3f) | 0x80);
+      *it++ = static_cast<char>((cp & 0x3f) | 0x80);
+    }
+    return true;
+  }
+};
+
+struct utf16_codec {
+  static const size_t unit_size = 2;
+
+  static bool decode(const char *&it, const char *end, uint32_t &cp) {
+    cp = *reinterpret_cast<const uint16_t *>(it);
+    if (utf8::internal::is_lead_surrogate(cp)) {
+      if (end - it < 4) {
+        return false;
+      }
+      uint32_t trail_surrogate = *reinterpret_cast<const uint16_t *>(it + 2);
+      if (!utf8::internal::is_trail_surrogate(trail_surrogate)) {
+        return false;
+      }
+      cp = (cp << 10) + trail_surrogate + utf8::internal::SURROGATE_OFFSET;
+      it += 4;
+      return true;
+    } else if (utf8::internal::is_trail_surrogate(cp)) {
+      return false;
+    }
+    it += 2;
+    return true;
+  }
+
+  static bool encode(uint32_t cp, char *&it, char *end) {
+    if (cp > 0xffff) {
+      if (end - it < 4) {
+        return false;
+      }
+      reinterpret_cast<uint16_t *>(it)[0] = static_cast<uint16_t>((cp >> 10) + utf8::internal::LEAD_OFFSET);
+      reinterpret_cast<uint16_t *>(it)[1] = static_cast<uint16_t>((cp & 0x3ff) + utf8::internal::TRAIL_SURROGATE_MIN);
+      it += 4;
+    } else {
+      if (end - it < 2) {
+        return false;
+      }
+      *reinterpret_cast<uint16_t *>(it) = static_cast<uint16_t>(cp);
+      it += 2;
+    }
+    return true;
+  }
+};
+
+struct utf32_codec {
+  static const size_t unit_size = 4;
+
+  static bool decode(const char *&it, const char *DYND_UNUSED(end), uint32_t &cp) {
+    cp = *reinterpret_cast<const uint32_t *>(it);
+    if (!utf8::internal::is_code_point_valid(cp)) {
+      return false;
+    }
+    it += 4;
+    return true;
+  }
+
+  static bool encode(uint32_t cp, char *&it, char *end) {
+    if (end - it < 4) {
+      return false;
+    }
+    *reinterpret_cast<uint32_t *>(it) = cp;
+    it += 4;
+    return true;
+  }
+};
+
+// Every encoding stores ASCII as one code unit with the same value, so a block
+// of ASCII code units is converted by narrowing or widening them, 16 at a time.
+// A block with a NUL is left to the per code point loop, which stops there.
+
+const size_t ascii_block_size = 16;
+
+#ifdef __SSE2__
+
+template <size_t UnitSize>
+struct ascii_block;
+
+template <>
+struct ascii_block<1> {
+  static bool load(const char *src, __m128i &bytes) {
+    bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    return _mm_movemask_epi8(bytes) == 0 && _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())) == 0;
+  }
+
+  static void store(char *dst, __m128i bytes) { _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), bytes); }
+};
+
+template <>
+struct ascii_block<2> {
+  static bool load(const char *src, __m128i &bytes) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+    __m128i high_bits = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(static_cast<short>(0xff80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, _mm_setzero_si128())) != 0xffff) {
+      return false;
+    }
+    bytes = _mm_packus_epi16(lo, hi);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())) == 0;
+  }
+
+  static void store(char *dst, __m128i bytes) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(bytes, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi8(bytes, _mm_setzero_si128()));
+  }
+};
+
+template <>
+struct ascii_block<4> {
+  static bool load(const char *src, __m128i &bytes) {
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+    __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+    __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48));
+    __m128i high_bits = _mm_and_si128(_mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3)),
+                                      _mm_set1_epi32(static_cast<int>(0xffffff80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high_bits, _mm_setzero_si128())) != 0xffff) {
+      return false;
+    }
+    bytes = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())) == 0;
+  }
+
+  static void store(char *dst, __m128i bytes) {
+    __m128i lo = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+    __m128i hi = _mm_unpackhi_epi8(bytes, _mm_setzero_si128());
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(lo, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi16(lo, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), _mm_unpacklo_epi16(hi, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 48), _mm_unpackhi_epi16(hi, _mm_setzero_si128()));
+  }
+};
+
+#endif // __SSE2__
+
+template <class SrcCodec, class DstCodec>
+void transcode(const char *&src, const char *src_end, char *&dst, char *dst_end) {
+  const intptr_t src_block_size = ascii_block_size * SrcCodec::unit_size;
+  const intptr_t dst_block_size = ascii_block_size * DstCodec::unit_size;
+
+  while (src < src_end) {
+#ifdef __SSE2__
+    __m128i bytes;
+    while (src_end - src >= src_block_size && dst_end - dst >= dst_block_size &&
+           ascii_block<SrcCodec::unit_size>::load(src, bytes)) {
+      ascii_block<DstCodec::unit_size>::store(dst, bytes);
+      src += src_block_size;
+      dst += dst_block_size;
+    }
+#endif
+
+    // The block which is not all ASCII is converted one code point at a time
+    const char *src_block_end = std::min(src + src_block_size, src_end);
+    while (src < src_block_end) {
+      const char *src_saved = src;
+      uint32_t cp;
+      if (!SrcCodec::decode(src, src_end, cp) || cp == 0 || !DstCodec::encode(cp, dst, dst_end)) {
+        src = src_saved;
+        return;
+      }
+    }
+  }
+}
+
+template <class SrcCodec>
+transcode_unicode_t get_transcode_function(string_encoding_t dst_encoding) {
+  switch (dst_encoding) {
+  case string_encoding_ascii:
+    return &transcode<SrcCodec, ascii_codec>;
+  case string_encoding_ucs_2:
+    return &transcode<SrcCodec, ucs2_codec>;
+  case string_encoding_utf_8:
+    return &transcode<SrcCodec, utf8_codec>;
+  case string_encoding_utf_16:
+    return &transcode<SrcCodec, utf16_codec>;
+  case string_encoding_utf_32:
+    return &transcode<SrcCodec, utf32_codec>;
+  default:
+    throw runtime_error("get_transcode_unicode_function: Unrecognized string encoding");
+  }
+}
+
 } // anonymous namespace
 
 next_unicode_codepoint_t dynd::get_next_unicode_codepoint_function(string_encoding_t encoding,
@@ -361,6 +633,24 @@ append_unicode_codepoint_t dynd::get_append_unicode_codepoint_function(string_en
   }
 }
 
+transcode_unicode_t dynd::get_transcode_unicode_function(string_encoding_t src_encoding,
+                                                         string_encoding_t dst_encoding) {
+  switch (src_encoding) {
+  case string_encoding_ascii:
+    return get_transcode_function<ascii_codec>(dst_encoding);
+  case string_encoding_ucs_2:
+    return get_transcode_function<ucs2_codec>(dst_encoding);
+  case string_encoding_utf_8:
+    return get_transcode_function<utf8_codec>(dst_encoding);
+  case string_encoding_utf_16:
+    return get_transcode_function<utf16_codec>(dst_encoding);
+  case string_encoding_utf_32:
+    return get_transcode_function<utf32_codec>(dst_encoding);
+  default:
+    throw runtime_error("get_transcode_unicode_function: Unrecognized string encoding");
+  }
+}
+
 template <next_unicode_codepoint_t next_fn>
 std::string string_range_as_utf8_string_templ(const char *begin, const char *end) {
   std::string result;
@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/thread_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+thread_local bool in_region = false;
+
+} // anonymous namespace
+
+thread_pool::thread_pool()
+    : m_stop(false), m_generation(0), m_func(nullptr), m_ntasks(0), m_next(0), m_slots(0), m_pending(0) {}
+
+thread_pool::~thread_pool() {
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_cv.notify_all();
+
+  for (thread &t : m_threads) {
+    t.join();
+  }
+}
+
+size_t thread_pool::size() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_threads.size();
+}
+
+void thread_pool::run_tasks() {
+  for (size_t i = m_next.fetch_add(1); i < m_ntasks; i = m_next.fetch_add(1)) {
+    try {
+      (*m_func)(i);
+    }
+    catch (...) {
+      lock_guard<mutex> lock(m_mutex);
+      if (!m_error) {
+        m_error = current_exception();
+      }
+    }
+  }
+}
+
+void thread_pool::work(size_t generation) {
+  in_region = true;
+
+  unique_lock<mutex> lock(m_mutex);
+  for (;;) {
+    m_work_cv.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+    if (m_stop) {
+      return;
+    }
+
+    generation = m_generation;
+    if (m_slots == 0) {
+      // Enough workers have already joined this region, or it has finished
+      continue;
+    }
+
+    --m_slots;
+    ++m_pending;
+    lock.unlock();
+    run_tasks();
+    lock.lock();
+    if (--m_pending == 0) {
+      m_done_cv.notify_all();
+    }
+  }
+}
+
+void thread_pool::parallel_for(size_t ntasks, const function<void(size_t)> &func) {
+  if (ntasks <= 1 || in_parallel_region()) {
+    for (size_t i = 0; i < ntasks; ++i) {
+      func(i);
+    }
+    return;
+  }
+
+  lock_guard<mutex> region_lock(m_region_mutex);
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    while (m_threads.size() < ntasks - 1) {
+      m_threads.emplace_back(&thread_pool::work, this, m_generation);
+    }
+
+    m_func = &func;
+    m_ntasks = ntasks;
+    m_next = 0;
+    m_slots = ntasks - 1;
+    m_error = nullptr;
+    ++m_generation;
+  }
+  m_work_cv.notify_all();
+
+  // The calling thread takes part in the region like any worker
+  in_region = true;
+  run_tasks();
+  in_region = false;
+
+  exception_ptr error;
+  {
+    unique_lock<mutex> lock(m_mutex);
+    // Close the region to workers which have not joined it yet
+    m_slots = 0;
+    m_done_cv.wait(lock, [this] { return m_pending == 0; });
+    m_func = nullptr;
+    swap(error, m_error);
+  }
+
+  if (error) {
+    rethrow_exception(error);
+  }
+}
+
+thread_pool &thread_pool::get() {
+  static thread_pool pool;
+  return pool;
+}
+
+bool thread_pool::in_parallel_region() { return in_region; }
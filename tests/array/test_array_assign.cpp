@@ -596,6 +596,48 @@ TEST(ArrayAssign, ArrayValsAtType) {
   }
 }
 
+TEST(ArrayAssign, Transposed) {
+  // Sizes which are not a multiple of the tile size, with a conversion
+  nd::array a = nd::empty(ndt::make_type<int32_t[70][45]>());
+  for (int i = 0; i < 70; ++i) {
+    for (int j = 0; j < 45; ++j) {
+      a(i, j).assign(100 * i + j);
+    }
+  }
+
+  nd::array b = nd::empty(ndt::make_type<double[45][70]>());
+  b.assign(a.transpose());
+  for (int i = 0; i < 70; ++i) {
+    for (int j = 0; j < 45; ++j) {
+      EXPECT_EQ(100 * i + j, b(j, i).as<double>());
+    }
+  }
+
+  // A permutation of three dimensions, both ways
+  nd::array c = nd::empty(ndt::make_type<int16_t[3][40][50]>());
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      for (int k = 0; k < 50; ++k) {
+        c(i, j, k).assign(1000 * i + 20 * j + k);
+      }
+    }
+  }
+
+  intptr_t axes[3] = {2, 0, 1};
+  nd::array d = nd::empty(ndt::make_type<int16_t[50][3][40]>());
+  d.assign(c.permute(3, axes));
+  nd::array e = nd::empty(ndt::make_type<int16_t[3][40][50]>());
+  e(irange(), irange(), irange()).permute(3, axes).assign(d);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      for (int k = 0; k < 50; ++k) {
+        EXPECT_EQ(1000 * i + 20 * j + k, d(k, i, j).as<int16_t>());
+        EXPECT_EQ(1000 * i + 20 * j + k, e(i, j, k).as<int16_t>());
+      }
+    }
+  }
+}
+
 #if !(defined(_WIN32) && !defined(_M_X64)) // TODO: How to mark as expected failures in googletest?
 REGISTER_TYPED_TEST_SUITE_P(ArrayAssign, ScalarAssignment_Bool, ScalarAssignment_Int8, ScalarAssignment_UInt16,
                             ScalarAssignment_Float32, ScalarAssignment_Float64, ScalarAssignment_Uint64,
@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <dynd/csv_parser.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(CSVParser, Rows) {
+  nd::array a = nd::csv::read(ndt::type("{id: int32, name: string, price: float64}"),
+                              "id,name,price\n1,apple,0.5\n2,banana,1.25\r\n\n3,cherry,3\n");
+  EXPECT_EQ(ndt::type("3 * {id: int32, name: string, price: float64}"), a.get_type());
+  EXPECT_EQ(1, a(0, 0).as<int32_t>());
+  EXPECT_EQ("apple", a(0, 1).as<std::string>());
+  EXPECT_EQ(0.5, a(0, 2).as<double>());
+  EXPECT_EQ("banana", a(1, 1).as<std::string>());
+  EXPECT_EQ(1.25, a(1, 2).as<double>());
+  EXPECT_EQ(3, a(2, 0).as<int32_t>());
+  EXPECT_EQ(3.0, a(2, 2).as<double>());
+
+  // The type may also be given with a dimension, and the last row need not end with a newline
+  a = nd::csv::read(ndt::type("var * {x: int64, y: int64}"), "x,y\n1,2\n3,4");
+  EXPECT_EQ(ndt::type("2 * {x: int64, y: int64}"), a.get_type());
+  EXPECT_EQ(4, a(1, 1).as<int64_t>());
+}
+
+TEST(CSVParser, Columns) {
+  nd::array a = nd::csv::read(ndt::type("{id: Fixed * int32, name: Fixed * string}"), "id,name\n1,a\n2,b\n3,c\n");
+  EXPECT_EQ(ndt::type("{id: 3 * int32, name: 3 * string}"), a.get_type());
+  EXPECT_EQ(2, a(0, 1).as<int32_t>());
+  EXPECT_EQ("c", a(1, 2).as<std::string>());
+}
+
+TEST(CSVParser, Quotes) {
+  nd::csv::read_options options;
+  options.header = false;
+  nd::array a = nd::csv::read(ndt::type("{a: string, b: int32}"),
+                              "\"one, two\",1\n\"say \"\"hi\"\"\",2\n\"two\nlines\",3\n\"\",4\n", options);
+  EXPECT_EQ(4, a.get_dim_size());
+  EXPECT_EQ("one, two", a(0, 0).as<std::string>());
+  EXPECT_EQ("say \"hi\"", a(1, 0).as<std::string>());
+  EXPECT_EQ("two\nlines", a(2, 0).as<std::string>());
+  EXPECT_EQ(3, a(2, 1).as<int32_t>());
+  EXPECT_EQ("", a(3, 0).as<std::string>());
+
+  options.delimiter = '\t';
+  options.quote = '\'';
+  a = nd::csv::read(ndt::type("{a: string, b: string}"), "'x\ty'\tz\n", options);
+  EXPECT_EQ("x\ty", a(0, 0).as<std::string>());
+  EXPECT_EQ("z", a(0, 1).as<std::string>());
+}
+
+TEST(CSVParser, Missing) {
+  nd::array a = nd::csv::read(ndt::type("{a: ?int32, b: ?float64, c: string}"), "a,b,c\n1,,x\nNA,2.5,\n");
+  EXPECT_EQ(1, a(0, 0).as<int32_t>());
+  EXPECT_TRUE(a(0, 1).is_na());
+  EXPECT_TRUE(a(1, 0).is_na());
+  EXPECT_EQ(2.5, a(1, 1).as<double>());
+  EXPECT_EQ("", a(1, 2).as<std::string>());
+}
+
+TEST(CSVParser, Errors) {
+  ndt::type tp("{a: int32, b: int32}");
+  EXPECT_THROW(nd::csv::read(tp, "a,b\n1,2\n3\n"), invalid_argument);
+  EXPECT_THROW(nd::csv::read(tp, "a,b\n1,2,3\n"), invalid_argument);
+  EXPECT_THROW(nd::csv::read(tp, "a,b\n1,x\n"), invalid_argument);
+  EXPECT_THROW(nd::csv::read(tp, "a,b\n\"1,2\n"), invalid_argument);
+  EXPECT_THROW(nd::csv::read(ndt::type("int32"), "1\n"), type_error);
+
+  try {
+    nd::csv::read(tp, "a,b\n1,2\n3,40000000000\n");
+    FAIL() << "expected an error";
+  } catch (const invalid_argument &e) {
+    std::string message = e.what();
+    EXPECT_NE(std::string::npos, message.find("line 3, column 3"));
+    EXPECT_NE(std::string::npos, message.find("field \"b\""));
+  }
+}
+
+TEST(CSVParser, Discover) {
+  const char *text = "flag,count,ratio,label,maybe\n"
+                     "true,1,0.5,x,1\n"
+                     "False,2,1,y,\n"
+                     "true,-3,1e3,4,NA\n";
+  EXPECT_EQ(ndt::type("{flag: bool, count: int64, ratio: float64, label: string, maybe: ?int64}"),
+            ndt::csv::discover(text, text + strlen(text)));
+
+  nd::array a = nd::csv::read(text);
+  EXPECT_EQ(3, a.get_dim_size());
+  EXPECT_FALSE(a(1, 0).as<bool>());
+  EXPECT_EQ(-3, a(2, 1).as<int64_t>());
+  EXPECT_EQ(1000.0, a(2, 2).as<double>());
+  EXPECT_EQ("4", a(2, 3).as<std::string>());
+  EXPECT_TRUE(a(1, 4).is_na());
+
+  // Without a header, the fields are numbered
+  nd::csv::read_options options;
+  options.header = false;
+  text = "1,a\n2,b\n";
+  EXPECT_EQ(ndt::type("{f0: int64, f1: string}"), ndt::csv::discover(text, text + strlen(text), options));
+}
+
+TEST(CSVParser, Buffer) {
+  nd::array buffer = nd::array("x,y\n1,2\n3,4\n");
+  nd::array a = nd::csv::read(ndt::type("{x: int32, y: int32}"), buffer);
+  EXPECT_EQ(2, a.get_dim_size());
+  EXPECT_EQ(3, a(1, 0).as<int32_t>());
+}
+
+TEST(CSVParser, ParallelChunks) {
+  // Enough rows to be split between threads, with quoted fields spanning
+  // lines so that some of the split points fall within quotes
+  std::stringstream ss;
+  ss << "id,text,value\n";
+  intptr_t nrows = 40000;
+  for (intptr_t i = 0; i < nrows; ++i) {
+    ss << i << ",";
+    if (i % 3 == 0) {
+      ss << "\"line one\nline, two\nline \"\"three\"\"\"";
+    } else {
+      ss << "plain" << i;
+    }
+    ss << "," << (i * 0.25) << "\n";
+  }
+  std::string text = ss.str();
+
+  eval::eval_context ectx;
+  ectx.nthreads = 8;
+  nd::array a = nd::csv::read(ndt::type("{id: int64, text: string, value: float64}"), text, nd::csv::read_options(),
+                              &ectx);
+  ASSERT_EQ(nrows, a.get_dim_size());
+  for (intptr_t i = 0; i < nrows; ++i) {
+    ASSERT_EQ(i, a(i, 0).as<int64_t>());
+    if (i % 3 == 0) {
+      ASSERT_EQ("line one\nline, two\nline \"three\"", a(i, 1).as<std::string>());
+    } else {
+      ASSERT_EQ("plain" + std::to_string(i), a(i, 1).as<std::string>());
+    }
+    ASSERT_EQ(i * 0.25, a(i, 2).as<double>());
+  }
+
+  nd::array columns = nd::csv::read(ndt::type("{id: Fixed * int64, text: Fixed * string, value: Fixed * float64}"),
+                                    text, nd::csv::read_options(), &ectx);
+  EXPECT_EQ(nrows, columns(0).get_dim_size());
+  EXPECT_EQ(nrows - 1, columns(0, nrows - 1).as<int64_t>());
+  EXPECT_EQ("line one\nline, two\nline \"three\"", columns(1, nrows - 1).as<std::string>());
+}
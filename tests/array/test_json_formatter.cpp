@@ -5,7 +5,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 #include <dynd/gtest.hpp>
@@ -48,6 +50,76 @@ TEST(JSONFormatter, Builtins) {
   EXPECT_EQ("null", format_json(a).as<std::string>());
 }
 
+TEST(JSONFormatter, IntegerLimits) {
+  nd::array a;
+  a = numeric_limits<int8_t>::min();
+  EXPECT_EQ("-128", format_json(a).as<std::string>());
+  a = numeric_limits<int64_t>::min();
+  EXPECT_EQ("-9223372036854775808", format_json(a).as<std::string>());
+  a = numeric_limits<int64_t>::max();
+  EXPECT_EQ("9223372036854775807", format_json(a).as<std::string>());
+  a = numeric_limits<uint64_t>::max();
+  EXPECT_EQ("18446744073709551615", format_json(a).as<std::string>());
+  a = (int32_t)0;
+  EXPECT_EQ("0", format_json(a).as<std::string>());
+}
+
+TEST(JSONFormatter, ShortestFloats) {
+  nd::array a;
+  // The fewest digits which parse back to the same value
+  a = 0.1;
+  EXPECT_EQ("0.1", format_json(a).as<std::string>());
+  a = 0.1f;
+  EXPECT_EQ("0.1", format_json(a).as<std::string>());
+  a = 1.0 / 3.0;
+  EXPECT_EQ("0.3333333333333333", format_json(a).as<std::string>());
+  a = 1.0f / 3.0f;
+  EXPECT_EQ("0.33333334", format_json(a).as<std::string>());
+  a = 0.1 + 0.2;
+  EXPECT_EQ("0.30000000000000004", format_json(a).as<std::string>());
+  a = 123456789012.0;
+  EXPECT_EQ("123456789012", format_json(a).as<std::string>());
+  a = -0.0;
+  EXPECT_EQ("-0", format_json(a).as<std::string>());
+  // Very large and small magnitudes have an exponent
+  a = 1e21;
+  EXPECT_EQ("1e+21", format_json(a).as<std::string>());
+  a = 1e20;
+  EXPECT_EQ("100000000000000000000", format_json(a).as<std::string>());
+  a = 1.5e-7;
+  EXPECT_EQ("1.5e-7", format_json(a).as<std::string>());
+  a = 0.000001;
+  EXPECT_EQ("0.000001", format_json(a).as<std::string>());
+  a = numeric_limits<double>::max();
+  EXPECT_EQ("1.7976931348623157e+308", format_json(a).as<std::string>());
+  a = numeric_limits<double>::denorm_min();
+  EXPECT_EQ("5e-324", format_json(a).as<std::string>());
+  a = numeric_limits<float>::max();
+  EXPECT_EQ("3.4028235e+38", format_json(a).as<std::string>());
+  a = numeric_limits<float>::denorm_min();
+  EXPECT_EQ("1e-45", format_json(a).as<std::string>());
+}
+
+TEST(JSONFormatter, FloatRoundTrip) {
+  // Values spread over every magnitude are parsed back exactly
+  vector<double> vals;
+  uint64_t bits = 0x123456789abcdefULL;
+  for (int i = 0; i < 1000; ++i) {
+    bits = bits * 6364136223846793005ULL + 1442695040888963407ULL;
+    double value;
+    uint64_t value_bits = bits & 0x7fefffffffffffffULL;
+    memcpy(&value, &value_bits, sizeof(value));
+    vals.push_back(value);
+  }
+
+  nd::array a = nd::empty(vals.size(), ndt::make_type<double>());
+  memcpy(a.data(), vals.data(), vals.size() * sizeof(double));
+  nd::array b = parse_json(a.get_type(), format_json(a).as<std::string>().c_str());
+  for (size_t i = 0; i < vals.size(); ++i) {
+    EXPECT_EQ(vals[i], b(i).as<double>());
+  }
+}
+
 TEST(JSONFormatter, String) {
   nd::array a;
   a = "testing string";
@@ -6,12 +6,14 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 
 #include <dynd/callable.hpp>
 #include <dynd/gtest.hpp>
 #include <dynd/json_parser.hpp>
 #include <dynd/parse.hpp>
+#include <dynd/simd.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
@@ -222,6 +224,268 @@ TEST(JSON, ParserWithMissingValue) {
   EXPECT_TRUE(a.p("y").is_na());
 }
 
+TEST(JSONParser, StructuralIndex) {
+  for (int isa = simd::isa_none; isa <= simd::detect_instruction_set(); ++isa) {
+    simd::set_instruction_set(static_cast<simd::instruction_set>(isa));
+
+    // Quotes after an odd run of backslashes are escaped, after an even one they end the string
+    std::string json = "  [\"a\\\"b\",\t\"c\\\\\" ,\n\"{[:,]}\" ,  -12.5e3 , true]";
+    const char *begin = json.data(), *end = begin + json.size();
+    json::structural_index index(begin, end);
+    EXPECT_EQ(begin + 2, index.skip_whitespace(begin));
+    EXPECT_EQ(begin + 8, index.find_string_end(begin + 3));
+    EXPECT_EQ(begin + 11, index.skip_whitespace(begin + 10));
+    EXPECT_EQ(begin + 15, index.find_string_end(begin + 11));
+    EXPECT_EQ(begin + 17, index.skip_whitespace(begin + 16));
+    EXPECT_EQ(begin + 19, index.skip_whitespace(begin + 18));
+    EXPECT_EQ(begin + 26, index.find_string_end(begin + 19));
+    EXPECT_EQ(begin + 28, index.skip_whitespace(begin + 27));
+    EXPECT_EQ(begin + 31, index.skip_whitespace(begin + 29));
+    EXPECT_EQ(begin + 39, index.skip_whitespace(begin + 38));
+    EXPECT_EQ(begin + 41, index.skip_whitespace(begin + 40));
+    EXPECT_EQ(end, index.skip_whitespace(end));
+
+    // A string without a closing quote has no end
+    json = "[\"abc, \\\"]";
+    begin = json.data();
+    end = begin + json.size();
+    json::structural_index unterminated(begin, end);
+    EXPECT_EQ(NULL, unterminated.find_string_end(begin + 1));
+  }
+  simd::set_instruction_set(simd::detect_instruction_set());
+}
+
+TEST(JSONParser, StringsWithStructuralCharacters) {
+  for (int isa = simd::isa_none; isa <= simd::detect_instruction_set(); ++isa) {
+    simd::set_instruction_set(static_cast<simd::instruction_set>(isa));
+
+    nd::array a = parse_json(ndt::type("var * string"),
+                             "[\"a,b\", \"c\\\"d\", \"[{}]:\", \"e\\\\\", \"\", \"\\\\\\\"\", \" x \"]");
+    ASSERT_EQ(7, a.get_dim_size());
+    EXPECT_EQ("a,b", a(0).as<std::string>());
+    EXPECT_EQ("c\"d", a(1).as<std::string>());
+    EXPECT_EQ("[{}]:", a(2).as<std::string>());
+    EXPECT_EQ("e\\", a(3).as<std::string>());
+    EXPECT_EQ("", a(4).as<std::string>());
+    EXPECT_EQ("\\\"", a(5).as<std::string>());
+    EXPECT_EQ(" x ", a(6).as<std::string>());
+
+    a = parse_json(ndt::type("{\"a:b\": int32, \"}\": string}"), "{ \"}\" : \"{\" , \"a:b\" : 3 }");
+    EXPECT_EQ(3, a(0).as<int>());
+    EXPECT_EQ("{", a(1).as<std::string>());
+
+    // Literals and numbers run up to the next structural character or whitespace
+    EXPECT_THROW(parse_json(ndt::type("var * bool"), "[true, truex]"), invalid_argument);
+    EXPECT_THROW(parse_json(ndt::type("var * int32"), "[1, 2 3]"), invalid_argument);
+    EXPECT_THROW(parse_json(ndt::type("var * string"), "[\"abc\", \"de]"), invalid_argument);
+    EXPECT_THROW(parse_json(ndt::type("var * string"), "[\"a\\qb\"]"), invalid_argument);
+    std::string bad = "[\"a\", \"b\\\"]";
+    EXPECT_THROW(validate_json(bad.data(), bad.data() + bad.size()), invalid_argument);
+  }
+  simd::set_instruction_set(simd::detect_instruction_set());
+}
+
+TEST(JSONParser, LargerThanIndexWindow) {
+  // Enough records to span several windows of the structural index, with
+  // strings, escapes and whitespace falling across the boundaries
+  std::string json = "[";
+  intptr_t count = 0;
+  while (json.size() < 3 * json::structural_index::window_size) {
+    if (count > 0) {
+      json += (count % 7 == 0) ? " ,\n  " : ",";
+    }
+    std::string name = "n" + std::to_string(count) + std::string(count % 13, ' ');
+    if (count % 5 == 0) {
+      name += "\\\\\\\"";
+    }
+    json += "{\"id\": " + std::to_string(count) + std::string(count % 3, '\t') + ", \"name\": \"" + name +
+            "\", \"values\": [" + std::to_string(count % 10) + ",  " + std::to_string(-count) + "]}";
+    ++count;
+  }
+  json += "]";
+
+  for (int isa = simd::isa_none; isa <= simd::detect_instruction_set(); ++isa) {
+    simd::set_instruction_set(static_cast<simd::instruction_set>(isa));
+
+    EXPECT_NO_THROW(validate_json(json.data(), json.data() + json.size()));
+    nd::array a = parse_json(ndt::type("var * {id: int64, name: string, values: 2 * int32}"), json.c_str());
+    ASSERT_EQ(count, a.get_dim_size());
+    for (intptr_t i = 0; i < count; ++i) {
+      std::string name = "n" + std::to_string(i) + std::string(i % 13, ' ');
+      if (i % 5 == 0) {
+        name += "\\\"";
+      }
+      ASSERT_EQ(i, a(i).p("id").as<int64_t>());
+      ASSERT_EQ(name, a(i).p("name").as<std::string>());
+      ASSERT_EQ(i % 10, a(i).p("values")(0).as<int>());
+      ASSERT_EQ(-i, a(i).p("values")(1).as<int>());
+    }
+
+    // An error past the first window is still found
+    std::string bad = json.substr(0, json.size() - 1) + ", {\"id\": truex}]";
+    EXPECT_THROW(parse_json(ndt::type("var * {id: int64, name: string, values: 2 * int32}"), bad.c_str()),
+                 invalid_argument);
+  }
+  simd::set_instruction_set(simd::detect_instruction_set());
+}
+
+TEST(JSONParser, ParseLines) {
+  nd::array a = nd::json::parse_lines(ndt::type("{a: int32, b: string}"),
+                                      "{\"a\": 1, \"b\": \"x\"}\n\n{\"b\": \"y\", \"a\": 2}\r\n  \n");
+  EXPECT_EQ(ndt::type("var * {a: int32, b: string}"), a.get_type());
+  ASSERT_EQ(2, a.get_dim_size());
+  EXPECT_EQ(1, a(0).p("a").as<int>());
+  EXPECT_EQ("x", a(0).p("b").as<std::string>());
+  EXPECT_EQ(2, a(1).p("a").as<int>());
+  EXPECT_EQ("y", a(1).p("b").as<std::string>());
+
+  a = nd::json::parse_lines(ndt::type("var * int32"), std::string("3\n  4  \n5"));
+  EXPECT_EQ(ndt::type("var * int32"), a.get_type());
+  ASSERT_EQ(3, a.get_dim_size());
+  EXPECT_EQ(3, a(0).as<int>());
+  EXPECT_EQ(4, a(1).as<int>());
+  EXPECT_EQ(5, a(2).as<int>());
+
+  a = nd::json::parse_lines(ndt::type("{a: int32}"), "\n  \n");
+  EXPECT_EQ(0, a.get_dim_size());
+
+  EXPECT_THROW(nd::json::parse_lines(ndt::type("{a: int32}"), "{\"a\": 1} {\"a\": 2}\n"), invalid_argument);
+  EXPECT_THROW(nd::json::parse_lines(ndt::type("{a: int32}"), "{\"a\":\n 1}\n"), invalid_argument);
+  EXPECT_THROW(nd::json::parse_lines(ndt::type("{a: int32}"), "{\"a\": 1}\n{\"a\": x}\n"), invalid_argument);
+}
+
+TEST(JSONParser, ParseLinesParallel) {
+  std::string json;
+  intptr_t count = 0;
+  while (json.size() < 1000000) {
+    json += "{\"id\": " + std::to_string(count) + ", \"name\": \"n" + std::to_string(count) +
+            ((count % 3 == 0) ? "\\n\\\"" : "") + "\", \"values\": [" + std::to_string(count % 10) + ", " +
+            std::to_string(-count) + "]}" + ((count % 11 == 0) ? "\n\n" : "\n");
+    ++count;
+  }
+
+  eval::eval_context ectx;
+  ectx.nthreads = 4;
+  ndt::type tp("{id: int64, name: ?string, values: 2 * int32}");
+  nd::array a = nd::json::parse_lines(tp, json, &ectx);
+  ASSERT_EQ(count, a.get_dim_size());
+  for (intptr_t i = 0; i < count; ++i) {
+    ASSERT_EQ(i, a(i).p("id").as<int64_t>());
+    ASSERT_EQ("n" + std::to_string(i) + ((i % 3 == 0) ? "\n\"" : ""), a(i).p("name").as<std::string>());
+    ASSERT_EQ(i % 10, a(i).p("values")(0).as<int>());
+    ASSERT_EQ(-i, a(i).p("values")(1).as<int>());
+  }
+
+  // The error reported is the one on the earliest line
+  std::string bad = json;
+  bad.replace(bad.find("\"id\": " + std::to_string(3 * count / 4)), 5, "\"id\":x");
+  bad.replace(bad.find("\"id\": " + std::to_string(count / 2)), 5, "\"id\":x");
+  try {
+    nd::json::parse_lines(tp, bad, &ectx);
+    FAIL() << "expected an error";
+  } catch (const invalid_argument &e) {
+    intptr_t line = count / 2 + 1 + (count / 2 + 10) / 11;
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("line " + std::to_string(line) + ","));
+  }
+
+  // Variable-sized dimensions within the elements are parsed on one thread
+  std::string var_json;
+  for (intptr_t i = 0; i < 100000; ++i) {
+    var_json += "{\"id\": " + std::to_string(i) + ", \"values\": [" + std::string(i % 4 == 0 ? "" : "1, 2") + "]}\n";
+  }
+  a = nd::json::parse_lines(ndt::type("{id: int64, values: var * int32}"), var_json, &ectx);
+  ASSERT_EQ(100000, a.get_dim_size());
+  EXPECT_EQ(99999, a(99999).p("id").as<int64_t>());
+  EXPECT_EQ(0, a(99996).p("values").get_dim_size());
+  EXPECT_EQ(2, a(99999).p("values").get_dim_size());
+}
+
+TEST(JSONParser, StreamParser) {
+  std::istringstream in("  [{\"a\": 1, \"b\": \"x, ]\"},\n {\"a\": 2, \"b\": \"}\\\"\"}, {\"a\": 3, \"b\": \"[\"},\n"
+                        "{\"b\": \"\", \"a\": 4}, {\"a\": 5, \"b\": \"\\\\\"}]\n");
+  nd::json::stream_parser parser(ndt::type("{a: int32, b: string}"), in, 2);
+  nd::array batch;
+  std::vector<intptr_t> sizes;
+  std::vector<int> a;
+  std::vector<std::string> b;
+  while (parser.next(batch)) {
+    EXPECT_EQ(ndt::type("var * {a: int32, b: string}"), batch.get_type());
+    sizes.push_back(batch.get_dim_size());
+    for (intptr_t i = 0; i < batch.get_dim_size(); ++i) {
+      a.push_back(batch(i).p("a").as<int>());
+      b.push_back(batch(i).p("b").as<std::string>());
+    }
+  }
+  EXPECT_EQ((std::vector<intptr_t>{2, 2, 1}), sizes);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), a);
+  EXPECT_EQ((std::vector<std::string>{"x, ]", "}\"", "[", "", "\\"}), b);
+  EXPECT_FALSE(parser.next(batch));
+
+  std::istringstream empty(" [ ] ");
+  nd::json::stream_parser empty_parser(ndt::type("int32"), empty);
+  EXPECT_FALSE(empty_parser.next(batch));
+}
+
+TEST(JSONParser, StreamParserSmallReads) {
+  // Elements, strings and escapes are split across reads of a few bytes
+  std::string json = "[";
+  for (int i = 0; i < 1000; ++i) {
+    json += (i > 0 ? ", " : "") + std::string("{\"id\": ") + std::to_string(i) + ", \"v\": [" + std::to_string(i % 7) +
+            ", " + std::to_string(-i) + "], \"s\": \"a\\\\\\\"[{,\"}";
+  }
+  json += "]";
+  nd::array expected = parse_json(ndt::type("var * {id: int64, v: 2 * int32, s: string}"), json.c_str());
+
+  for (size_t read_size : {1, 3, 64, 1000}) {
+    size_t offset = 0;
+    nd::json::stream_parser parser(ndt::type("{id: int64, v: 2 * int32, s: string}"),
+                                   [&](char *data, size_t size) {
+                                     size = std::min(std::min(size, read_size), json.size() - offset);
+                                     memcpy(data, json.data() + offset, size);
+                                     offset += size;
+                                     return size;
+                                   },
+                                   128);
+    nd::array batch;
+    intptr_t count = 0;
+    while (parser.next(batch)) {
+      for (intptr_t i = 0; i < batch.get_dim_size(); ++i, ++count) {
+        ASSERT_EQ(expected(count).p("id").as<int64_t>(), batch(i).p("id").as<int64_t>());
+        ASSERT_EQ(expected(count).p("v")(1).as<int>(), batch(i).p("v")(1).as<int>());
+        ASSERT_EQ(expected(count).p("s").as<std::string>(), batch(i).p("s").as<std::string>());
+      }
+    }
+    EXPECT_EQ(1000, count);
+  }
+}
+
+TEST(JSONParser, StreamParserErrors) {
+  nd::array batch;
+  for (const char *json : {"", " {\"a\": 1}", "[1, 2", "[1, 2] 3", "[1,, 2]", "[1, 2}", "[1 2]", "[1, x]"}) {
+    std::istringstream in(json);
+    nd::json::stream_parser parser(ndt::type("int32"), in, 1);
+    EXPECT_THROW(
+        {
+          while (parser.next(batch)) {
+          }
+        },
+        invalid_argument)
+        << json;
+  }
+
+  // The line of an error is counted from the start of the input
+  std::istringstream in("[1,\n2,\n3,\n4,\n  x]");
+  nd::json::stream_parser parser(ndt::type("int32"), in, 2);
+  EXPECT_TRUE(parser.next(batch));
+  EXPECT_TRUE(parser.next(batch));
+  try {
+    parser.next(batch);
+    FAIL() << "expected an error";
+  } catch (const invalid_argument &e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("line 5, column 3")) << e.what();
+  }
+}
+
 /*
 TEST(JSON, DiscoverBool)
 {
@@ -5,59 +5,156 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 #include <dynd/array.hpp>
+#include <dynd/csv_parser.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/memblock/memmap_memory_block.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/callable_type.hpp>
+#include <dynd/types/fixed_bytes_type.hpp>
 #include <dynd/types/string_type.hpp>
 
 using namespace std;
 using namespace dynd;
 
-/*
-
-static void write_string_file(const char *fn,
-    const char *data, intptr_t size)
-{
-    ofstream fout(fn, ios::binary);
-    fout.write(data, size);
+static void write_string_file(const char *fn, const char *data, intptr_t size) {
+  ofstream fout(fn, ios::binary);
+  fout.write(data, size);
 }
 
-//  This test fails since the string refactor. We need to redo nd::memmap.
-TEST(ArrayMemMap, SimpleString) {
-    // Create a file with a simple string
-    const char *str = "This is a test of a string.";
-    write_string_file("test.txt", str, strlen(str));
-    // Open the whole file as a memory map
-    nd::array a = nd::memmap("test.txt");
-    // Should have type 'bytes'
-    EXPECT_EQ(ndt::bytes_type::make(1), a.get_type());
-    // If we view it as a string, should still point to the same data
-    nd::array b = a.view_scalars(ndt::string_type::make());
-    EXPECT_EQ(ndt::string_type::make(), b.get_type());
-    EXPECT_EQ(std::string(str), b.as<std::string>());
-
-    // Remap a subset of the file
-    a = nd::array();
-    b = nd::array();
-    a = nd::memmap("test.txt", 5, 7);
-    EXPECT_EQ(ndt::bytes_type::make(1), a.get_type());
-    EXPECT_EQ("is", a.view_scalars(ndt::string_type::make()).as<std::string>());
-
-    // Remap the file using a negative index
-    a = nd::array();
-    a = nd::memmap("test.txt", -7);
-    EXPECT_EQ(ndt::bytes_type::make(1), a.get_type());
-    EXPECT_EQ("string.", a.view_scalars(ndt::string_type::make()).as<std::string>());
+static std::string read_string_file(const char *fn) {
+  ifstream fin(fn, ios::binary);
+  return std::string(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+}
 
+static void remove_file(const char *fn) {
 #ifdef WIN32
-    _unlink("test.txt");
+  _unlink(fn);
 #else
-    unlink("test.txt");
+  unlink(fn);
 #endif
 }
-*/
+
+static std::string memmap_contents(const nd::array &a) {
+  return std::string(a.cdata(), a.get_type().get_data_size());
+}
+
+TEST(ArrayMemMap, SimpleString) {
+  // Create a file with a simple string
+  const char *str = "This is a test of a string.";
+  write_string_file("test.txt", str, strlen(str));
+  // Open the whole file as a memory map
+  nd::array a = nd::memmap("test.txt");
+  EXPECT_EQ(ndt::make_type<ndt::fixed_bytes_type>(strlen(str), 1), a.get_type());
+  EXPECT_EQ(std::string(str), memmap_contents(a));
+  // A shared map is read-only
+  EXPECT_EQ(static_cast<uint64_t>(nd::read_access_flag), a.get_flags());
+
+  // Remap a subset of the file
+  a = nd::memmap("test.txt", 5, 7);
+  EXPECT_EQ("is", memmap_contents(a));
+
+  // Remap the file using a negative index
+  a = nd::memmap("test.txt", -7);
+  EXPECT_EQ("string.", memmap_contents(a));
+
+  // An empty range has no fixed_bytes type to view it
+  EXPECT_THROW(nd::memmap("test.txt", 3, 3), runtime_error);
+
+  a = nd::array();
+  remove_file("test.txt");
+}
+
+TEST(ArrayMemMap, Options) {
+  // Several pages, so the hints apply to more than one
+  std::string str(3 * 65536 + 123, 'x');
+  for (size_t i = 0; i < str.size(); i += 97) {
+    str[i] = static_cast<char>('a' + i % 26);
+  }
+  write_string_file("test.txt", str.data(), str.size());
+
+  nd::memmap_advice advices[] = {nd::memmap_advice_normal, nd::memmap_advice_sequential, nd::memmap_advice_random,
+                                 nd::memmap_advice_willneed};
+  for (nd::memmap_advice advice : advices) {
+    for (int populate = 0; populate < 2; ++populate) {
+      for (int huge_pages = 0; huge_pages < 2; ++huge_pages) {
+        nd::memmap_options options;
+        options.advice = advice;
+        options.populate = populate != 0;
+        options.huge_pages = huge_pages != 0;
+        nd::array a = nd::memmap("test.txt", 100, -100, nd::default_access_flags, options);
+        EXPECT_EQ(str.substr(100, str.size() - 200), memmap_contents(a));
+      }
+    }
+  }
+
+  remove_file("test.txt");
+}
+
+TEST(ArrayMemMap, CopyOnWrite) {
+  const char *str = "0123456789";
+  write_string_file("test.txt", str, strlen(str));
+
+  nd::memmap_options options;
+  options.copy_on_write = true;
+  nd::array a = nd::memmap("test.txt", 2, 8, nd::default_access_flags, options);
+  EXPECT_EQ(static_cast<uint64_t>(nd::readwrite_access_flags), a.get_flags());
+  memcpy(a.data(), "abc", 3);
+  EXPECT_EQ("abc567", memmap_contents(a));
+  // The file is unchanged
+  EXPECT_EQ(std::string(str), read_string_file("test.txt"));
+
+  // Unless write access is asked for, the private map is read-only too
+  a = nd::memmap("test.txt", 0, std::numeric_limits<intptr_t>::max(), nd::read_access_flag, options);
+  EXPECT_EQ(static_cast<uint64_t>(nd::read_access_flag), a.get_flags());
+
+  a = nd::array();
+  remove_file("test.txt");
+}
+
+TEST(ArrayMemMap, Readahead) {
+  std::string str(5 * 1000 * 1000, '\0');
+  for (size_t i = 0; i < str.size(); ++i) {
+    str[i] = static_cast<char>(i * 7 + i / 4096);
+  }
+  write_string_file("test.bin", str.data(), str.size());
+
+  nd::memmap_options options;
+  options.advice = nd::memmap_advice_sequential;
+  nd::array a = nd::memmap("test.bin", 0, std::numeric_limits<intptr_t>::max(), nd::default_access_flags, options);
+  const char *begin = a.cdata(), *end = begin + a.get_type().get_data_size();
+  {
+    // A window smaller than the file, so the helper has to follow the scan
+    nd::memmap_readahead readahead(begin, end, 1 << 20);
+    for (const char *it = begin; it < end; it += 65536) {
+      readahead.advance(it);
+      const char *chunk_end = std::min(it + 65536, end);
+      ASSERT_TRUE(std::equal(it, chunk_end, str.data() + (it - begin)));
+    }
+  }
+
+  a = nd::array();
+  remove_file("test.bin");
+}
+
+TEST(ArrayMemMap, Parse) {
+  const char *str = "{\"a\": 1}\n{\"a\": 2}\n";
+  write_string_file("test.txt", str, strlen(str));
+  nd::array a = nd::json::parse_lines(ndt::type("{a: int32}"), nd::memmap("test.txt"));
+  EXPECT_EQ(2, a.get_dim_size());
+  EXPECT_EQ(2, a(1, 0).as<int32_t>());
+
+  str = "a,b\n1,x\n2,y\n";
+  write_string_file("test.txt", str, strlen(str));
+  a = nd::csv::read(ndt::type("{a: int32, b: string}"), nd::memmap("test.txt"));
+  EXPECT_EQ(2, a.get_dim_size());
+  EXPECT_EQ("y", a(1, 1).as<std::string>());
+
+  remove_file("test.txt");
+}
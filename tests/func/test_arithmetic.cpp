@@ -16,6 +16,7 @@
 #include <dynd/json_parser.hpp>
 #include <dynd/kernels/arithmetic.hpp>
 #include <dynd/option.hpp>
+#include <dynd/simd.hpp>
 #include <dynd/types/option_type.hpp>
 
 using namespace std;
@@ -257,6 +258,65 @@ TEST(Arithmetic, Minus) {
   EXPECT_ARRAY_EQ(nd::array({-0.0, -1.0, -2.0, -3.0, -4.0}), -a);
 }
 
+template <typename T, typename FuncType>
+void check_vectorized(const nd::callable &f, FuncType func) {
+  const int n = 37;
+  nd::array a = nd::empty(ndt::make_fixed_dim(n, ndt::make_type<T>()));
+  nd::array b = nd::empty(ndt::make_fixed_dim(n, ndt::make_type<T>()));
+  for (int i = 0; i < n; ++i) {
+    a(i).assign(static_cast<T>(i + 1));
+    b(i).assign(static_cast<T>(n - i));
+  }
+
+  // Contiguous, broadcast on either side, and strided
+  nd::array res = f(a, b);
+  nd::array res_left = f(a(4), b);
+  nd::array res_right = f(a, b(7));
+  nd::array res_strided = f(a(irange().by(2)), b(irange().by(2)));
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(func(static_cast<T>(i + 1), static_cast<T>(n - i)), res(i).as<T>());
+    EXPECT_EQ(func(static_cast<T>(5), static_cast<T>(n - i)), res_left(i).as<T>());
+    EXPECT_EQ(func(static_cast<T>(i + 1), static_cast<T>(n - 7)), res_right(i).as<T>());
+  }
+  for (int i = 0; i < (n + 1) / 2; ++i) {
+    EXPECT_EQ(func(static_cast<T>(2 * i + 1), static_cast<T>(n - 2 * i)), res_strided(i).as<T>());
+  }
+}
+
+template <typename T>
+void check_vectorized_arithmetic() {
+  check_vectorized<T>(nd::add, [](T x, T y) { return x + y; });
+  check_vectorized<T>(nd::subtract, [](T x, T y) { return x - y; });
+  check_vectorized<T>(nd::multiply, [](T x, T y) { return x * y; });
+  check_vectorized<T>(nd::divide, [](T x, T y) { return x / y; });
+}
+
+TEST(Arithmetic, Vectorized) {
+  simd::instruction_set saved_isa = simd::get_instruction_set();
+  for (int isa = simd::isa_none; isa <= simd::detect_instruction_set(); ++isa) {
+    simd::set_instruction_set(static_cast<simd::instruction_set>(isa));
+    EXPECT_EQ(isa, simd::get_instruction_set());
+
+    check_vectorized_arithmetic<int32_t>();
+    check_vectorized_arithmetic<int64_t>();
+    check_vectorized_arithmetic<uint32_t>();
+    check_vectorized_arithmetic<uint64_t>();
+    check_vectorized_arithmetic<float>();
+    check_vectorized_arithmetic<double>();
+    check_vectorized_arithmetic<dynd::complex<float>>();
+    check_vectorized_arithmetic<dynd::complex<double>>();
+  }
+  simd::set_instruction_set(saved_isa);
+
+  // Mixed types use the contiguous loop without a vectorized one
+  nd::array a = {1, 2, 3, 4, 5};
+  EXPECT_ARRAY_EQ(nd::array({1.5, 2.5, 3.5, 4.5, 5.5}), a + 0.5);
+  EXPECT_ARRAY_EQ(nd::array({0.5, 1.0, 1.5, 2.0, 2.5}), a / nd::array({2.0, 2.0, 2.0, 2.0, 2.0}));
+
+  // Integer division still checks for zero
+  EXPECT_THROW(a / nd::array({1, 1, 0, 1, 1}), zero_division_error);
+}
+
 /*
 TEST(Arithmetic, CompoundDiv)
 {
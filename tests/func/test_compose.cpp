@@ -8,9 +8,11 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <dynd/arithmetic.hpp>
 #include <dynd/array.hpp>
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/callables/compose_callable.hpp>
 #include <dynd/convert.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/functional.hpp>
@@ -35,6 +37,85 @@ TEST(Compose, Simple) {
   EXPECT_DOUBLE_EQ(sin(3.1), a.as<double>());
 }
 
+TEST(Compose, Strided) {
+  // Through a string buffer, with a kernel called more than once over more than a block
+  nd::callable composed = nd::functional::compose(nd::copy, nd::copy, ndt::make_type<dynd::string>());
+
+  nd::array a = nd::empty(300, ndt::make_type<dynd::string>());
+  for (int i = 0; i < 300; ++i) {
+    a(i).assign(std::to_string(7 * i - 100));
+  }
+  nd::array b = nd::empty(ndt::make_type<double[300]>());
+
+  nd::call_graph cg;
+  ndt::type src_tp = ndt::make_type<dynd::string>();
+  composed->resolve(nullptr, nullptr, cg, ndt::make_type<double>(), 1, &src_tp, 0, nullptr,
+                    std::map<std::string, ndt::type>());
+
+  nd::kernel_builder kb(cg.get());
+  const char *src_arrmeta = a->metadata() + sizeof(fixed_dim_type_arrmeta);
+  kb(kernel_request_strided, nullptr, nullptr, 1, &src_arrmeta);
+  nd::kernel_prefix *kernel = kb.get();
+
+  char *src = a.data();
+  intptr_t src_stride = sizeof(dynd::string);
+  for (int j = 0; j < 3; ++j) {
+    kernel->strided(b.data(), sizeof(double), &src, &src_stride, 300);
+    for (int i = 0; i < 300; ++i) {
+      EXPECT_EQ(7 * i - 100, b(i).as<double>());
+    }
+  }
+
+  // The single form uses the same buffer
+  nd::array c = nd::empty(ndt::make_type<double>());
+  composed({nd::array("12")}, {{"dst", c}});
+  EXPECT_EQ(12.0, c.as<double>());
+}
+
+TEST(Fuse, Arithmetic) {
+  // a * b + c
+  nd::callable f = nd::functional::fuse(3, {{nd::multiply, {0, 1}}, {nd::add, {3, 2}}});
+
+  // Longer than a block, so the stages run over several of them
+  vector<int32_t> a(1000);
+  vector<double> b(1000), c(1000);
+  for (int i = 0; i < 1000; ++i) {
+    a[i] = i;
+    b[i] = 0.5 * i;
+    c[i] = 1000 - i;
+  }
+  nd::array x = a, y = b, z = c;
+
+  nd::array res = f(x, y, z);
+  EXPECT_EQ(ndt::type("1000 * float64"), res.get_type());
+  EXPECT_ARRAY_EQ(nd::add(nd::multiply(x, y), z), res);
+
+  // Broadcasting, and a strided argument
+  nd::array w = nd::array({{1, 2, 3}, {4, 5, 6}});
+  res = f(w, nd::array({1.5, 2.5, 3.5}), nd::array({{1, 2}, {3, 4}, {5, 6}})(irange(), 0));
+  EXPECT_ARRAY_EQ(nd::array({{2.5, 8.0, 15.5}, {7.0, 15.5, 26.0}}), res);
+
+  EXPECT_ARRAY_EQ(14.0, f(3, 4.0, 2));
+}
+
+TEST(Fuse, Reuse) {
+  // (a + b) * (a - b) + a
+  nd::callable f =
+      nd::functional::fuse(2, {{nd::add, {0, 1}}, {nd::subtract, {0, 1}}, {nd::multiply, {2, 3}}, {nd::add, {4, 0}}});
+
+  nd::array a = nd::array({1, 2, 3, 4, 5});
+  nd::array b = nd::array({5, 4, 3, 2, 1});
+  EXPECT_ARRAY_EQ(nd::array({-23, -10, 3, 16, 29}), f(a, b));
+}
+
+TEST(Fuse, Invalid) {
+  // The wrong number of arguments for a stage
+  EXPECT_THROW(nd::functional::fuse(2, {{nd::add, {0}}}), invalid_argument);
+  // An argument which is not computed yet
+  EXPECT_THROW(nd::functional::fuse(2, {{nd::add, {0, 2}}}), invalid_argument);
+  EXPECT_THROW(nd::functional::fuse(2, {}), invalid_argument);
+}
+
 /*
 TEST(Convert, Unary)
 {
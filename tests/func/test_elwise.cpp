@@ -11,10 +11,12 @@
 #include <dynd/array.hpp>
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/callables/elwise_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/gtest.hpp>
 #include <dynd/index.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/thread_pool.hpp>
 #include <dynd/types/fixed_string_type.hpp>
 
 using namespace std;
@@ -218,6 +220,136 @@ TEST(Elwise, Binary_FixedDim) {
   EXPECT_ARRAY_EQ((nd::array{3, 5, 7}), f({{0, 1, 2}, {3, 4, 5}}, {}));
 }
 
+TEST(Elwise, Parallel) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = 4;
+  eval::default_eval_context.min_grain_size = 16;
+
+  nd::callable f = nd::functional::elwise(nd::functional::apply([](int x, int y) { return x * y + 1; }));
+
+  nd::array a = nd::empty(ndt::make_type<int[1000]>());
+  nd::array b = nd::empty(ndt::make_type<int[1000]>());
+  nd::array expected = nd::empty(ndt::make_type<int[1000]>());
+  for (int i = 0; i < 1000; ++i) {
+    a(i).assign(i);
+    b(i).assign(3 - i);
+    expected(i).assign(i * (3 - i) + 1);
+  }
+  EXPECT_ARRAY_EQ(expected, f(a, b));
+  EXPECT_LE(3u, thread_pool::get().size());
+
+  // Broadcasting a scalar over the split dimension
+  nd::array c = nd::empty(ndt::make_type<int[40][25]>());
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 25; ++j) {
+      c(i, j).assign(i + j);
+    }
+  }
+  nd::array res = f(c, 2);
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 25; ++j) {
+      EXPECT_EQ(2 * (i + j) + 1, res(i, j).as<int>());
+    }
+  }
+
+  // Exceptions raised on any thread reach the caller
+  nd::callable g = nd::functional::elwise(nd::functional::apply([](int x) {
+    if (x == 999) {
+      throw std::runtime_error("999");
+    }
+    return x;
+  }));
+  EXPECT_THROW(g(a), std::runtime_error);
+
+  eval::default_eval_context = saved_ectx;
+}
+
+TEST(Elwise, LoopPlanning) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = 1;
+
+  nd::callable f = nd::functional::elwise(nd::functional::apply([](int x, int y) { return x + 2 * y; }));
+
+  // The size and destination stride of the outermost loop in the kernel for f
+  auto outer_loop = [&f](const nd::array &dst, const nd::array &x, const nd::array &y) {
+    nd::call_graph cg;
+    ndt::type src_tp[2] = {x.get_type(), y.get_type()};
+    f->resolve(nullptr, nullptr, cg, dst.get_type(), 2, src_tp, 0, nullptr, std::map<std::string, ndt::type>());
+
+    nd::kernel_builder kb(cg.get());
+    const char *src_arrmeta[2] = {x->metadata(), y->metadata()};
+    kb(kernel_request_single, nullptr, dst->metadata(), 2, src_arrmeta);
+
+    typedef nd::functional::elwise_kernel<fixed_dim_id, fixed_dim_id, nd::functional::no_traits, 2> kernel_type;
+    kernel_type *self = kb.get_at<kernel_type>(0);
+    return make_pair(self->m_size, self->m_dst_stride);
+  };
+
+  nd::array a = nd::empty(ndt::make_type<int[10][20][4]>());
+  nd::array b = nd::empty(ndt::make_type<int[10][20][4]>());
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      for (int k = 0; k < 4; ++k) {
+        a(i, j, k).assign(100 * i + 10 * j + k);
+        b(i, j, k).assign(i - j + k);
+      }
+    }
+  }
+
+  // Contiguous dimensions run as one loop
+  nd::array dst = nd::empty(ndt::make_type<int[10][20][4]>());
+  EXPECT_EQ(make_pair(intptr_t(800), intptr_t(4)), outer_loop(dst, a, b));
+
+  // So do transposed ones, innermost first
+  nd::array dst_t = nd::empty(ndt::make_type<int[10][20][4]>()).transpose();
+  EXPECT_EQ(make_pair(intptr_t(800), intptr_t(4)), outer_loop(dst_t, a.transpose(), b.transpose()));
+  f({a.transpose(), b.transpose()}, {{"dst", dst_t}});
+
+  // Broadcasting and a dimension of size one
+  nd::array c = nd::empty(ndt::make_type<int[10][1][4]>());
+  nd::array d = {1, 2, 3, 4};
+  for (int i = 0; i < 10; ++i) {
+    for (int k = 0; k < 4; ++k) {
+      c(i, 0, k).assign(10 * i + k);
+    }
+  }
+  EXPECT_EQ(make_pair(intptr_t(10), intptr_t(16)), outer_loop(nd::empty(ndt::make_type<int[10][1][4]>()), c, d));
+  nd::array e = f(c, d);
+  for (int i = 0; i < 10; ++i) {
+    for (int k = 0; k < 4; ++k) {
+      EXPECT_EQ(10 * i + k + 2 * (k + 1), e(i, 0, k).as<int>());
+    }
+  }
+
+  // Operands which disagree on the order of the innermost dimensions are visited in tiles
+  nd::array g = nd::empty(ndt::make_type<int[64][48]>());
+  nd::array h = nd::empty(ndt::make_type<int[48][64]>());
+  {
+    nd::call_graph cg;
+    ndt::type src_tp[2] = {g.get_type(), g.get_type()};
+    f->resolve(nullptr, nullptr, cg, g.get_type(), 2, src_tp, 0, nullptr, std::map<std::string, ndt::type>());
+
+    nd::kernel_builder kb(cg.get());
+    nd::array ht = h.transpose();
+    const char *src_arrmeta[2] = {ht->metadata(), ht->metadata()};
+    kb(kernel_request_single, nullptr, g->metadata(), 2, src_arrmeta);
+    EXPECT_EQ(&nd::functional::tiled_elwise_kernel<2>::destruct, kb.get()->destructor);
+  }
+
+  // Mixed orders give the same result
+  nd::array res = f(a.transpose(), b(irange(), irange(), 1).transpose());
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      for (int k = 0; k < 4; ++k) {
+        EXPECT_EQ(100 * i + 10 * j + k + 2 * (i - j + 1), res(k, j, i).as<int>());
+        EXPECT_EQ(100 * i + 10 * j + k + 2 * (i - j + k), dst_t(k, j, i).as<int>());
+      }
+    }
+  }
+
+  eval::default_eval_context = saved_ectx;
+}
+
 /*
 // TODO Reenable once there's a convenient way to make the binary callable
 TEST(LiftCallable, Expr_MultiDimVarToVarDim) {
@@ -48,6 +48,12 @@ TEST(Option, AssignNA) {
   EXPECT_TRUE(nd::is_na(x).as<bool>());
 }
 
+TEST(Option, AssignNAString) {
+  // The kernel takes no arguments, like that of every other type
+  nd::array x = nd::assign_na({}, {{"dst_tp", ndt::type("?string")}});
+  EXPECT_EQ(ndt::type("?string"), x.get_type());
+}
+
 TEST(Option, AssignNAArray) {
   nd::array a = nd::empty("3 * ?int64");
   a(0).vals() = nd::assign_na({}, {{"dst_tp", ndt::type("?int64")}});
@@ -8,8 +8,11 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <dynd/arithmetic.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/logic.hpp>
+#include <dynd/statistics.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -182,6 +185,40 @@ TEST(Reduction, BuiltinSum_Lift3D_StridedStridedStrided_ReduceBroadcastReduce) {
                                              {{"axes", {0, 2}}}));
 }
 
+TEST(Reduction, Parallel) {
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = 4;
+  eval::default_eval_context.min_grain_size = 16;
+
+  nd::array a = nd::empty(ndt::make_type<int[1000]>());
+  nd::array b = nd::empty(ndt::make_type<double[1001]>());
+  for (int i = 0; i < 1000; ++i) {
+    a(i).assign(i % 2 == 0 ? i : -i);
+    b(i).assign(0.5 * i);
+  }
+  b(1000).assign(-1.0);
+
+  nd::callable f = nd::functional::reduction([] { return 7; }, [](const return_wrapper<int> &res, int x) { res += x; },
+                                             nd::associative | nd::commutative);
+  EXPECT_ARRAY_EQ(7 - 500, f(a));
+
+  EXPECT_ARRAY_EQ(-500, nd::sum(a));
+  EXPECT_ARRAY_EQ(0.5 * 999 * 1000 / 2 - 1.0, nd::sum(b));
+  EXPECT_ARRAY_EQ(998, nd::max(a));
+  EXPECT_ARRAY_EQ(-999, nd::min(a));
+  EXPECT_ARRAY_EQ(-1.0, nd::min(b));
+
+  nd::array c = nd::empty(ndt::make_type<bool[500]>());
+  for (int i = 0; i < 500; ++i) {
+    c(i).assign(true);
+  }
+  EXPECT_ARRAY_EQ(true, nd::all(c));
+  c(321).assign(false);
+  EXPECT_ARRAY_EQ(false, nd::all(c));
+
+  eval::default_eval_context = saved_ectx;
+}
+
 TEST(Reduction, Except) {
   // Cannot have a null child
   EXPECT_THROW(nd::functional::reduction([] { return 0; }, nd::callable()), invalid_argument);
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <stdexcept>
 
 #include <dynd/gtest.hpp>
@@ -19,3 +21,84 @@ TEST(Search, BinarySearch) {
   EXPECT_ARRAY_VALS_EQ(1, nd::binary_search(nd::array{5, 3, 1}, 3));
   EXPECT_ARRAY_VALS_EQ(-1, nd::binary_search(nd::array{5, 3, 1}, 10));
 }
+
+TEST(Search, SearchSorted) {
+  nd::array a{1, 3, 3, 5, 8};
+  nd::array needles{0, 3, 4, 8, 9, 3, 1};
+  nd::array ix = nd::searchsorted(a, needles);
+  EXPECT_EQ(ndt::type("7 * intptr"), ix.get_type());
+  intptr_t left[7] = {0, 1, 3, 4, 5, 1, 0};
+  intptr_t right[7] = {0, 3, 3, 5, 5, 3, 1};
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(left[i], ix(i).as<intptr_t>());
+  }
+
+  ix = nd::searchsorted({a, needles}, {{"side", "right"}});
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(right[i], ix(i).as<intptr_t>());
+  }
+
+  EXPECT_THROW(nd::searchsorted({a, needles}, {{"side", "middle"}}), invalid_argument);
+  EXPECT_THROW(nd::searchsorted(a, nd::array{1.5}), type_error);
+}
+
+TEST(Search, SearchSortedRandom) {
+  default_random_engine generator(3);
+  uniform_int_distribution<int> d(-1000, 1000);
+  vector<double> vals(5000);
+  for (double &val : vals) {
+    val = d(generator) / 4.0;
+  }
+  std::sort(vals.begin(), vals.end());
+  nd::array a = nd::empty(5000, ndt::make_type<double>());
+  a.vals() = vals;
+
+  // Unsorted needles, then sorted ones both sparse and dense enough to be merged
+  for (int size : {300, 100, 2000}) {
+    vector<double> needle_vals(size);
+    for (double &val : needle_vals) {
+      val = d(generator) / 4.0 + 0.1;
+    }
+    if (size != 300) {
+      std::sort(needle_vals.begin(), needle_vals.end());
+    }
+    nd::array needles = nd::empty(size, ndt::make_type<double>());
+    needles.vals() = needle_vals;
+
+    nd::array left = nd::searchsorted(a, needles);
+    nd::array right = nd::searchsorted({a, needles}, {{"side", "right"}});
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(std::lower_bound(vals.begin(), vals.end(), needle_vals[i]) - vals.begin(), left(i).as<intptr_t>());
+      EXPECT_EQ(std::upper_bound(vals.begin(), vals.end(), needle_vals[i]) - vals.begin(), right(i).as<intptr_t>());
+    }
+  }
+}
+
+TEST(Search, SearchSortedNaN) {
+  // NaNs sort last, as with nd::sort
+  double nan = numeric_limits<double>::quiet_NaN();
+  nd::array a{-1.0, 0.0, 2.0, nan, nan};
+  nd::array ix = nd::searchsorted(a, nd::array{nan, 2.0, -numeric_limits<double>::infinity()});
+  EXPECT_EQ(3, ix(0).as<intptr_t>());
+  EXPECT_EQ(2, ix(1).as<intptr_t>());
+  EXPECT_EQ(0, ix(2).as<intptr_t>());
+}
+
+TEST(Search, SearchSortedString) {
+  nd::array a = nd::empty(4, ndt::make_type<dynd::string>());
+  const char *vals[4] = {"apple", "banana", "banana", "cherry"};
+  for (int i = 0; i < 4; ++i) {
+    a(i).assign(vals[i]);
+  }
+  nd::array needles = nd::empty(3, ndt::make_type<dynd::string>());
+  needles(0).assign("banana");
+  needles(1).assign("a");
+  needles(2).assign("date");
+
+  nd::array left = nd::searchsorted(a, needles);
+  nd::array right = nd::searchsorted({a, needles}, {{"side", "right"}});
+  EXPECT_EQ(1, left(0).as<intptr_t>());
+  EXPECT_EQ(3, right(0).as<intptr_t>());
+  EXPECT_EQ(0, left(1).as<intptr_t>());
+  EXPECT_EQ(4, left(2).as<intptr_t>());
+}
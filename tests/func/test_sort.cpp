@@ -5,10 +5,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <stdexcept>
 
 #include <dynd/gtest.hpp>
+#include <dynd/index.hpp>
+#include <dynd/json_parser.hpp>
 #include <dynd/sort.hpp>
 
 using namespace std;
@@ -24,11 +29,303 @@ TEST(Sort, 1D) {
   EXPECT_ARRAY_EQ((nd::array{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19}), a);
 }
 
-/*
-TEST(Unique, 1D)
-{
-  nd::array a{0, 0, 1, 2, 2, 3};
-  nd::unique(a);
-  EXPECT_ARRAY_EQ((nd::array{0, 1, 2, 3}), a);
+template <typename T>
+class SortRadix : public ::testing::Test {};
+
+typedef ::testing::Types<int8_t, int16_t, int32_t, int64_t, uint8_t, uint16_t, uint32_t, uint64_t, float, double>
+    RadixTypes;
+
+TYPED_TEST_SUITE(SortRadix, RadixTypes);
+
+TYPED_TEST(SortRadix, Random) {
+  // Long enough to take the radix sort, with repeated values
+  default_random_engine generator(5);
+  uniform_int_distribution<int> d(-100, 100);
+  vector<TypeParam> vals(1000);
+  for (TypeParam &val : vals) {
+    val = static_cast<TypeParam>(std::is_floating_point<TypeParam>::value ? d(generator) / 8.0 : d(generator));
+  }
+
+  nd::array a = nd::empty(1000, ndt::make_type<TypeParam>());
+  a.vals() = vals;
+  nd::sort(a);
+  std::sort(vals.begin(), vals.end());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(vals[i], a(i).as<TypeParam>());
+  }
+
+  // A strided view is sorted in place, leaving the other elements alone
+  nd::array b = nd::empty(2000, ndt::make_type<TypeParam>());
+  b.vals() = 7;
+  nd::array c = b(irange().by(2));
+  c.vals() = a(irange().by(-1));
+  nd::sort(c);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(vals[i], b(2 * i).as<TypeParam>());
+    EXPECT_EQ(TypeParam(7), b(2 * i + 1).as<TypeParam>());
+  }
+}
+
+TYPED_TEST(SortRadix, Argsort) {
+  default_random_engine generator(7);
+  uniform_int_distribution<int> d(-20, 20);
+  vector<TypeParam> vals(1000);
+  for (TypeParam &val : vals) {
+    val = static_cast<TypeParam>(d(generator));
+  }
+
+  // Both sizes, below and above the radix sort, keep equal values in order
+  for (int size : {100, 1000}) {
+    nd::array a = nd::empty(size, ndt::make_type<TypeParam>());
+    a.vals() = nd::array(vals)(irange() < size);
+    nd::array ix = nd::argsort(a);
+    EXPECT_EQ(ndt::make_fixed_dim(size, ndt::make_type<intptr_t>()), ix.get_type());
+
+    vector<intptr_t> expected(size);
+    for (int i = 0; i < size; ++i) {
+      expected[i] = i;
+    }
+    std::stable_sort(expected.begin(), expected.end(), [&](intptr_t i, intptr_t j) { return vals[i] < vals[j]; });
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(expected[i], ix(i).as<intptr_t>());
+    }
+  }
+}
+
+TEST(Sort, Limits) {
+  nd::array a{int64_t(3), numeric_limits<int64_t>::max(), int64_t(-1), numeric_limits<int64_t>::min(), int64_t(0)};
+  nd::sort(a);
+  EXPECT_ARRAY_EQ((nd::array{numeric_limits<int64_t>::min(), int64_t(-1), int64_t(0), int64_t(3),
+                             numeric_limits<int64_t>::max()}),
+                  a);
+
+  // Signed zeros, infinities and NaNs, with NaNs last
+  vector<double> vals(300);
+  for (int i = 0; i < 300; ++i) {
+    vals[i] = (i % 2 == 0 ? 1 : -1) * (i % 7) * 1e300;
+  }
+  vals[10] = numeric_limits<double>::quiet_NaN();
+  vals[20] = -numeric_limits<double>::quiet_NaN();
+  vals[30] = -numeric_limits<double>::infinity();
+  vals[40] = -0.0;
+  nd::array b = nd::empty(300, ndt::make_type<double>());
+  b.vals() = vals;
+  nd::sort(b);
+  EXPECT_EQ(-numeric_limits<double>::infinity(), b(0).as<double>());
+  for (int i = 1; i < 298; ++i) {
+    EXPECT_LE(b(i - 1).as<double>(), b(i).as<double>());
+  }
+  EXPECT_TRUE(std::isnan(b(298).as<double>()));
+  EXPECT_TRUE(std::isnan(b(299).as<double>()));
+}
+
+TEST(Sort, NaNPayloads) {
+  // NaNs of either sign and with payloads compare equal, and keep their bits and order
+  const uint32_t nan_bits[4] = {0xffc00002, 0x7fc12345, 0xffc00000, 0x7fc00001};
+  for (int size : {40, 400}) {
+    vector<float> vals(size);
+    for (int i = 0; i < size; ++i) {
+      vals[i] = static_cast<float>((i * 37) % 23) - 11.0f;
+    }
+    vector<int> nan_index = {3, 7, size / 2, size - 1};
+    for (int j = 0; j < 4; ++j) {
+      memcpy(&vals[nan_index[j]], &nan_bits[j], sizeof(float));
+    }
+
+    nd::array a = nd::empty(size, ndt::make_type<float>());
+    memcpy(a.data(), vals.data(), size * sizeof(float));
+    nd::array ix = nd::argsort(a);
+    nd::sort(a);
+
+    const float *sorted = reinterpret_cast<const float *>(a.cdata());
+    for (int i = 1; i < size - 4; ++i) {
+      EXPECT_LE(sorted[i - 1], sorted[i]);
+    }
+    for (int j = 0; j < 4; ++j) {
+      uint32_t bits;
+      memcpy(&bits, &sorted[size - 4 + j], sizeof(float));
+      EXPECT_EQ(nan_bits[j], bits);
+      EXPECT_EQ(nan_index[j], ix(size - 4 + j).as<intptr_t>());
+    }
+
+    // The sort and the argsort agree, bit for bit
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(0, memcmp(&sorted[i], &vals[ix(i).as<intptr_t>()], sizeof(float)));
+    }
+  }
+}
+
+TEST(Sort, Strings) {
+  vector<std::string> vals(200);
+  for (int i = 0; i < 200; ++i) {
+    vals[i] = std::to_string((i * 37) % 101);
+  }
+
+  // A merge sort over several threads, with the comparison of the strings
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = 3;
+  eval::default_eval_context.min_grain_size = 16;
+
+  nd::array a = nd::empty(200, ndt::make_type<dynd::string>());
+  for (int i = 0; i < 200; ++i) {
+    a(i).assign(vals[i]);
+  }
+  nd::sort(a);
+  eval::default_eval_context = saved_ectx;
+
+  std::sort(vals.begin(), vals.end());
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(vals[i], a(i).as<std::string>());
+  }
+}
+
+TEST(Argsort, Strings) {
+  vector<std::string> vals(200);
+  for (int i = 0; i < 200; ++i) {
+    vals[i] = std::to_string((i * 37) % 11);
+  }
+
+  nd::array a = nd::empty(200, ndt::make_type<dynd::string>());
+  for (int i = 0; i < 200; ++i) {
+    a(i).assign(vals[i]);
+  }
+
+  vector<intptr_t> expected(200);
+  for (int i = 0; i < 200; ++i) {
+    expected[i] = i;
+  }
+  std::stable_sort(expected.begin(), expected.end(), [&](intptr_t i, intptr_t j) { return vals[i] < vals[j]; });
+
+  // Either mode sorts, a stable one keeps equal strings in order
+  nd::array ix = nd::argsort(a);
+  for (int i = 1; i < 200; ++i) {
+    EXPECT_LE(vals[ix(i - 1).as<intptr_t>()], vals[ix(i).as<intptr_t>()]);
+  }
+
+  eval::eval_context saved_ectx = eval::default_eval_context;
+  eval::default_eval_context.nthreads = 3;
+  eval::default_eval_context.min_grain_size = 16;
+  ix = nd::argsort({a}, {{"stable", true}});
+  eval::default_eval_context = saved_ectx;
+
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(expected[i], ix(i).as<intptr_t>());
+  }
+
+  // The elements were not moved
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(vals[i], a(i).as<std::string>());
+  }
+}
+
+TEST(Argsort, Take) {
+  // Records are sorted by one field with a single gather
+  nd::array a = parse_json("5 * {key: float64, name: string}",
+                           "[[2.5, \"c\"], [-1, \"a\"], [2.5, \"d\"], [7, \"e\"], [0, \"b\"]]");
+  nd::array keys = nd::empty(5, ndt::make_type<double>());
+  for (int i = 0; i < 5; ++i) {
+    keys(i).vals() = a(i).p("key");
+  }
+
+  nd::array b = nd::take(a, nd::argsort(keys));
+  EXPECT_EQ(ndt::type("5 * {key: float64, name: string}"), b.get_type());
+  const char *names[5] = {"a", "b", "c", "d", "e"};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(names[i], b(i).p("name").as<std::string>());
+  }
+}
+
+TEST(Unique, 1D) {
+  nd::array a{3, 0, 1, 3, 2, 2, 0, 3};
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * int32"), b.get_type());
+  ASSERT_EQ(4, b.get_dim_size());
+  int expected[4] = {3, 0, 1, 2};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(expected[i], b(i).as<int>());
+  }
+
+  // Many distinct values, so the hash table grows
+  nd::array c = nd::empty(10000, ndt::make_type<int64_t>());
+  for (int i = 0; i < 10000; ++i) {
+    c(i).vals() = (i * 7919) % 3001;
+  }
+  b = nd::unique(c);
+  ASSERT_EQ(3001, b.get_dim_size());
+  for (int i = 0; i < 3001; ++i) {
+    EXPECT_EQ((i * 7919) % 3001, b(i).as<int64_t>());
+  }
+}
+
+TEST(Unique, Float) {
+  // The zeros are equal, and so are all the NaNs
+  nd::array a{1.5, -0.0, numeric_limits<double>::quiet_NaN(), 0.0, 1.5, -numeric_limits<double>::quiet_NaN()};
+  nd::array b = nd::unique(a);
+  ASSERT_EQ(3, b.get_dim_size());
+  EXPECT_EQ(1.5, b(0).as<double>());
+  EXPECT_EQ(0.0, b(1).as<double>());
+  EXPECT_TRUE(std::isnan(b(2).as<double>()));
+}
+
+TEST(Unique, String) {
+  nd::array a = nd::empty(6, ndt::make_type<dynd::string>());
+  const char *vals[6] = {"banana", "apple", "a string longer than the small string buffer", "apple", "banana",
+                         "a string longer than the small string buffer"};
+  for (int i = 0; i < 6; ++i) {
+    a(i).assign(vals[i]);
+  }
+
+  nd::array b = nd::unique(a);
+  EXPECT_EQ(ndt::type("var * string"), b.get_type());
+  ASSERT_EQ(3, b.get_dim_size());
+  EXPECT_EQ("banana", b(0).as<std::string>());
+  EXPECT_EQ("apple", b(1).as<std::string>());
+  EXPECT_EQ(vals[2], b(2).as<std::string>());
+
+  nd::array c = nd::empty(ndt::type("4 * fixed_string[8]"));
+  for (int i = 0; i < 4; ++i) {
+    c(i).assign(vals[i % 2]);
+  }
+  b = nd::unique(c);
+  EXPECT_EQ(ndt::type("var * fixed_string[8]"), b.get_type());
+  ASSERT_EQ(2, b.get_dim_size());
+  EXPECT_EQ("banana", b(0).as<std::string>());
+  EXPECT_EQ("apple", b(1).as<std::string>());
+}
+
+TEST(Unique, ValueCounts) {
+  nd::array a{3, 0, 1, 3, 2, 2, 0, 3};
+  nd::array b = nd::value_counts(a);
+  EXPECT_EQ(ndt::type("{values: var * int32, counts: var * intptr}"), b.get_type());
+  nd::array values = b.p("values"), counts = b.p("counts");
+  ASSERT_EQ(4, values.get_dim_size());
+  ASSERT_EQ(4, counts.get_dim_size());
+  int expected_values[4] = {3, 0, 1, 2};
+  intptr_t expected_counts[4] = {3, 2, 1, 2};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(expected_values[i], values(i).as<int>());
+    EXPECT_EQ(expected_counts[i], counts(i).as<intptr_t>());
+  }
+}
+
+TEST(Unique, Factorize) {
+  nd::array a = nd::empty(5, ndt::make_type<dynd::string>());
+  const char *vals[5] = {"x", "y", "x", "z", "y"};
+  for (int i = 0; i < 5; ++i) {
+    a(i).assign(vals[i]);
+  }
+
+  nd::array b = nd::factorize(a);
+  EXPECT_EQ(ndt::type("{codes: 5 * intptr, uniques: var * string}"), b.get_type());
+  EXPECT_ARRAY_EQ((nd::array{intptr_t(0), intptr_t(1), intptr_t(0), intptr_t(2), intptr_t(1)}), b.p("codes"));
+  nd::array uniques = b.p("uniques");
+  ASSERT_EQ(3, uniques.get_dim_size());
+  EXPECT_EQ("x", uniques(0).as<std::string>());
+  EXPECT_EQ("y", uniques(1).as<std::string>());
+  EXPECT_EQ("z", uniques(2).as<std::string>());
+
+  // The codes pick the values back out
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(vals[i], uniques(b.p("codes")(i).as<intptr_t>()).as<std::string>());
+  }
 }
-*/
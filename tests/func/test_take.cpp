@@ -34,14 +34,12 @@ TEST(Callable, Take) {
   intptr_t bvals2[4] = {3, 0, -1, 4};
   b = bvals2;
   c = nd::take(a, b);
-  /*
-    EXPECT_EQ(ndt::type("4 * int"), c.get_type());
-    ASSERT_EQ(4, c.get_dim_size());
-    EXPECT_EQ(4, c(0).as<int>());
-    EXPECT_EQ(1, c(1).as<int>());
-    EXPECT_EQ(5, c(2).as<int>());
-    EXPECT_EQ(5, c(3).as<int>());
-  */
+  EXPECT_EQ(ndt::type("4 * int"), c.get_type());
+  ASSERT_EQ(4, c.get_dim_size());
+  EXPECT_EQ(4, c(0).as<int>());
+  EXPECT_EQ(1, c(1).as<int>());
+  EXPECT_EQ(5, c(2).as<int>());
+  EXPECT_EQ(5, c(3).as<int>());
 }
 
 TEST(Callable, TakeOfArray) {
@@ -62,21 +60,19 @@ TEST(Callable, TakeOfArray) {
   EXPECT_EQ(4, c(1, 0).as<int>());
   EXPECT_EQ(5, c(1, 1).as<int>());
 
-  /*
-    // Indexed take
-    intptr_t bvals2[4] = {1, 0, -1, -2};
-    b = bvals2;
-    c = nd::take(a, b);
-    EXPECT_EQ(ndt::type("4 * 2 * int"), c.get_type());
-    ASSERT_EQ(4, c.get_dim_size());
-    ASSERT_EQ(2, c.get_shape()[1]);
-    EXPECT_EQ(2, c(0, 0).as<int>());
-    EXPECT_EQ(3, c(0, 1).as<int>());
-    EXPECT_EQ(0, c(1, 0).as<int>());
-    EXPECT_EQ(1, c(1, 1).as<int>());
-    EXPECT_EQ(4, c(2, 0).as<int>());
-    EXPECT_EQ(5, c(2, 1).as<int>());
-    EXPECT_EQ(2, c(3, 0).as<int>());
-    EXPECT_EQ(3, c(3, 1).as<int>());
-  */
+  // Indexed take
+  intptr_t bvals2[4] = {1, 0, -1, -2};
+  b = bvals2;
+  c = nd::take(a, b);
+  EXPECT_EQ(ndt::type("4 * 2 * int"), c.get_type());
+  ASSERT_EQ(4, c.get_dim_size());
+  ASSERT_EQ(2, c.get_shape()[1]);
+  EXPECT_EQ(2, c(0, 0).as<int>());
+  EXPECT_EQ(3, c(0, 1).as<int>());
+  EXPECT_EQ(0, c(1, 0).as<int>());
+  EXPECT_EQ(1, c(1, 1).as<int>());
+  EXPECT_EQ(4, c(2, 0).as<int>());
+  EXPECT_EQ(5, c(2, 1).as<int>());
+  EXPECT_EQ(2, c(3, 0).as<int>());
+  EXPECT_EQ(3, c(3, 1).as<int>());
 }
@@ -8,8 +8,11 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <dynd/callables/default_instantiable_callable.hpp>
 #include <dynd/dispatcher.hpp>
+#include <dynd/functional.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
 #include <dynd/type_registry.hpp>
 #include <dynd/types/bool_kind_type.hpp>
 
@@ -76,6 +79,92 @@ TEST(Sort, TopologicalSort) {
   EXPECT_EQ((vector<int>{5, 4, 2, 3, 1, 0}), res);
 }
 
+namespace {
+
+struct dummy_kernel : nd::base_strided_kernel<dummy_kernel, 1> {
+  void single(char *DYND_UNUSED(dst), char *const *DYND_UNUSED(src)) {}
+};
+
+std::vector<ndt::type> dispatch_args(const ndt::type &DYND_UNUSED(dst_tp), size_t nsrc, const ndt::type *src_tp) {
+  return std::vector<ndt::type>(src_tp, src_tp + nsrc);
+}
+
+} // unnamed namespace
+
+TEST(DispatchTable, InsertFind) {
+  detail::dispatch_table<2> table;
+  EXPECT_EQ(NULL, table.find({{int32_id, int16_id}}, 0));
+
+  // Enough keys to grow the table a few times
+  for (int i = bool_id; i <= complex_float64_id; ++i) {
+    for (int j = bool_id; j <= complex_float64_id; ++j) {
+      std::array<type_id_t, 2> key{{static_cast<type_id_t>(i), static_cast<type_id_t>(j)}};
+      table.insert(key, table.hash(key), 100 * i + j);
+    }
+  }
+
+  for (int i = bool_id; i <= complex_float64_id; ++i) {
+    for (int j = bool_id; j <= complex_float64_id; ++j) {
+      std::array<type_id_t, 2> key{{static_cast<type_id_t>(i), static_cast<type_id_t>(j)}};
+      const intptr_t *value = table.find(key, table.hash(key));
+      ASSERT_NE(nullptr, value);
+      EXPECT_EQ(100 * i + j, *value);
+    }
+  }
+
+  std::array<type_id_t, 2> key{{string_id, int32_id}};
+  EXPECT_EQ(NULL, table.find(key, table.hash(key)));
+
+  table.clear();
+  EXPECT_EQ(0u, table.size());
+  key = {{int32_id, int16_id}};
+  EXPECT_EQ(NULL, table.find(key, table.hash(key)));
+}
+
+TEST(Dispatcher, Cached) {
+  nd::callable int32_child = nd::functional::apply([](int32_t x) { return x; });
+  nd::callable float64_child = nd::functional::apply([](double x) { return x; });
+  nd::callable int_child = nd::make_callable<nd::default_instantiable_callable<dummy_kernel>>(
+      ndt::type("(Int) -> int64"));
+  nd::callable scalar_child = nd::make_callable<nd::default_instantiable_callable<dummy_kernel>>(
+      ndt::type("(Scalar) -> int64"));
+
+  dispatcher<1, nd::callable> d(dispatch_args, {scalar_child, int32_child, float64_child, int_child});
+
+  // Exact signatures, patterns and failures give the same result every time
+  for (int i = 0; i < 3; ++i) {
+    ndt::type tp = ndt::make_type<int32_t>();
+    EXPECT_EQ(int32_child.get(), d(ndt::type(), 1, &tp).get());
+    tp = ndt::make_type<double>();
+    EXPECT_EQ(float64_child.get(), d(ndt::type(), 1, &tp).get());
+    tp = ndt::make_type<int16_t>();
+    EXPECT_EQ(int_child.get(), d(ndt::type(), 1, &tp).get());
+    tp = ndt::make_type<float>();
+    EXPECT_EQ(scalar_child.get(), d(ndt::type(), 1, &tp).get());
+    tp = ndt::type("3 * int32");
+    EXPECT_THROW(d(ndt::type(), 1, &tp), out_of_range);
+  }
+
+  // So are failures for builtin types, which are cached
+  dispatcher<1, nd::callable> d_int32(dispatch_args, {int32_child});
+  for (int i = 0; i < 3; ++i) {
+    ndt::type tp = ndt::make_type<double>();
+    EXPECT_THROW(d_int32(ndt::type(), 1, &tp), out_of_range);
+  }
+
+  // Inserting a child forgets what was resolved before
+  nd::callable int16_child = nd::functional::apply([](int16_t x) { return x; });
+  d.insert(int16_child);
+  ndt::type tp = ndt::make_type<int16_t>();
+  EXPECT_EQ(int16_child.get(), d(ndt::type(), 1, &tp).get());
+
+  // A copy resolves the same way
+  auto copied = d;
+  EXPECT_EQ(int16_child.get(), copied(ndt::type(), 1, &tp).get());
+  tp = ndt::make_type<float>();
+  EXPECT_EQ(scalar_child.get(), copied(ndt::type(), 1, &tp).get());
+}
+
 /*
 TEST(Dispatcher, Unary) {
   dispatcher<1, int> dispatcher{
@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/expression.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/kernels/kernel_cache.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Expression, Value) {
+  nd::array a = {1, 2, 3};
+  nd::expression e = nd::lazy(a);
+  EXPECT_TRUE(e.is_value());
+  EXPECT_EQ(a.get(), e.eval().get());
+
+  nd::array dst = nd::empty(ndt::type("3 * float64"));
+  e.eval(dst);
+  EXPECT_ARRAY_EQ(nd::array({1.0, 2.0, 3.0}), dst);
+}
+
+TEST(Expression, Arithmetic) {
+  vector<double> x(1000), y(1000);
+  for (int i = 0; i < 1000; ++i) {
+    x[i] = 0.25 * i;
+    y[i] = 1000 - i;
+  }
+  nd::array a = x, b = y;
+  nd::array c = 2;
+
+  nd::expression e = nd::lazy(a) * b + c;
+  EXPECT_FALSE(e.is_value());
+  EXPECT_ARRAY_EQ(a * b + c, e.eval());
+
+  // The operators mix expressions and arrays on either side
+  EXPECT_ARRAY_EQ(-(a / c) - (b - a) * c, nd::array(-(nd::lazy(a) / c) - (b - nd::lazy(a)) * c));
+  EXPECT_ARRAY_EQ(nd::array({2, 3}), nd::array(+nd::lazy(nd::array({1, 2})) + 1));
+}
+
+TEST(Expression, Destination) {
+  nd::array a = {{1, 2, 3}, {4, 5, 6}};
+  nd::array b = {10, 20, 30};
+
+  // The result is broadcast and converted into the destination
+  nd::array dst = nd::empty(ndt::type("2 * 3 * float32"));
+  (nd::lazy(a) * b + a).eval(dst);
+  EXPECT_ARRAY_EQ(nd::array({{11.0f, 42.0f, 93.0f}, {44.0f, 105.0f, 186.0f}}), dst);
+}
+
+TEST(Expression, CommonSubexpressions) {
+  nd::array a = {1, 2, 3, 4};
+  nd::array b = {4, 3, 2, 1};
+
+  // The same subexpression, and the same operation made twice, are computed once
+  nd::expression s = nd::lazy(a) + b;
+  nd::expression e = s * s + (nd::lazy(a) + b) * s;
+  EXPECT_ARRAY_EQ(nd::array({50, 50, 50, 50}), e.eval());
+
+  // Evaluating the same kind of expression again reuses its kernel
+  nd::kernel_cache &cache = nd::kernel_cache::get();
+  nd::array c = {1, 1, 1, 1};
+  nd::array d = {2, 2, 2, 2};
+  size_t hits = cache.hits();
+  nd::expression f = nd::lazy(c) + d;
+  nd::array res = (f * f + (nd::lazy(c) + d) * f).eval();
+  EXPECT_EQ(hits + 1, cache.hits());
+  EXPECT_ARRAY_EQ(nd::array({18, 18, 18, 18}), res);
+}
@@ -5,15 +5,30 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 #include <dynd/gtest.hpp>
 #include <dynd/io.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/types/string_type.hpp>
 
 using namespace std;
 using namespace dynd;
 
+static void remove_file(const char *fn) {
+#ifdef WIN32
+  _unlink(fn);
+#else
+  unlink(fn);
+#endif
+}
+
+static std::string to_json(const nd::array &a) { return format_json(a).as<std::string>(); }
+
 TEST(Serialize, FixedDim) {
   EXPECT_ARRAY_EQ(bytes("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00\x04\x00\x00\x00"),
                   nd::serialize(nd::array{0, 1, 2, 3, 4}));
@@ -23,3 +38,116 @@ TEST(Serialize, FixedDimFixedDim) {
   EXPECT_ARRAY_EQ(bytes("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00"),
                   nd::serialize(nd::array{{0, 1}, {2, 3}}));
 }
+
+TEST(BinaryFile, FixedDim) {
+  nd::array a = {{1, 2, 3}, {4, 5, 6}};
+  nd::save("test.dynd", a);
+  nd::array b = nd::load("test.dynd");
+  EXPECT_EQ(a.get_type(), b.get_type());
+  EXPECT_ARRAY_EQ(a, b);
+  EXPECT_EQ(static_cast<uint64_t>(nd::read_access_flag), b.get_flags());
+
+  // A private map of plain data can be written, without changing the file
+  nd::memmap_options options;
+  options.copy_on_write = true;
+  b = nd::load("test.dynd", options);
+  EXPECT_EQ(static_cast<uint64_t>(nd::readwrite_access_flags), b.get_flags());
+  b(1, 1).assign(50);
+  EXPECT_EQ(50, b(1, 1).as<int>());
+  EXPECT_EQ(5, nd::load("test.dynd")(1, 1).as<int>());
+
+  // A strided view is written in the default layout
+  nd::array c = nd::array{0.5, 1.5, 2.5, 3.5, 4.5}(irange().by(2));
+  nd::save("test.dynd", c);
+  EXPECT_ARRAY_EQ(nd::array({0.5, 2.5, 4.5}), nd::load("test.dynd"));
+
+  // A scalar
+  nd::save("test.dynd", nd::array(7.25));
+  EXPECT_EQ(7.25, nd::load("test.dynd").as<double>());
+
+  b = nd::array();
+  remove_file("test.dynd");
+}
+
+TEST(BinaryFile, Strings) {
+  nd::array a = nd::empty(ndt::type("4 * string"));
+  a(0).assign("");
+  a(1).assign("short");
+  a(2).assign("fourteen chars");
+  a(3).assign("a string which is too long to be stored inline");
+  nd::save("test.dynd", a);
+  nd::array b = nd::load("test.dynd");
+  EXPECT_EQ(a.get_type(), b.get_type());
+  EXPECT_EQ(static_cast<uint64_t>(nd::read_access_flag), b.get_flags());
+  for (intptr_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(a(i).as<std::string>(), b(i).as<std::string>());
+  }
+
+  // Strings too long to be stored inline are still NUL terminated
+  EXPECT_EQ(0, strcmp("a string which is too long to be stored inline",
+                      reinterpret_cast<const dynd::string *>(b(3).cdata())->begin()));
+
+  b = nd::array();
+  remove_file("test.dynd");
+}
+
+TEST(BinaryFile, VarDim) {
+  ndt::type tp("2 * var * {name: string, values: var * int64, score: ?float64}");
+  nd::array a = parse_json(tp, "[[{\"name\": \"a name which is too long to be stored inline\", "
+                                    "\"values\": [1, 2, 3], \"score\": 1.5}, "
+                                    "{\"name\": \"b\", \"values\": [], \"score\": null}], []]");
+  nd::save("test.dynd", a);
+  nd::array b = nd::load("test.dynd");
+  EXPECT_EQ(tp, b.get_type());
+  EXPECT_EQ(to_json(a), to_json(b));
+  EXPECT_EQ(2, b(0).get_dim_size());
+  EXPECT_EQ(0, b(1).get_dim_size());
+  EXPECT_EQ(3, b(0, 0, 1, 2).as<int64_t>());
+
+  // The loaded array outlives the name it was loaded from
+  b = b(0, 0, 0);
+  remove_file("test.dynd");
+  EXPECT_EQ("a name which is too long to be stored inline", b.as<std::string>());
+}
+
+TEST(BinaryFile, Errors) {
+  {
+    ofstream out("test.dynd", ios::binary);
+    out << "[1, 2, 3]";
+  }
+  EXPECT_THROW(nd::load("test.dynd"), runtime_error);
+
+  // A file cut short
+  nd::save("test.dynd", nd::array{1, 2, 3});
+  std::string contents;
+  {
+    ifstream in("test.dynd", ios::binary);
+    contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+  {
+    ofstream out("test.dynd", ios::binary);
+    out.write(contents.data(), contents.size() - 4);
+  }
+  EXPECT_THROW(nd::load("test.dynd"), runtime_error);
+
+  // A var dim pointing past the end of the file
+  nd::save("test.dynd", parse_json(ndt::type("var * int32"), "[1, 2, 3]"));
+  {
+    ifstream in("test.dynd", ios::binary);
+    contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+  // The header holds the offset of the data after its magic, flags and the
+  // offsets and sizes of the datashape and arrmeta
+  uint64_t data_offset;
+  memcpy(&data_offset, &contents[56], sizeof(uint64_t));
+  uint64_t bad_offset = contents.size();
+  memcpy(&contents[data_offset], &bad_offset, sizeof(uint64_t));
+  {
+    ofstream out("test.dynd", ios::binary);
+    out.write(contents.data(), contents.size());
+  }
+  EXPECT_THROW(nd::load("test.dynd"), runtime_error);
+
+  EXPECT_THROW(nd::save("test.dynd", nd::array()), invalid_argument);
+  remove_file("test.dynd");
+}
@@ -0,0 +1,133 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/kernels/kernel_cache.hpp>
+#include <dynd/storage_arena.hpp>
+#include <dynd/string.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(KernelCache, Reuse) {
+  nd::kernel_cache &cache = nd::kernel_cache::get();
+  cache.clear();
+
+  nd::array a = {1, 2, 3};
+  nd::array b = {4, 5, 6};
+  nd::array c = nd::array({{1, 2}, {3, 4}, {5, 6}})(irange(), 0);
+  nd::array d = {1.0, 2.0, 3.0};
+
+  size_t misses = cache.misses();
+  nd::array res0 = a + b;
+  EXPECT_EQ(misses + 1, cache.misses());
+
+  // The same types and shapes reuse the kernel, with different data
+  size_t hits = cache.hits();
+  nd::array res1 = b + b;
+  EXPECT_EQ(hits + 1, cache.hits());
+
+  // A different type, or different strides with the same shape, needs another kernel
+  misses = cache.misses();
+  nd::array res2 = d + b;
+  EXPECT_EQ(misses + 1, cache.misses());
+  misses = cache.misses();
+  nd::array res3 = c + b;
+  EXPECT_EQ(misses + 1, cache.misses());
+
+  EXPECT_ARRAY_EQ(nd::array({5, 7, 9}), res0);
+  EXPECT_ARRAY_EQ(nd::array({8, 10, 12}), res1);
+  EXPECT_ARRAY_EQ(nd::array({5.0, 7.0, 9.0}), res2);
+  EXPECT_ARRAY_EQ(nd::array({5, 8, 11}), res3);
+
+  cache.clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_EQ(0u, cache.misses());
+}
+
+TEST(KernelCache, Capacity) {
+  nd::kernel_cache &cache = nd::kernel_cache::get();
+  size_t capacity = cache.capacity();
+  cache.clear();
+
+  cache.set_capacity(2);
+  nd::array a = {1, 2, 3};
+  nd::array b = {1, 2};
+  nd::array c = {1};
+  a + a;
+  b + b;
+  c + c;
+  EXPECT_EQ(2u, cache.size());
+
+  // The least recently used kernel was evicted
+  size_t hits = cache.hits();
+  b + b;
+  c + c;
+  EXPECT_EQ(hits + 2, cache.hits());
+  a + a;
+  EXPECT_EQ(hits + 2, cache.hits());
+
+  // A capacity of zero disables the cache
+  cache.set_capacity(0);
+  EXPECT_EQ(0u, cache.size());
+  nd::array res = a + a;
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(hits + 2, cache.hits());
+  EXPECT_ARRAY_EQ(nd::array({2, 4, 6}), res);
+
+  cache.set_capacity(capacity);
+  cache.clear();
+}
+
+TEST(KernelCache, Uncacheable) {
+  nd::kernel_cache &cache = nd::kernel_cache::get();
+  cache.clear();
+
+  // Strings refer to memory blocks from their data, so they are not cached
+  nd::array a = {"testing", "one"};
+  nd::array b = {"alpha", "beta"};
+  size_t misses = cache.misses();
+  nd::array res = nd::string_concatenation(a, b);
+  EXPECT_EQ(misses, cache.misses());
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_ARRAY_EQ(nd::array({"testingalpha", "onebeta"}), res);
+}
+
+TEST(KernelCache, Storage) {
+  nd::kernel_cache &cache = nd::kernel_cache::get();
+  cache.clear();
+
+  // A struct assignment builds a tree of kernels for its fields
+  nd::array a = parse_json("3 * {x: int32, y: string, z: float64}",
+                           "[[1, \"a\", 2], [2, \"b\", 3], [3, \"c\", 4]]");
+  nd::array b = nd::empty(ndt::type("3 * {x: float64, y: string, z: int64}"));
+
+  storage_arena &arena = storage_arena::get();
+  arena.reset_peak();
+  size_t used = arena.used();
+  b.assign(a);
+
+  nd::kernel_cache::storage_stats stats = cache.get_storage_stats();
+  EXPECT_LE(1u, stats.ninstantiated);
+  EXPECT_LT(0u, stats.last_call_graph_bytes);
+  EXPECT_LT(0u, stats.last_kernel_bytes);
+  EXPECT_LE(stats.last_kernel_bytes, stats.kernel_bytes);
+
+  // The uncached kernel came from the arena, which is rewound after the call
+  EXPECT_LT(used, arena.peak());
+  EXPECT_EQ(used, arena.used());
+  EXPECT_EQ(1.0, b(0).p("x").as<double>());
+  EXPECT_EQ("c", b(2).p("y").as<std::string>());
+
+  cache.clear();
+  EXPECT_EQ(0u, cache.get_storage_stats().ninstantiated);
+}
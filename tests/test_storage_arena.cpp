@@ -0,0 +1,81 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdint>
+#include <cstring>
+
+#include <dynd/gtest.hpp>
+
+#include <dynd/storage_arena.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(StorageArena, Stack) {
+  storage_arena arena;
+  EXPECT_EQ(0u, arena.used());
+  EXPECT_EQ(0u, arena.capacity());
+
+  char *a = reinterpret_cast<char *>(arena.allocate(100));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a) % 16);
+  EXPECT_EQ(112u, arena.used());
+  EXPECT_EQ(storage_arena::chunk_size, arena.capacity());
+
+  // The block on top grows in place
+  EXPECT_TRUE(arena.grow(a, 100, 200));
+  EXPECT_EQ(208u, arena.used());
+
+  // Once another block is on top it does not
+  char *b = reinterpret_cast<char *>(arena.allocate(50));
+  EXPECT_EQ(a + 208, b);
+  EXPECT_FALSE(arena.grow(a, 200, 300));
+  memset(a, 1, 200);
+  memset(b, 2, 50);
+
+  // Giving back the block on top pops it
+  arena.deallocate(b, 50);
+  EXPECT_EQ(208u, arena.used());
+  EXPECT_EQ(b, arena.allocate(10));
+  arena.deallocate(b, 10);
+
+  arena.deallocate(a, 200);
+  EXPECT_EQ(0u, arena.used());
+  EXPECT_EQ(a, arena.allocate(10));
+  arena.deallocate(a, 10);
+  EXPECT_EQ(272u, arena.peak());
+}
+
+TEST(StorageArena, Chunks) {
+  storage_arena arena;
+
+  // Blocks which do not fit start new chunks
+  void *a = arena.allocate(storage_arena::chunk_size - 16);
+  void *b = arena.allocate(64);
+  void *c = arena.allocate(4 * storage_arena::chunk_size);
+  EXPECT_LT(5 * storage_arena::chunk_size, arena.capacity());
+
+  // The block which is not on top is only reclaimed when everything is given back
+  arena.deallocate(a, storage_arena::chunk_size - 16);
+  arena.deallocate(c, 4 * storage_arena::chunk_size);
+  EXPECT_EQ(64u, arena.used());
+  arena.deallocate(b, 64);
+  EXPECT_EQ(0u, arena.used());
+
+  // Then the chunks are merged, so the same blocks fit in one
+  size_t capacity = arena.capacity();
+  char *d = reinterpret_cast<char *>(arena.allocate(storage_arena::chunk_size - 16));
+  char *e = reinterpret_cast<char *>(arena.allocate(64));
+  char *f = reinterpret_cast<char *>(arena.allocate(4 * storage_arena::chunk_size));
+  EXPECT_EQ(d + storage_arena::chunk_size - 16, e);
+  EXPECT_EQ(e + 64, f);
+  EXPECT_EQ(capacity, arena.capacity());
+  arena.deallocate(f, 4 * storage_arena::chunk_size);
+  arena.deallocate(e, 64);
+  arena.deallocate(d, storage_arena::chunk_size - 16);
+}
+
+TEST(StorageArena, ThreadLocal) {
+  EXPECT_EQ(&storage_arena::get(), &storage_arena::get());
+}
@@ -122,3 +122,56 @@ TEST(FixedstringDType, Repr) {
     EXPECT_TYPE_REPR_EQ(s, ndt::type(s));
   }
 }
+
+TEST(FixedstringDType, Transcode) {
+  // Runs of ASCII longer than a block, broken up by code points of every UTF-8 length
+  std::string s;
+  for (int i = 0; i < 5; ++i) {
+    s += std::string(21 + i, static_cast<char>('a' + i));
+    s += "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+  }
+
+  string_encoding_t encodings[] = {string_encoding_utf_8, string_encoding_utf_16, string_encoding_utf_32};
+  for (string_encoding_t encoding : encodings) {
+    nd::array a = nd::empty(ndt::make_type<ndt::fixed_string_type>(256, encoding));
+    a.assign(s);
+    EXPECT_EQ(s, a.as<std::string>());
+
+    nd::array d = nd::empty(ndt::make_type<ndt::string_type>());
+    d.assign(a);
+    EXPECT_EQ(s, d.as<std::string>());
+
+    for (string_encoding_t other_encoding : encodings) {
+      nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(256, other_encoding));
+      b.assign(a);
+      EXPECT_EQ(s, b.as<std::string>());
+    }
+
+    // The destination is too small
+    nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(30, encoding));
+    EXPECT_THROW(c.assign(s), runtime_error);
+  }
+
+  // A code point outside the basic plane takes two UTF-16 code units
+  nd::array a = nd::empty(ndt::make_type<ndt::fixed_string_type>(20, string_encoding_utf_16));
+  a.assign(std::string(16, 'x') + "\xf0\x9f\x98\x80" + "y");
+  const uint16_t *units = reinterpret_cast<const uint16_t *>(a.cdata());
+  EXPECT_EQ('x', units[15]);
+  EXPECT_EQ(0xd83d, units[16]);
+  EXPECT_EQ(0xde00, units[17]);
+  EXPECT_EQ('y', units[18]);
+  EXPECT_EQ(0, units[19]);
+
+  // A NUL ends a fixed_string, even within a block of ASCII
+  nd::array b = nd::empty(ndt::make_type<ndt::fixed_string_type>(40, string_encoding_utf_32));
+  b.assign(std::string(40, 'z'));
+  reinterpret_cast<uint32_t *>(b.data())[20] = 0;
+  EXPECT_EQ(std::string(20, 'z'), b.as<std::string>());
+  nd::array d = nd::empty(ndt::make_type<ndt::string_type>());
+  d.assign(b);
+  EXPECT_EQ(std::string(20, 'z'), d.as<std::string>());
+
+  // A code point which is not ASCII is an error, in the middle of a block too
+  nd::array c = nd::empty(ndt::make_type<ndt::fixed_string_type>(40, string_encoding_ascii));
+  EXPECT_THROW(c.assign(std::string(20, 'a') + "\xc3\xa9" + std::string(10, 'b')), string_encode_error);
+}
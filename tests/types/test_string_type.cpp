@@ -3,12 +3,17 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 
 #include <dynd/array.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/parse_util.hpp>
+#include <dynd/simd.hpp>
 #include <dynd/string.hpp>
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/fixed_string_type.hpp>
@@ -182,6 +187,23 @@ TEST(StringType, Storage) {
   EXPECT_EQ(ndt::make_type<ndt::bytes_type>(1), a.storage().get_type());
 }
 
+TEST(StringType, Resize) {
+  // Shrinking and growing within the inline storage keeps the leading bytes
+  dynd::string s("abcde", 5);
+  s.resize(3);
+  EXPECT_EQ(3u, s.size());
+  EXPECT_EQ("abc", std::string(s.data(), s.size()));
+  s.resize(4);
+  EXPECT_EQ(4u, s.size());
+  EXPECT_EQ(std::string("abc\0", 4), std::string(s.data(), s.size()));
+
+  s.resize(100);
+  EXPECT_EQ(100u, s.size());
+  EXPECT_EQ("abc", std::string(s.data(), 3));
+  s.resize(2);
+  EXPECT_EQ("ab", std::string(s.data(), s.size()));
+}
+
 TEST(StringType, Properties) {
   ndt::type d = ndt::make_type<ndt::string_type>();
 
@@ -296,6 +318,51 @@ TEST(StringType, StringToInteger) {
   */
 }
 
+template <typename T>
+static T string_to(const char *str) {
+  T value;
+  string_to_number(reinterpret_cast<char *>(&value), ndt::id_of<T>::value, str, str + strlen(str), assign_error_default);
+  return value;
+}
+
+TEST(StringType, StringToInteger64) {
+  EXPECT_EQ(numeric_limits<int64_t>::min(), string_to<int64_t>("-9223372036854775808"));
+  EXPECT_EQ(numeric_limits<int64_t>::max(), string_to<int64_t>("9223372036854775807"));
+  EXPECT_EQ(1234567890123LL, string_to<int64_t>("1234567890123"));
+  EXPECT_THROW(string_to<int64_t>("-9223372036854775809"), exception);
+  EXPECT_THROW(string_to<int64_t>("9223372036854775808"), exception);
+
+  EXPECT_EQ(numeric_limits<uint64_t>::max(), string_to<uint64_t>("18446744073709551615"));
+  EXPECT_EQ(12345678901234567ULL, string_to<uint64_t>("12345678901234567"));
+  EXPECT_THROW(string_to<uint64_t>("18446744073709551616"), exception);
+  // Wraps around to a larger value than the prefix without its last digit
+  EXPECT_THROW(string_to<uint64_t>("30000000000000000000"), exception);
+  EXPECT_THROW(string_to<uint64_t>("123456789x"), exception);
+}
+
+TEST(StringType, StringToFloat) {
+  EXPECT_EQ(0.1, string_to<double>("0.1"));
+  EXPECT_EQ(-1.5e-7, string_to<double>("-1.5e-7"));
+  EXPECT_EQ(1.7976931348623157e308, string_to<double>("1.7976931348623157e308"));
+  EXPECT_EQ(2.2250738585072011e-308, string_to<double>("2.2250738585072011e-308"));
+  EXPECT_EQ(4.9406564584124654e-324, string_to<double>("4.9406564584124654e-324"));
+  EXPECT_EQ(9007199254740992.0, string_to<double>("9007199254740993"));
+  EXPECT_EQ(1.2345678901234568e29, string_to<double>("123456789012345678901234567890"));
+  // Exactly halfway between two doubles, which rounds to the even one
+  EXPECT_EQ(1.0, string_to<double>("1.00000000000000011102230246251565404236316680908203125"));
+  EXPECT_EQ(1.0000000000000002, string_to<double>("1.00000000000000011102230246251565404236316680908203126"));
+  EXPECT_EQ(numeric_limits<double>::infinity(), string_to<double>("1e400"));
+  EXPECT_EQ(0.0, string_to<double>("1e-400"));
+  EXPECT_EQ(8.0, string_to<double>("0x1p3"));
+  EXPECT_THROW(string_to<double>("1.5x"), exception);
+
+  EXPECT_EQ(0.1f, string_to<float>("0.1"));
+  EXPECT_EQ(3.4028235e38f, string_to<float>("3.4028235e38"));
+  EXPECT_EQ(1.4e-45f, string_to<float>("1.4e-45"));
+  // Rounding to double first would give the float below
+  EXPECT_EQ(1.00000012f, string_to<float>("1.000000059604644775390625000001"));
+}
+
 TEST(StringType, Comparisons) {
   nd::array a, b;
 
@@ -544,6 +611,54 @@ TEST(StringType, Contains) {
   EXPECT_ARRAY_EQ(c, nd::string_contains(a, b));
 }
 
+TEST(StringType, SearchVectorized) {
+  // A small alphabet gives many partial matches, and the lengths cover the vector tails
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> ch('a', 'c');
+  auto random_string = [&](size_t size) {
+    std::string s(size, 'a');
+    for (char &c : s) {
+      c = static_cast<char>(ch(gen));
+    }
+    return s;
+  };
+
+  simd::instruction_set saved_isa = simd::get_instruction_set();
+  for (int isa = simd::isa_none; isa <= simd::detect_instruction_set(); ++isa) {
+    simd::set_instruction_set(static_cast<simd::instruction_set>(isa));
+
+    for (int k = 0; k < 500; ++k) {
+      std::string haystack = random_string(k % 100);
+      std::string needle = random_string(2 + k % 5);
+
+      intptr_t count = 0;
+      for (size_t i = haystack.find(needle); i != std::string::npos; i = haystack.find(needle, i + needle.size())) {
+        ++count;
+      }
+      size_t first = haystack.find(needle);
+
+      dynd::string h(haystack.data(), haystack.size()), n(needle.data(), needle.size());
+      EXPECT_EQ(first == std::string::npos ? -1 : static_cast<intptr_t>(first), dynd::string_find(h, n));
+      EXPECT_EQ(count, dynd::string_count(h, n));
+      EXPECT_EQ(first != std::string::npos, dynd::string_contains(h, n));
+
+      std::string replaced;
+      for (size_t i = 0, j = haystack.find(needle);; j = haystack.find(needle, i)) {
+        replaced += haystack.substr(i, j - i);
+        if (j == std::string::npos) {
+          break;
+        }
+        replaced += "XYZ";
+        i = j + needle.size();
+      }
+      dynd::string dst;
+      dynd::string_replace(dst, h, n, dynd::string("XYZ"));
+      EXPECT_EQ(replaced, std::string(dst.data(), dst.size()));
+    }
+  }
+  simd::set_instruction_set(saved_isa);
+}
+
 template <class T>
 static bool ascii_T_compare(const char *x, const T *y, intptr_t count) {
   for (intptr_t i = 0; i < count; ++i) {